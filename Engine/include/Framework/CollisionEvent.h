@@ -3,11 +3,23 @@
 #include "Framework/Event.h"
 #include "Framework/Physics.h"
 
+/*! Queued by Physics during the simulation step, and dispatched after it. */
 class CollisionEvent : public Event
 {
 public:
 	eid_t e1;
 	eid_t e2;
+	/*! The collision objects of e1 and e2. Null for ended contacts, since a contact
+		also ends when one of the entities is deleted along with its body. */
+	const btCollisionObject* body1;
+	const btCollisionObject* body2;
+	/*! The collision flags of e1's and e2's bodies when the contact began, for both
+		kinds of event, so that a responder sees the same flags when a contact ends as
+		it did when it began. */
+	int flags1;
+	int flags2;
+	/*! Bullet may have destroyed this by the time the event is dispatched, so don't read
+		through it. Null for ended contacts. */
 	btPersistentManifold* collisionManifold;
 	CollisionResponseType type;
 };
\ No newline at end of file
@@ -1,40 +1,220 @@
 #pragma once
 
-#include <vector>
 #include <cinttypes>
+#include <cassert>
 
-/*! "mask size type" - type used when specifying the index of a bit in the mask.
-	Implicitly defines the maximum number of bits that the mask can contain. */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMPONENTBITMASK_SSE2
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/*! The maximum number of component types a World can register. Define this before
+	including any engine header (or in the build) to raise it; each multiple of 64
+	costs another 8 bytes per entity. */
+#ifndef MAX_COMPONENTS
+#define MAX_COMPONENTS 128
+#endif
+
+/*! "mask size type" - type used when specifying the index of a bit in the mask. */
 typedef uint32_t msize_t;
 
-/*! Arbitrary length bitmask. */
-class ComponentBitmask
+/*! Fixed length bitmask of N bits, stored inline so that it can be copied and
+	compared without touching the heap. */
+template <msize_t N>
+class BasicComponentBitmask
 {
 public:
-	ComponentBitmask();
+	static_assert(N > 0, "A bitmask needs at least one bit");
+
+	BasicComponentBitmask();
 
 	/*!
 	 * \brief Sets or unsets the given bit within the bitmask.
-	 * \param bit Bit index to set.
+	 * \param bit Bit index to set. Must be less than N.
 	 * \param set True to set, false to unset.
 	 */
 	void setBit(msize_t bit, bool set);
 
 	/*!
 	 * \brief Checks if a single bit is set.
-	 * \param bit The bit index to check. */
-	bool isBitSet(msize_t bit);
+	 * \param bit The bit index to check. Bits past the end of the mask are never set. */
+	bool isBitSet(msize_t bit) const;
 
 	/*!
 	 * \brief Checks if all the bits in other are set in this.
 	 */
-	bool hasComponents(const ComponentBitmask& other);
+	bool hasComponents(const BasicComponentBitmask& other) const;
+
+	/*!
+	 * \brief Checks if any bit is set in both this and other.
+	 */
+	bool intersects(const BasicComponentBitmask& other) const;
+
+	/*!
+	 * \brief Returns a mask with the bits which are set in either this or other.
+	 */
+	BasicComponentBitmask operator|(const BasicComponentBitmask& other) const;
+
+	/*!
+	 * \brief Calls func(bit) for each set bit, in increasing order. Only visits words
+	 * with bits set, so it is cheap for the handful of components an entity usually has.
+	 */
+	template <class Func>
+	void forEachSetBit(Func func) const;
+
+	bool operator==(const BasicComponentBitmask& other) const;
+	bool operator!=(const BasicComponentBitmask& other) const;
+
+	/*! The number of bits the mask can hold. */
+	static const msize_t size = N;
 private:
-	/*! "mask unit type" - size of a single "unit" in the vector. A unit is the type
+	/*! "mask unit type" - size of a single "unit" in the array. A unit is the type
 		we actually operate upon, rather than dealing bit-by-bit. */
-	typedef uint32_t munit_t;
+	typedef uint64_t munit_t;
+
+	static const msize_t unitBits = sizeof(munit_t) * 8;
+	static const msize_t unitCount = (N + unitBits - 1) / unitBits;
+
+	/*! Index of the lowest set bit of a non-zero unit. */
+	static msize_t lowestSetBit(munit_t unit);
+
+	/*! The actual bitmask we use. */
+	munit_t mask[unitCount];
+};
+
+/*! The bitmask used by World and System, sized by MAX_COMPONENTS. */
+typedef BasicComponentBitmask<MAX_COMPONENTS> ComponentBitmask;
+
+template <msize_t N>
+const msize_t BasicComponentBitmask<N>::size;
+
+template <msize_t N>
+BasicComponentBitmask<N>::BasicComponentBitmask()
+{
+	for (msize_t i = 0; i < unitCount; i++) {
+		mask[i] = 0;
+	}
+}
 
-	/*! The actual bitmask we use. If a unit doesn't exist, it is considered to be
-		set to all zeroes. */
-	std::vector<munit_t> mask;
-};
\ No newline at end of file
+template <msize_t N>
+inline void BasicComponentBitmask<N>::setBit(msize_t bit, bool set)
+{
+	assert(bit < N && "Component ID is past MAX_COMPONENTS");
+
+	munit_t& unit = mask[bit / unitBits];
+	munit_t setter = ((munit_t)1 << (bit % unitBits));
+	if (set) {
+		unit = unit | setter;
+	} else {
+		unit = unit & (~setter);
+	}
+}
+
+template <msize_t N>
+inline bool BasicComponentBitmask<N>::isBitSet(msize_t bit) const
+{
+	if (bit >= N) {
+		return false;
+	}
+
+	munit_t unit = mask[bit / unitBits];
+	return (unit & ((munit_t)1 << (bit % unitBits))) != 0;
+}
+
+template <msize_t N>
+inline bool BasicComponentBitmask<N>::hasComponents(const BasicComponentBitmask& other) const
+{
+	msize_t i = 0;
+
+#ifdef COMPONENTBITMASK_SSE2
+	// Two units at a time: find the bits set in other but not in this
+	__m128i missing = _mm_setzero_si128();
+	for (; i + 2 <= unitCount; i += 2) {
+		__m128i ours = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&this->mask[i]));
+		__m128i theirs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&other.mask[i]));
+		missing = _mm_or_si128(missing, _mm_andnot_si128(ours, theirs));
+	}
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) != 0xFFFF) {
+		return false;
+	}
+#endif
+
+	// No early out, so this stays a handful of branch-free AND/OR instructions
+	munit_t missingUnits = 0;
+	for (; i < unitCount; i++) {
+		missingUnits |= other.mask[i] & ~this->mask[i];
+	}
+	return missingUnits == 0;
+}
+
+template <msize_t N>
+inline bool BasicComponentBitmask<N>::intersects(const BasicComponentBitmask& other) const
+{
+	munit_t common = 0;
+	for (msize_t i = 0; i < unitCount; i++) {
+		common |= this->mask[i] & other.mask[i];
+	}
+	return common != 0;
+}
+
+template <msize_t N>
+inline BasicComponentBitmask<N> BasicComponentBitmask<N>::operator|(const BasicComponentBitmask& other) const
+{
+	BasicComponentBitmask result;
+	for (msize_t i = 0; i < unitCount; i++) {
+		result.mask[i] = this->mask[i] | other.mask[i];
+	}
+	return result;
+}
+
+template <msize_t N>
+template <class Func>
+inline void BasicComponentBitmask<N>::forEachSetBit(Func func) const
+{
+	for (msize_t i = 0; i < unitCount; i++) {
+		munit_t unit = mask[i];
+		while (unit != 0) {
+			func(i * unitBits + lowestSetBit(unit));
+			unit &= unit - 1;
+		}
+	}
+}
+
+template <msize_t N>
+inline msize_t BasicComponentBitmask<N>::lowestSetBit(munit_t unit)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, unit);
+	return (msize_t)index;
+#elif defined(__GNUC__)
+	return (msize_t)__builtin_ctzll(unit);
+#else
+	msize_t index = 0;
+	while ((unit & 1) == 0) {
+		unit >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+template <msize_t N>
+inline bool BasicComponentBitmask<N>::operator==(const BasicComponentBitmask& other) const
+{
+	munit_t different = 0;
+	for (msize_t i = 0; i < unitCount; i++) {
+		different |= this->mask[i] ^ other.mask[i];
+	}
+	return different == 0;
+}
+
+template <msize_t N>
+inline bool BasicComponentBitmask<N>::operator!=(const BasicComponentBitmask& other) const
+{
+	return !(*this == other);
+}
\ No newline at end of file
@@ -3,23 +3,33 @@
 #include "Framework/Component.h"
 #include "Framework/World.h"
 
-#include <typeinfo>
-
-struct ComponentConstructorInfo
-{
-	ComponentConstructorInfo() : ComponentConstructorInfo(nullptr, 0) { }
-	ComponentConstructorInfo(Component* component, size_t typeidHash) :
-		component(component), typeidHash(typeidHash) { }
-	Component* component;
-	size_t typeidHash;
-};
+class PrefabTemplate;
 
 class ComponentConstructor
 {
 public:
 	ComponentConstructor() { }
 	virtual ~ComponentConstructor() = default;
-	virtual ComponentConstructorInfo construct(World& world, eid_t parent, void* userinfo) const = 0;
+
+	/*!
+	 * \brief Adds this constructor's component to an entity being built from a prefab.
+	 * Use World::emplaceComponent, so the component is built directly in its pool.
+	 * \param entity The entity being constructed. Its queries are updated once every
+	 *  constructor has run, just before finish is called.
+	 * \param parent The entity's parent, or World::NullEntity.
+	 * \param userinfo The userinfo passed to World::constructPrefab.
+	 */
+	virtual void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const = 0;
+
+	/*!
+	 * \brief Adds this constructor's component to a prefab's template, as a prototype
+	 * which is copied into each new entity. Only possible if the component doesn't depend
+	 * on the world, the parent or the userinfo.
+	 * \return False if the constructor has to run for each entity instead, which is
+	 *  what it does unless overridden.
+	 */
+	virtual bool compile(PrefabTemplate& prefabTemplate) const { return false; }
+
 	virtual void finish(World& world, eid_t entity) { }
 private:
 };
\ No newline at end of file
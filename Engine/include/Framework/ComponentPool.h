@@ -0,0 +1,365 @@
+#pragma once
+
+#include "Framework/Component.h"
+#include "Framework/EntitySet.h"
+#include "Framework/Snapshot.h"
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <typeinfo>
+
+/*! Type-erased half of a ComponentPool. Holds the sparse set which maps entities to
+	slots in the dense component array, so World can check membership and remove
+	components without knowing the component type. */
+class BaseComponentPool
+{
+public:
+	BaseComponentPool() { }
+	virtual ~BaseComponentPool() = default;
+
+	BaseComponentPool(const BaseComponentPool&) = delete;
+	BaseComponentPool& operator=(const BaseComponentPool&) = delete;
+
+	/*!
+	 * \brief Checks if an entity has a component in this pool.
+	 */
+	bool has(eid_t entity) const;
+
+	/*!
+	 * \brief Destroys the component attached to an entity, if there is one.
+	 * The last component in the pool is moved into the vacated slot, so this
+	 * invalidates pointers to that component.
+	 */
+	virtual void remove(eid_t entity) = 0;
+
+	/*!
+	 * \brief Destroys the components attached to each of the entities. Equivalent to
+	 * calling remove for each, but with one virtual call for the whole batch.
+	 */
+	virtual void removeBatch(const std::vector<eid_t>& batch) = 0;
+
+	/*!
+	 * \brief Destroys every component in the pool.
+	 */
+	virtual void clear() = 0;
+
+	/*!
+	 * \brief Move-constructs a component from one in another pool of the same type.
+	 * The source component is left in place, moved-from.
+	 * \param entity The entity to attach the component to. Must not already have one.
+	 * \param source The pool to move from. Must hold the same component type.
+	 * \param sourceEntity The entity whose component is moved in source.
+	 */
+	virtual void emplaceFrom(eid_t entity, BaseComponentPool& source, eid_t sourceEntity) = 0;
+
+	/*!
+	 * \brief Allocates room for at least count components up front.
+	 */
+	virtual void reserve(size_t count) = 0;
+
+	/*!
+	 * \brief Checks if the pool's component type has snapshot hooks; see IsSnapshotSerializable.
+	 */
+	virtual bool isSerializable() const = 0;
+
+	/*!
+	 * \brief Returns a name for the component type which is the same every time the
+	 * program runs, used to match up pools when restoring a snapshot.
+	 */
+	virtual const char* getTypeName() const = 0;
+
+	/*!
+	 * \brief Writes every component in the pool, in dense order, with its serialize hook.
+	 * Writes nothing if the type isn't serializable.
+	 */
+	virtual void serialize(SnapshotWriter& writer) const = 0;
+
+	/*!
+	 * \brief Default-constructs a component for each of the owners and reads it back with
+	 * its deserialize hook. The pool should be empty beforehand.
+	 * \param tick The change tick to stamp the components with.
+	 * \return False if the type isn't serializable or the reader ran out of data.
+	 */
+	virtual bool deserialize(SnapshotReader& reader, const eid_t* owners, size_t count, uint32_t tick) = 0;
+
+	/*!
+	 * \brief Returns the number of components in the pool.
+	 */
+	size_t size() const;
+
+	/*!
+	 * \brief Returns the entities which have a component in this pool. The entity at
+	 * index i owns the component at index i of the dense component array.
+	 */
+	const std::vector<eid_t>& getEntities() const;
+
+	/*!
+	 * \brief Returns the world change tick at which an entity's component was last
+	 * added or marked as changed, or 0 if the entity has no component in this pool.
+	 */
+	uint32_t getChangeTick(eid_t entity) const;
+
+	/*!
+	 * \brief Sets the change tick of an entity's component. Does nothing if the entity
+	 * has no component in this pool.
+	 */
+	void setChangeTick(eid_t entity, uint32_t tick);
+protected:
+	/*! Entity which owns each component, in the same order as the components. */
+	EntitySet entities;
+
+	/*! The change tick of each component, in the same order as the components. */
+	std::vector<uint32_t> changeTicks;
+};
+
+/*! Stores every component of type T by value. Components are kept densely packed
+	in fixed-size pages, so adding components never moves existing ones; only
+	removing a component moves the last component into its slot. */
+template <class T>
+class ComponentPool : public BaseComponentPool
+{
+public:
+	ComponentPool() { }
+	virtual ~ComponentPool();
+
+	/*!
+	 * \brief Gets the component attached to an entity.
+	 * \return The component, or nullptr if the entity doesn't have one.
+	 */
+	T* get(eid_t entity);
+
+	/*!
+	 * \brief Gets the component at an index of the dense array. Pair with getEntities().
+	 */
+	T& at(size_t index);
+
+	/*!
+	 * \brief Constructs a component in place and attaches it to an entity.
+	 * \param entity The entity to attach the component to. Must not already have one.
+	 * \return The newly constructed component.
+	 */
+	template <class... Args>
+	T* emplace(eid_t entity, Args&&... args);
+
+	virtual void remove(eid_t entity);
+	virtual void removeBatch(const std::vector<eid_t>& batch);
+	virtual void clear();
+	virtual void emplaceFrom(eid_t entity, BaseComponentPool& source, eid_t sourceEntity);
+	virtual void reserve(size_t count);
+	virtual bool isSerializable() const;
+	virtual const char* getTypeName() const;
+	virtual void serialize(SnapshotWriter& writer) const;
+	virtual bool deserialize(SnapshotReader& reader, const eid_t* owners, size_t count, uint32_t tick);
+
+	/*! Used by World to create a pool when it only knows the type at the call site. */
+	static std::unique_ptr<BaseComponentPool> create();
+private:
+	typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+	/*! Roughly 16KB worth of components per page, and at least one. */
+	static const size_t pageSize = (sizeof(T) >= 16384 ? 1 : 16384 / sizeof(T));
+
+	T* slot(size_t index);
+	const T* slot(size_t index) const;
+
+	typedef std::integral_constant<bool, IsSnapshotSerializable<T>::value> Serializable;
+	void serialize(SnapshotWriter& writer, std::true_type) const;
+	void serialize(SnapshotWriter& writer, std::false_type) const { }
+	bool deserialize(SnapshotReader& reader, const eid_t* owners, size_t count, uint32_t tick, std::true_type);
+	bool deserialize(SnapshotReader& reader, const eid_t* owners, size_t count, uint32_t tick, std::false_type) { return false; }
+
+	std::vector<std::unique_ptr<Storage[]>> pages;
+};
+
+inline bool BaseComponentPool::has(eid_t entity) const
+{
+	return entities.has(entity);
+}
+
+inline size_t BaseComponentPool::size() const
+{
+	return entities.size();
+}
+
+inline const std::vector<eid_t>& BaseComponentPool::getEntities() const
+{
+	return entities.getEntities();
+}
+
+inline uint32_t BaseComponentPool::getChangeTick(eid_t entity) const
+{
+	uint32_t index = entities.indexOf(entity);
+	return (index == EntitySet::invalidIndex ? 0 : changeTicks[index]);
+}
+
+inline void BaseComponentPool::setChangeTick(eid_t entity, uint32_t tick)
+{
+	uint32_t index = entities.indexOf(entity);
+	if (index != EntitySet::invalidIndex) {
+		changeTicks[index] = tick;
+	}
+}
+
+template <class T>
+ComponentPool<T>::~ComponentPool()
+{
+	clear();
+}
+
+template <class T>
+std::unique_ptr<BaseComponentPool> ComponentPool<T>::create()
+{
+	return std::unique_ptr<BaseComponentPool>(new ComponentPool<T>());
+}
+
+template <class T>
+T* ComponentPool<T>::slot(size_t index)
+{
+	return reinterpret_cast<T*>(&pages[index / pageSize][index % pageSize]);
+}
+
+template <class T>
+const T* ComponentPool<T>::slot(size_t index) const
+{
+	return reinterpret_cast<const T*>(&pages[index / pageSize][index % pageSize]);
+}
+
+template <class T>
+T* ComponentPool<T>::get(eid_t entity)
+{
+	uint32_t index = entities.indexOf(entity);
+	if (index == EntitySet::invalidIndex) {
+		return nullptr;
+	}
+	return slot(index);
+}
+
+template <class T>
+T& ComponentPool<T>::at(size_t index)
+{
+	assert(index < entities.size());
+	return *slot(index);
+}
+
+template <class T>
+template <class... Args>
+T* ComponentPool<T>::emplace(eid_t entity, Args&&... args)
+{
+	static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned components are not supported");
+	assert(!has(entity));
+
+	size_t index = entities.size();
+	if (index / pageSize >= pages.size()) {
+		pages.emplace_back(new Storage[pageSize]);
+	}
+
+	T* component = new (slot(index)) T(std::forward<Args>(args)...);
+	entities.insert(entity);
+	changeTicks.push_back(0);
+	return component;
+}
+
+template <class T>
+void ComponentPool<T>::emplaceFrom(eid_t entity, BaseComponentPool& source, eid_t sourceEntity)
+{
+	T* component = static_cast<ComponentPool<T>&>(source).get(sourceEntity);
+	assert(component != nullptr);
+	emplace(entity, std::move(*component));
+}
+
+template <class T>
+void ComponentPool<T>::reserve(size_t count)
+{
+	while (pages.size() * pageSize < count) {
+		pages.emplace_back(new Storage[pageSize]);
+	}
+	entities.reserve(count);
+	changeTicks.reserve(count);
+}
+
+template <class T>
+void ComponentPool<T>::remove(eid_t entity)
+{
+	uint32_t index = entities.indexOf(entity);
+	if (index == EntitySet::invalidIndex) {
+		return;
+	}
+
+	// Mirror the swap-and-pop that EntitySet::erase does on the entity array
+	size_t last = entities.size() - 1;
+	slot(index)->~T();
+	if (index != last) {
+		new (slot(index)) T(std::move(*slot(last)));
+		slot(last)->~T();
+		changeTicks[index] = changeTicks[last];
+	}
+	changeTicks.pop_back();
+
+	entities.erase(entity);
+}
+
+template <class T>
+void ComponentPool<T>::removeBatch(const std::vector<eid_t>& batch)
+{
+	for (eid_t entity : batch) {
+		ComponentPool<T>::remove(entity);
+	}
+}
+
+template <class T>
+void ComponentPool<T>::clear()
+{
+	for (size_t i = 0; i < entities.size(); i++) {
+		slot(i)->~T();
+	}
+	entities.clear();
+	changeTicks.clear();
+}
+
+template <class T>
+bool ComponentPool<T>::isSerializable() const
+{
+	return Serializable::value;
+}
+
+template <class T>
+const char* ComponentPool<T>::getTypeName() const
+{
+	return typeid(T).name();
+}
+
+template <class T>
+void ComponentPool<T>::serialize(SnapshotWriter& writer) const
+{
+	serialize(writer, Serializable());
+}
+
+template <class T>
+void ComponentPool<T>::serialize(SnapshotWriter& writer, std::true_type) const
+{
+	for (size_t i = 0; i < entities.size(); i++) {
+		slot(i)->serialize(writer);
+	}
+}
+
+template <class T>
+bool ComponentPool<T>::deserialize(SnapshotReader& reader, const eid_t* owners, size_t count, uint32_t tick)
+{
+	return deserialize(reader, owners, count, tick, Serializable());
+}
+
+template <class T>
+bool ComponentPool<T>::deserialize(SnapshotReader& reader, const eid_t* owners, size_t count, uint32_t tick, std::true_type)
+{
+	reserve(entities.size() + count);
+	for (size_t i = 0; i < count && !reader.hasFailed(); i++) {
+		emplace(owners[i])->deserialize(reader);
+		changeTicks.back() = tick;
+	}
+	return !reader.hasFailed();
+}
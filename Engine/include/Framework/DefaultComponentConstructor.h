@@ -1,13 +1,15 @@
 #pragma once
 
 #include "Framework/ComponentConstructor.h"
+#include "Framework/PrefabTemplate.h"
 
 template <class ComponentClass>
 class DefaultComponentConstructor : public ComponentConstructor
 {
 public:
 	DefaultComponentConstructor(const typename ComponentClass::Data& data);
-	virtual ComponentConstructorInfo construct(World& world, eid_t parent, void* userinfo) const;
+	virtual void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const;
+	virtual bool compile(PrefabTemplate& prefabTemplate) const;
 protected:
 	typename ComponentClass::Data data;
 };
@@ -18,10 +20,14 @@ DefaultComponentConstructor<ComponentClass>::DefaultComponentConstructor(const t
 { }
 
 template <class ComponentClass>
-ComponentConstructorInfo DefaultComponentConstructor<ComponentClass>::construct(World& world, eid_t parent, void* userinfo) const
+void DefaultComponentConstructor<ComponentClass>::construct(World& world, eid_t entity, eid_t parent, void* userinfo) const
 {
-	ComponentClass* component = new ComponentClass();
-	component->data = this->data;
+	world.emplaceComponent<ComponentClass>(entity)->data = this->data;
+}
 
-	return ComponentConstructorInfo(component, typeid(ComponentClass).hash_code());
+template <class ComponentClass>
+bool DefaultComponentConstructor<ComponentClass>::compile(PrefabTemplate& prefabTemplate) const
+{
+	prefabTemplate.addComponent<ComponentClass>()->data = this->data;
+	return true;
 }
\ No newline at end of file
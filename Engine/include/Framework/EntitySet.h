@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cinttypes>
+#include <cstddef>
+
+/*! Entity ID. The low bits index a slot in World's entity array, and the high bits
+	count how many times that slot has been reused, so that IDs of deleted entities
+	never refer to whatever entity takes their slot. */
+typedef uint32_t eid_t;
+typedef uint32_t cid_t;
+
+/*! Number of bits of an eid_t used for the slot index. */
+const uint32_t entityIndexBits = 20;
+
+/*! Number of bits of an eid_t used for the generation. */
+const uint32_t entityGenerationBits = 32 - entityIndexBits;
+
+/*! Slot indices are below this. The last index is never used, so no ID can equal World::NullEntity. */
+const uint32_t maxEntityIndex = (1u << entityIndexBits) - 1;
+
+/*! Generations are at most this. */
+const uint32_t maxEntityGeneration = (1u << entityGenerationBits) - 1;
+
+inline uint32_t entityIndex(eid_t entity)
+{
+	return entity & ((1u << entityIndexBits) - 1);
+}
+
+inline uint32_t entityGeneration(eid_t entity)
+{
+	return entity >> entityIndexBits;
+}
+
+inline eid_t makeEntityId(uint32_t index, uint32_t generation)
+{
+	return (generation << entityIndexBits) | index;
+}
+
+/*! Sparse set of entities. Membership checks, insertion and removal are all
+	constant time, and the members are kept densely packed for iteration.
+	The sparse array is indexed by entity slot, so an entity from an older
+	generation of the same slot is never considered a member. */
+class EntitySet
+{
+public:
+	EntitySet() { }
+
+	EntitySet(const EntitySet&) = delete;
+	EntitySet& operator=(const EntitySet&) = delete;
+
+	/*!
+	 * \brief Checks if an entity is in the set.
+	 */
+	bool has(eid_t entity) const;
+
+	/*!
+	 * \brief Returns the index of an entity in the dense array, or invalidIndex.
+	 */
+	uint32_t indexOf(eid_t entity) const;
+
+	/*!
+	 * \brief Adds an entity to the end of the dense array.
+	 * \param entity The entity to add. Must not already be in the set.
+	 * \return The index of the entity in the dense array.
+	 */
+	uint32_t insert(eid_t entity);
+
+	/*!
+	 * \brief Removes an entity, if it is in the set. The last entity in the dense
+	 * array is moved into the vacated index.
+	 */
+	void erase(eid_t entity);
+
+	/*!
+	 * \brief Removes every entity.
+	 */
+	void clear();
+
+	/*!
+	 * \brief Makes room in the dense array for at least count entities.
+	 */
+	void reserve(size_t count);
+
+	/*!
+	 * \brief Returns the number of entities in the set.
+	 */
+	size_t size() const;
+
+	/*!
+	 * \brief Returns the entities in the set, densely packed.
+	 */
+	const std::vector<eid_t>& getEntities() const;
+
+	/*! Returned by indexOf for entities which aren't in the set. */
+	static const uint32_t invalidIndex = UINT32_MAX;
+private:
+	/*! Number of entries in a single page of the sparse array. */
+	static const uint32_t sparsePageSize = 4096;
+
+	/*! Returns the dense index stored for an entity's slot, regardless of generation. */
+	uint32_t slotIndex(eid_t entity) const;
+
+	/*! Sets the dense index of an entity, allocating sparse pages as needed. */
+	void setIndex(eid_t entity, uint32_t index);
+
+	std::vector<eid_t> dense;
+
+	/*! Maps entity IDs to dense indices. Paged so that a few large entity IDs don't
+		force us to allocate an index for every entity ID below them. */
+	std::vector<std::unique_ptr<uint32_t[]>> sparse;
+};
+
+inline bool EntitySet::has(eid_t entity) const
+{
+	return indexOf(entity) != invalidIndex;
+}
+
+inline uint32_t EntitySet::indexOf(eid_t entity) const
+{
+	uint32_t index = slotIndex(entity);
+	if (index == invalidIndex || dense[index] != entity) {
+		return invalidIndex;
+	}
+	return index;
+}
+
+inline uint32_t EntitySet::slotIndex(eid_t entity) const
+{
+	uint32_t slot = entityIndex(entity);
+	uint32_t page = slot / sparsePageSize;
+	if (page >= sparse.size() || !sparse[page]) {
+		return invalidIndex;
+	}
+	return sparse[page][slot % sparsePageSize];
+}
+
+inline size_t EntitySet::size() const
+{
+	return dense.size();
+}
+
+inline const std::vector<eid_t>& EntitySet::getEntities() const
+{
+	return dense;
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/*! A fixed-size ring buffer which any number of threads can post to at once, without
+	locking, and one thread drains. Each slot carries a sequence number saying whether
+	it is free for the lap of the ring a producer is on, or filled for the consumer's,
+	so producers only contend on the one counter they use to claim a slot.
+
+	Memory is allocated once, up front. Posting to a full channel fails rather than
+	waiting, since the consumer may be busy waiting on the producer, and is counted in
+	the stats so the capacity can be tuned. */
+template <class T>
+class EventChannel
+{
+public:
+	struct Stats
+	{
+		/*! Events taken out by the consumer. */
+		uint64_t drained;
+		/*! Posts which failed because the channel was full. */
+		uint64_t dropped;
+		/*! The most events found waiting by a single drain. */
+		size_t peak;
+	};
+
+	/*!
+	 * \brief Allocates the ring buffer.
+	 * \param capacity The number of events the channel holds, rounded up to a power of two.
+	 */
+	EventChannel(size_t capacity);
+
+	EventChannel(const EventChannel&) = delete;
+	EventChannel& operator=(const EventChannel&) = delete;
+
+	/*!
+	 * \brief Adds an event to the channel. Safe to call from any thread.
+	 * \return False, without adding it, if the channel is full.
+	 */
+	bool post(const T& event);
+
+	/*!
+	 * \brief Calls consumer(T&&) on each event in the channel, in the order their slots
+	 * were claimed, and empties it. Only one thread may drain a channel at a time. Events
+	 * posted while this runs may or may not be included.
+	 * \return The number of events drained.
+	 */
+	template <class Consumer>
+	size_t drain(Consumer&& consumer);
+
+	size_t capacity() const;
+
+	/*!
+	 * \brief Returns the stats. Should be called on the draining thread.
+	 */
+	Stats getStats() const;
+
+	void resetStats();
+private:
+	struct Slot
+	{
+		/*! The position a producer may fill this slot at, or one past the position the
+			consumer may empty it at, depending on which lap of the ring it is on. */
+		std::atomic<size_t> sequence;
+		T event;
+	};
+
+	/*! Keeps the producers' counter and the consumer's state from sharing a cache line. */
+	static const size_t cacheLineSize = 64;
+
+	std::unique_ptr<Slot[]> slots;
+	size_t mask;
+	char padding0[cacheLineSize];
+
+	/*! The next position a producer will claim. */
+	std::atomic<size_t> enqueuePosition;
+	std::atomic<uint64_t> dropped;
+	char padding1[cacheLineSize];
+
+	/*! The next position the consumer will empty. Only the consumer touches this. */
+	size_t dequeuePosition;
+	uint64_t drained;
+	size_t peak;
+};
+
+template <class T>
+EventChannel<T>::EventChannel(size_t capacity)
+	: enqueuePosition(0), dropped(0), dequeuePosition(0), drained(0), peak(0)
+{
+	size_t size = 2;
+	while (size < capacity) {
+		size *= 2;
+	}
+
+	slots.reset(new Slot[size]);
+	mask = size - 1;
+	for (size_t i = 0; i < size; i++) {
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template <class T>
+bool EventChannel<T>::post(const T& event)
+{
+	Slot* slot;
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	while (true) {
+		slot = &slots[position & mask];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+		if (difference == 0) {
+			// The slot is free on this lap; try to claim it
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (difference < 0) {
+			// The slot still holds an event from the last lap, which the consumer hasn't taken
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		} else {
+			// Another producer claimed this position first
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->event = event;
+	slot->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+template <class T>
+template <class Consumer>
+size_t EventChannel<T>::drain(Consumer&& consumer)
+{
+	// Stop after one lap, so that producers posting as fast as this drains can't keep it here
+	size_t count = 0;
+	while (count <= mask) {
+		Slot& slot = slots[dequeuePosition & mask];
+		if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+			// Empty, or claimed by a producer which hasn't finished writing it
+			break;
+		}
+
+		consumer(std::move(slot.event));
+		slot.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+		dequeuePosition++;
+		count++;
+	}
+
+	drained += count;
+	if (count > peak) {
+		peak = count;
+	}
+	return count;
+}
+
+template <class T>
+size_t EventChannel<T>::capacity() const
+{
+	return mask + 1;
+}
+
+template <class T>
+typename EventChannel<T>::Stats EventChannel<T>::getStats() const
+{
+	Stats stats;
+	stats.drained = drained;
+	stats.dropped = dropped.load(std::memory_order_relaxed);
+	stats.peak = peak;
+	return stats;
+}
+
+template <class T>
+void EventChannel<T>::resetStats()
+{
+	drained = 0;
+	dropped.store(0, std::memory_order_relaxed);
+	peak = 0;
+}
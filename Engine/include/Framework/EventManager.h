@@ -1,73 +1,466 @@
 #pragma once
 
-#include <unordered_map>
+#include <cassert>
+#include <vector>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include "Event.h"
+#include "Framework/EventChannel.h"
+#include "Framework/TypeIndex.h"
+#include "Framework/Span.h"
+#include "Framework/InlineFunction.h"
 
 typedef uint32_t eventid_t;
 
+class EventManager;
+
+/*! Keeps a listener registered with an EventManager for as long as it lives. Destroying or
+	resetting it unregisters the listener, so anything listening for events should hold on
+	to its subscriptions as members. It must not outlive the manager. */
+class EventSubscription
+{
+public:
+	EventSubscription() : eventManager(nullptr), eventid(0), listenerId(0), batch(false) { }
+	EventSubscription(EventSubscription&& other);
+	EventSubscription& operator=(EventSubscription&& other);
+	~EventSubscription();
+
+	EventSubscription(const EventSubscription&) = delete;
+	EventSubscription& operator=(const EventSubscription&) = delete;
+
+	/*!
+	 * \brief Unregisters the listener now, if it still is registered.
+	 */
+	void reset();
+
+	bool isActive() const;
+private:
+	friend class EventManager;
+	EventSubscription(EventManager* eventManager, eventid_t eventid, uint32_t listenerId, bool batch)
+		: eventManager(eventManager), eventid(eventid), listenerId(listenerId), batch(batch) { }
+
+	EventManager* eventManager;
+	eventid_t eventid;
+	uint32_t listenerId;
+	bool batch;
+};
+
+/*! Delivers events to the listeners registered for their type. sendEvent calls every
+	listener straight away. queueEvent instead appends the event to a buffer kept for its
+	type, and dispatchEvents later hands each type's buffer to its listeners in one go,
+	at a point in the frame where it is safe to react to them. Listeners are always called
+	on the thread which created the manager.
+
+	Each type's listeners are kept in one array of InlineFunctions, so delivering an event
+	costs one indirect call per listener. Listeners may subscribe and unsubscribe while
+	events are being delivered; ones added then first hear about the next event.
+
+	Threads which post events often, and mustn't block on each other, can use a channel
+	instead of queueEvent. openChannel gives a type a bounded, lock-free EventChannel, which
+	post adds to and dispatchEvents empties into the type's queue. */
 class EventManager
 {
 public:
-	EventManager(const World& world) : world(world), nextEventId(0) { }
+	EventManager(const World& world) : world(world), ownerThread(std::this_thread::get_id()) { }
 
 	template <class T>
 	void sendEvent(const T& event);
 
+	/*!
+	 * \brief Queues an event to be delivered by the next dispatchEvents. Safe to call from
+	 * several threads at once, as long as no listeners are being registered. Events nobody
+	 * has registered for are dropped. Each thread's events are delivered in the order it
+	 * queued them, the creating thread's first.
+	 */
+	template <class T>
+	void queueEvent(const T& event);
+
+	/*!
+	 * \brief Delivers every queued event, type by type. Must be called on the thread which
+	 * created the manager, while no other thread is queueing. Listeners registered with
+	 * registerForEvents get each type's events as one span; those registered with
+	 * registerForEvent get them one at a time. Events queued by the listeners are
+	 * delivered too, before this returns. Other threads may keep posting to channels
+	 * meanwhile; whatever they post too late is left for the next dispatch.
+	 */
+	void dispatchEvents();
+
+	/*!
+	 * \brief Gives events of type T a channel which post can add to from any thread. Must be
+	 * called on the thread which created the manager, before any thread posts. Opening a
+	 * type's channel again replaces it, dropping anything it held.
+	 * \param capacity The number of events the channel holds between dispatches, rounded up
+	 *		to a power of two.
+	 */
 	template <class T>
-	uint32_t registerForEvent(std::function<void(const T&)> eventListener);
+	void openChannel(size_t capacity);
+
+	/*!
+	 * \brief Adds an event to its type's channel, to be delivered by the next dispatchEvents
+	 * like a queued event. Safe to call from any thread, and never blocks or allocates.
+	 * Events posted by one thread are delivered in the order it posted them.
+	 * \return False, dropping the event, if the channel is full or none was opened for T.
+	 */
+	template <class T>
+	bool post(const T& event);
+
+	/*!
+	 * \brief Returns the stats of T's channel, which must be open. Should be called on the
+	 * thread which created the manager.
+	 */
+	template <class T>
+	typename EventChannel<T>::Stats getChannelStats() const;
+
+	/*!
+	 * \brief Registers a listener, callable as void(const T&), for every event of type T.
+	 * \return The subscription which keeps the listener registered. Discarding it
+	 *		unregisters the listener straight away.
+	 */
+	template <class T, class Listener>
+	EventSubscription registerForEvent(Listener&& eventListener);
+
+	/*!
+	 * \brief Registers a listener, callable as void(Span<const T>), for queued events of a
+	 * type, which receives all of them at once. The span is only valid during the call.
+	 * Events sent with sendEvent don't reach it.
+	 * \return The subscription which keeps the listener registered.
+	 */
+	template <class T, class Listener>
+	EventSubscription registerForEvents(Listener&& eventListener);
 private:
+	friend class EventSubscription;
+
+	/*! Listeners in a flat array, with stable IDs for removing them in constant time. */
+	template <class Function>
+	class ListenerList
+	{
+	public:
+		ListenerList() : dispatching(0), hasRemovals(false) { }
+
+		uint32_t add(Function&& function);
+		void remove(uint32_t id);
+
+		template <class Arg>
+		void call(const Arg& argument);
+	private:
+		/*! Drops listeners removed during dispatch, and moves in those added during it. */
+		void settle();
+		void removeAt(size_t index);
+
+		std::vector<Function> functions;
+		/*! The ID of each function, indexed like functions, or UINT32_MAX if it was removed
+			during dispatch and is waiting to be dropped. */
+		std::vector<uint32_t> ids;
+		/*! Where each ID's function is in functions, indexed by ID. */
+		std::vector<uint32_t> indices;
+		std::vector<uint32_t> freeIds;
+
+		/*! Listeners added during dispatch, kept apart so that the running listener doesn't move. */
+		std::vector<Function> added;
+		std::vector<uint32_t> addedIds;
+
+		unsigned dispatching;
+		/*! Set when a listener was removed during dispatch. */
+		bool hasRemovals;
+	};
+
+	/*! Everything kept for one type of event. */
+	class BaseEventType
+	{
+	public:
+		virtual ~BaseEventType() { }
+
+		/*!
+		 * \brief Delivers the events queued so far.
+		 * \return False if there were none.
+		 */
+		virtual bool dispatchQueued() = 0;
+
+		/*!
+		 * \brief Moves the events posted to the channel so far, if there is one, into the queue.
+		 */
+		virtual void drainChannel() = 0;
+
+		virtual void removeListener(uint32_t listenerId, bool batch) = 0;
+	};
+
 	template <class T>
-	eventid_t registerEventType();
+	class EventType : public BaseEventType
+	{
+	public:
+		void push(const T& event, bool onOwnerThread);
+		virtual bool dispatchQueued();
+		virtual void drainChannel();
+		virtual void removeListener(uint32_t listenerId, bool batch);
+
+		ListenerList<InlineFunction<void(const T&)>> listeners;
+		ListenerList<InlineFunction<void(Span<const T>)>> batchListeners;
+
+		/*! Set by openChannel. Drained once at the start of each dispatch, so that threads
+			posting as fast as it is drained can't keep the dispatch going forever. */
+		std::unique_ptr<EventChannel<T>> channel;
+	private:
+		/*! Events from the creating thread, which is the only one to touch this. Keeping
+			them apart means the usual case doesn't pay for a lock. */
+		std::vector<T> pending;
 
-	typedef std::function<void(const Event* event)> EventCallbackInternal;
-	typedef std::vector<EventCallbackInternal> EventCallbackList;
+		std::mutex sharedMutex;
+		/*! Events from other threads. */
+		std::vector<T> sharedPending;
 
-	std::unordered_map<size_t, eventid_t> eventTypeMap;
-	std::vector<EventCallbackList> eventListeners;
-	eventid_t nextEventId;
+		/*! The events being delivered, swapped with pending so that listeners can queue more
+			meanwhile. They all keep their memory, so queueing stops allocating once they've grown. */
+		std::vector<T> dispatching;
+	};
+
+	template <class T>
+	EventType<T>& getEventType();
+
+	template <class T>
+	EventType<T>* findEventType() const;
+
+	void unsubscribe(eventid_t eventid, uint32_t listenerId, bool batch);
+
+	/*! Indexed by TypeIndex<Event>. Event types nobody has registered for may be missing. */
+	std::vector<std::unique_ptr<BaseEventType>> eventTypes;
 	const World& world;
+	std::thread::id ownerThread;
 };
 
 template <class T>
 void EventManager::sendEvent(const T& event)
 {
-	auto iter = this->eventTypeMap.find(typeid(T).hash_code());
-	if (iter == this->eventTypeMap.end()) {
+	eventid_t eventid = TypeIndex<Event>::get<T>();
+	if (eventid >= eventTypes.size() || !eventTypes[eventid]) {
+		return;
+	}
+
+	static_cast<EventType<T>&>(*eventTypes[eventid]).listeners.call(event);
+}
+
+template <class T>
+void EventManager::queueEvent(const T& event)
+{
+	eventid_t eventid = TypeIndex<Event>::get<T>();
+	if (eventid >= eventTypes.size() || !eventTypes[eventid]) {
 		return;
 	}
 
-	EventCallbackList& list = eventListeners[iter->second];
-	for (EventCallbackInternal& callback : list) {
-		callback(&event);
+	static_cast<EventType<T>&>(*eventTypes[eventid]).push(event, std::this_thread::get_id() == ownerThread);
+}
+
+template <class T>
+void EventManager::openChannel(size_t capacity)
+{
+	getEventType<T>().channel.reset(new EventChannel<T>(capacity));
+}
+
+template <class T>
+bool EventManager::post(const T& event)
+{
+	EventType<T>* eventType = findEventType<T>();
+	if (eventType == nullptr || !eventType->channel) {
+		return false;
 	}
+
+	return eventType->channel->post(event);
 }
 
 template <class T>
-uint32_t EventManager::registerForEvent(std::function<void(const T&)> eventListener)
+typename EventChannel<T>::Stats EventManager::getChannelStats() const
 {
-	eventid_t eventid;
-	auto iter = this->eventTypeMap.find(typeid(T).hash_code());
-	if (iter == this->eventTypeMap.end()) {
-		eventid = this->registerEventType<T>();
+	EventType<T>* eventType = findEventType<T>();
+	assert(eventType != nullptr && eventType->channel);
+	return eventType->channel->getStats();
+}
+
+template <class T, class Listener>
+EventSubscription EventManager::registerForEvent(Listener&& eventListener)
+{
+	EventType<T>& eventType = getEventType<T>();
+	uint32_t id = eventType.listeners.add(InlineFunction<void(const T&)>(std::forward<Listener>(eventListener)));
+	return EventSubscription(this, TypeIndex<Event>::get<T>(), id, false);
+}
+
+template <class T, class Listener>
+EventSubscription EventManager::registerForEvents(Listener&& eventListener)
+{
+	EventType<T>& eventType = getEventType<T>();
+	uint32_t id = eventType.batchListeners.add(InlineFunction<void(Span<const T>)>(std::forward<Listener>(eventListener)));
+	return EventSubscription(this, TypeIndex<Event>::get<T>(), id, true);
+}
+
+template <class T>
+EventManager::EventType<T>& EventManager::getEventType()
+{
+	eventid_t eventid = TypeIndex<Event>::get<T>();
+	if (eventid >= eventTypes.size()) {
+		eventTypes.resize(eventid + 1);
+	}
+	if (!eventTypes[eventid]) {
+		eventTypes[eventid].reset(new EventType<T>());
+	}
+	return static_cast<EventType<T>&>(*eventTypes[eventid]);
+}
+
+template <class T>
+EventManager::EventType<T>* EventManager::findEventType() const
+{
+	eventid_t eventid = TypeIndex<Event>::get<T>();
+	if (eventid >= eventTypes.size() || !eventTypes[eventid]) {
+		return nullptr;
+	}
+	return static_cast<EventType<T>*>(eventTypes[eventid].get());
+}
+
+template <class Function>
+uint32_t EventManager::ListenerList<Function>::add(Function&& function)
+{
+	uint32_t id;
+	if (!freeIds.empty()) {
+		id = freeIds.back();
+		freeIds.pop_back();
+	} else {
+		id = (uint32_t)indices.size();
+		indices.push_back(UINT32_MAX);
+	}
+
+	if (dispatching > 0) {
+		added.push_back(std::move(function));
+		addedIds.push_back(id);
 	} else {
-		eventid = iter->second;
+		indices[id] = (uint32_t)functions.size();
+		functions.push_back(std::move(function));
+		ids.push_back(id);
 	}
+	return id;
+}
 
-	EventCallbackList& list = eventListeners[eventid];
-	list.push_back([eventListener](const Event* event) {
-		eventListener(*(static_cast<const T*>(event)));
-	});
+template <class Function>
+void EventManager::ListenerList<Function>::remove(uint32_t id)
+{
+	uint32_t index = indices[id];
+	indices[id] = UINT32_MAX;
+	freeIds.push_back(id);
 
-	return list.size()-1;
+	if (index == UINT32_MAX) {
+		// Added during this dispatch, so not in functions yet
+		for (size_t i = 0; i < addedIds.size(); i++) {
+			if (addedIds[i] == id) {
+				added.erase(added.begin() + i);
+				addedIds.erase(addedIds.begin() + i);
+				break;
+			}
+		}
+	} else if (dispatching > 0) {
+		// The listener may be the one running, so it can't be moved or destroyed yet
+		ids[index] = UINT32_MAX;
+		hasRemovals = true;
+	} else {
+		removeAt(index);
+	}
+}
+
+template <class Function>
+template <class Arg>
+void EventManager::ListenerList<Function>::call(const Arg& argument)
+{
+	dispatching++;
+	for (size_t i = 0, count = functions.size(); i < count; i++) {
+		if (ids[i] != UINT32_MAX) {
+			functions[i](argument);
+		}
+	}
+	dispatching--;
+
+	if (dispatching == 0 && (hasRemovals || !added.empty())) {
+		settle();
+	}
+}
+
+template <class Function>
+void EventManager::ListenerList<Function>::settle()
+{
+	if (hasRemovals) {
+		hasRemovals = false;
+		for (size_t i = functions.size(); i > 0; i--) {
+			if (ids[i - 1] == UINT32_MAX) {
+				removeAt(i - 1);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < added.size(); i++) {
+		indices[addedIds[i]] = (uint32_t)functions.size();
+		functions.push_back(std::move(added[i]));
+		ids.push_back(addedIds[i]);
+	}
+	added.clear();
+	addedIds.clear();
+}
+
+template <class Function>
+void EventManager::ListenerList<Function>::removeAt(size_t index)
+{
+	size_t last = functions.size() - 1;
+	if (index != last) {
+		functions[index] = std::move(functions[last]);
+		ids[index] = ids[last];
+		indices[ids[index]] = (uint32_t)index;
+	}
+	functions.pop_back();
+	ids.pop_back();
+}
+
+template <class T>
+void EventManager::EventType<T>::push(const T& event, bool onOwnerThread)
+{
+	if (onOwnerThread) {
+		pending.push_back(event);
+	} else {
+		std::lock_guard<std::mutex> lock(sharedMutex);
+		sharedPending.push_back(event);
+	}
 }
 
 template <class T>
-eventid_t EventManager::registerEventType()
+bool EventManager::EventType<T>::dispatchQueued()
 {
-	size_t hash = typeid(T).hash_code();
-	eventTypeMap.emplace(hash, nextEventId);
-	eventListeners.push_back(EventCallbackList());
-	return nextEventId++;
-}
\ No newline at end of file
+	{
+		std::lock_guard<std::mutex> lock(sharedMutex);
+		if (pending.empty() && sharedPending.empty()) {
+			return false;
+		}
+		dispatching.swap(pending);
+		dispatching.insert(dispatching.end(), sharedPending.begin(), sharedPending.end());
+		sharedPending.clear();
+	}
+
+	batchListeners.call(Span<const T>(dispatching));
+	for (const T& event : dispatching) {
+		listeners.call(event);
+	}
+	dispatching.clear();
+	return true;
+}
+
+template <class T>
+void EventManager::EventType<T>::drainChannel()
+{
+	if (channel) {
+		channel->drain([this](T&& event) { pending.push_back(std::move(event)); });
+	}
+}
+
+template <class T>
+void EventManager::EventType<T>::removeListener(uint32_t listenerId, bool batch)
+{
+	if (batch) {
+		batchListeners.remove(listenerId);
+	} else {
+		listeners.remove(listenerId);
+	}
+}
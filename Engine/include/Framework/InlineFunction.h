@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*! A callable, like std::function, but stored inside the object when it fits in Capacity
+	bytes, so calling it is one indirect call with no allocation. Bound member functions
+	and lambdas capturing a few pointers fit in the default capacity; larger callables are
+	moved to the heap. Unlike std::function, it can only be moved, not copied. */
+template <class Signature, size_t Capacity = 48>
+class InlineFunction;
+
+template <class R, class... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity>
+{
+public:
+	InlineFunction() : invoker(nullptr), manager(nullptr) { }
+
+	template <class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, InlineFunction>::value>::type>
+	InlineFunction(F&& function);
+
+	InlineFunction(InlineFunction&& other);
+	InlineFunction& operator=(InlineFunction&& other);
+	~InlineFunction();
+
+	InlineFunction(const InlineFunction&) = delete;
+	InlineFunction& operator=(const InlineFunction&) = delete;
+
+	R operator()(Args... args) const;
+
+	explicit operator bool() const;
+
+	/*!
+	 * \brief Destroys the callable, leaving the function empty.
+	 */
+	void reset();
+
+	/*!
+	 * \brief Checks if a callable of type F would be stored inline.
+	 */
+	template <class F>
+	static constexpr bool fitsInline();
+private:
+	enum class Operation { Move, Destroy };
+	typedef R (*Invoker)(void* storage, Args... args);
+	typedef void (*Manager)(Operation operation, void* storage, void* destination);
+
+	/*! Picked between by fitsInline, so that only the branch taken is compiled. */
+	template <class F>
+	void construct(F&& function, std::true_type inlined);
+	template <class F>
+	void construct(F&& function, std::false_type inlined);
+
+	template <class F>
+	static R invokeInline(void* storage, Args... args);
+	template <class F>
+	static R invokeHeap(void* storage, Args... args);
+	template <class F>
+	static void manageInline(Operation operation, void* storage, void* destination);
+	template <class F>
+	static void manageHeap(Operation operation, void* storage, void* destination);
+
+	typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type storage;
+	Invoker invoker;
+	Manager manager;
+};
+
+template <class R, class... Args, size_t Capacity>
+template <class F, class>
+InlineFunction<R(Args...), Capacity>::InlineFunction(F&& function)
+{
+	construct(std::forward<F>(function), std::integral_constant<bool, fitsInline<typename std::decay<F>::type>()>());
+}
+
+template <class R, class... Args, size_t Capacity>
+InlineFunction<R(Args...), Capacity>::InlineFunction(InlineFunction&& other)
+	: invoker(other.invoker), manager(other.manager)
+{
+	if (manager != nullptr) {
+		manager(Operation::Move, &other.storage, &storage);
+		other.invoker = nullptr;
+		other.manager = nullptr;
+	}
+}
+
+template <class R, class... Args, size_t Capacity>
+InlineFunction<R(Args...), Capacity>& InlineFunction<R(Args...), Capacity>::operator=(InlineFunction&& other)
+{
+	if (this != &other) {
+		reset();
+		invoker = other.invoker;
+		manager = other.manager;
+		if (manager != nullptr) {
+			manager(Operation::Move, &other.storage, &storage);
+			other.invoker = nullptr;
+			other.manager = nullptr;
+		}
+	}
+	return *this;
+}
+
+template <class R, class... Args, size_t Capacity>
+InlineFunction<R(Args...), Capacity>::~InlineFunction()
+{
+	reset();
+}
+
+template <class R, class... Args, size_t Capacity>
+R InlineFunction<R(Args...), Capacity>::operator()(Args... args) const
+{
+	return invoker(const_cast<void*>(static_cast<const void*>(&storage)), std::forward<Args>(args)...);
+}
+
+template <class R, class... Args, size_t Capacity>
+InlineFunction<R(Args...), Capacity>::operator bool() const
+{
+	return invoker != nullptr;
+}
+
+template <class R, class... Args, size_t Capacity>
+void InlineFunction<R(Args...), Capacity>::reset()
+{
+	if (manager != nullptr) {
+		manager(Operation::Destroy, &storage, nullptr);
+		invoker = nullptr;
+		manager = nullptr;
+	}
+}
+
+template <class R, class... Args, size_t Capacity>
+template <class F>
+constexpr bool InlineFunction<R(Args...), Capacity>::fitsInline()
+{
+	return sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<F>::value;
+}
+
+template <class R, class... Args, size_t Capacity>
+template <class F>
+void InlineFunction<R(Args...), Capacity>::construct(F&& function, std::true_type inlined)
+{
+	typedef typename std::decay<F>::type Callable;
+	new (&storage) Callable(std::forward<F>(function));
+	invoker = &invokeInline<Callable>;
+	manager = &manageInline<Callable>;
+}
+
+template <class R, class... Args, size_t Capacity>
+template <class F>
+void InlineFunction<R(Args...), Capacity>::construct(F&& function, std::false_type inlined)
+{
+	typedef typename std::decay<F>::type Callable;
+	new (&storage) Callable*(new Callable(std::forward<F>(function)));
+	invoker = &invokeHeap<Callable>;
+	manager = &manageHeap<Callable>;
+}
+
+template <class R, class... Args, size_t Capacity>
+template <class F>
+R InlineFunction<R(Args...), Capacity>::invokeInline(void* storage, Args... args)
+{
+	return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+}
+
+template <class R, class... Args, size_t Capacity>
+template <class F>
+R InlineFunction<R(Args...), Capacity>::invokeHeap(void* storage, Args... args)
+{
+	return (**static_cast<F**>(storage))(std::forward<Args>(args)...);
+}
+
+template <class R, class... Args, size_t Capacity>
+template <class F>
+void InlineFunction<R(Args...), Capacity>::manageInline(Operation operation, void* storage, void* destination)
+{
+	F* function = static_cast<F*>(storage);
+	if (operation == Operation::Move) {
+		new (destination) F(std::move(*function));
+	}
+	function->~F();
+}
+
+template <class R, class... Args, size_t Capacity>
+template <class F>
+void InlineFunction<R(Args...), Capacity>::manageHeap(Operation operation, void* storage, void* destination)
+{
+	F* function = *static_cast<F**>(storage);
+	if (operation == Operation::Move) {
+		new (destination) F*(function);
+	} else {
+		delete function;
+	}
+}
@@ -32,13 +32,18 @@ public:
 
 	btPersistentManifold* getContact(eid_t e1, eid_t e2);
 private:
-	void handleContact(eid_t e1, eid_t e2, btPersistentManifold* contactManifold, CollisionResponseType type);
+	void handleContact(eid_t e1, eid_t e2, const btCollisionObject* body1, const btCollisionObject* body2, int flags1, int flags2, btPersistentManifold* contactManifold, CollisionResponseType type);
 
 	struct PhysicsContact
 	{
-		PhysicsContact() : lastContactFrame(UINT64_MAX), contactManifold(nullptr) { }
+		PhysicsContact() : lastContactFrame(UINT64_MAX), contactManifold(nullptr), flagsMin(0), flagsMax(0) { }
 		uint64_t lastContactFrame;
 		btPersistentManifold* contactManifold;
+		/*! The collision flags of the lower and higher entity IDs' bodies when the contact
+			began. Kept instead of the bodies, which may be deleted along with their entity
+			before the contact ends. */
+		int flagsMin;
+		int flagsMax;
 	};
 
 	EventManager& eventManager;
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "Framework/ComponentConstructor.h"
+#include "Framework/PrefabTemplate.h"
 #include "Framework/World.h"
 
 class Prefab
@@ -13,11 +14,21 @@ public:
 	Prefab(const std::string& name);
 
 	void addConstructor(ComponentConstructor* constructor);
-	std::vector<ComponentConstructorInfo> construct(World& world, eid_t parent, void* userinfo) const;
 	void finish(World& world, eid_t entity) const;
 
+	/*!
+	 * \brief Returns the prefab flattened into a template, which is what World spawns
+	 * from. It's built on first use and again after the prefab changes, and copies of the
+	 * prefab share it. Building it isn't thread safe, so call this once up front if the
+	 * prefab will first be spawned from several threads.
+	 */
+	const PrefabTemplate& getTemplate() const;
+
+	/*!
+	 * \brief Adds a prefab to construct along with this one, parented to its entity.
+	 */
 	void addChild(const std::shared_ptr<Prefab>& prefab);
-	std::vector<std::shared_ptr<Prefab>> getChildPrefabs() const;
+	const std::vector<std::shared_ptr<Prefab>>& getChildPrefabs() const;
 
 	void setName(const std::string& name);
 	std::string getName() const;
@@ -25,4 +36,6 @@ private:
 	std::vector<std::shared_ptr<ComponentConstructor>> constructors;
 	std::vector<std::shared_ptr<Prefab>> childPrefabs;
 	std::string name;
+
+	mutable std::shared_ptr<const PrefabTemplate> compiled;
 };
\ No newline at end of file
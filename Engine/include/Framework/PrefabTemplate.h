@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Framework/Component.h"
+#include "Framework/ComponentPool.h"
+#include "Framework/TypeIndex.h"
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+class World;
+class ComponentConstructor;
+
+/*! A prefab flattened for spawning. Components which constructors could describe up
+	front are kept as ready-made prototypes in one block of memory, so World can
+	instance the prefab by copy-constructing each straight into its pool. Constructors
+	which need the world, the parent or the userinfo are kept to run afterwards.
+
+	Prototypes are copied with their copy constructors, so a component type added here
+	must be copyable, and a copy of a freshly made component must be as good as a new one.
+	Templates are built by Prefab::getTemplate and can't be changed once they're shared. */
+class PrefabTemplate
+{
+public:
+	typedef std::unique_ptr<BaseComponentPool> (*PoolFactory)();
+
+	/*! How to make, move and destroy one of the prototypes without knowing its type. */
+	struct Entry {
+		uint32_t typeIndex;
+		PoolFactory createPool;
+		size_t offset;
+
+		/*! Copy-constructs the prototype into pool, attached to entity. */
+		void (*copy)(BaseComponentPool& pool, eid_t entity, const void* prototype);
+		void (*relocate)(void* from, void* to);
+		void (*destroy)(void* prototype);
+	};
+
+	PrefabTemplate(const std::string& name);
+	~PrefabTemplate();
+
+	PrefabTemplate(const PrefabTemplate&) = delete;
+	PrefabTemplate& operator=(const PrefabTemplate&) = delete;
+
+	/*!
+	 * \brief Adds a default-constructed prototype of T to the template.
+	 * \return The prototype, for the caller to fill in. If the template already has a T,
+	 *  that one is returned, so a later constructor's data replaces an earlier one's.
+	 */
+	template <class T>
+	T* addComponent();
+
+	/*!
+	 * \brief Adds a constructor to run on each new entity once the prototypes are copied.
+	 */
+	void addConstructor(const std::shared_ptr<ComponentConstructor>& constructor);
+
+	/*!
+	 * \brief Runs the constructors added with addConstructor, in order.
+	 */
+	void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const;
+
+	const std::vector<Entry>& getEntries() const;
+	const void* getPrototype(const Entry& entry) const;
+
+	/*!
+	 * \brief Returns a number no other template has had, so worlds can cache what they
+	 * work out about the template, such as its component IDs, in an array.
+	 */
+	uint32_t getId() const;
+	const std::string& getName() const;
+private:
+	/*! Makes room for a prototype at the end of the block, moving the others if the
+		block has to grow, and returns its offset. */
+	size_t allocate(size_t bytes, size_t alignment);
+
+	template <class T>
+	static void copyComponent(BaseComponentPool& pool, eid_t entity, const void* prototype);
+	template <class T>
+	static void relocateComponent(void* from, void* to);
+	template <class T>
+	static void destroyComponent(void* prototype);
+
+	std::vector<Entry> entries;
+	std::vector<std::shared_ptr<ComponentConstructor>> constructors;
+
+	/*! The prototypes, at the offsets in entries. Aligned for any component. */
+	char* data;
+	size_t size;
+	size_t capacity;
+
+	uint32_t id;
+	std::string name;
+};
+
+template <class T>
+T* PrefabTemplate::addComponent()
+{
+	static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned components are not supported");
+
+	uint32_t typeIndex = TypeIndex<Component>::get<T>();
+	for (const Entry& entry : entries) {
+		if (entry.typeIndex == typeIndex) {
+			return static_cast<T*>(const_cast<void*>(getPrototype(entry)));
+		}
+	}
+
+	Entry entry;
+	entry.typeIndex = typeIndex;
+	entry.createPool = &ComponentPool<T>::create;
+	entry.offset = allocate(sizeof(T), alignof(T));
+	entry.copy = &copyComponent<T>;
+	entry.relocate = &relocateComponent<T>;
+	entry.destroy = &destroyComponent<T>;
+
+	T* prototype = new (data + entry.offset) T();
+	entries.push_back(entry);
+	return prototype;
+}
+
+inline const std::vector<PrefabTemplate::Entry>& PrefabTemplate::getEntries() const
+{
+	return entries;
+}
+
+inline const void* PrefabTemplate::getPrototype(const Entry& entry) const
+{
+	return data + entry.offset;
+}
+
+template <class T>
+void PrefabTemplate::copyComponent(BaseComponentPool& pool, eid_t entity, const void* prototype)
+{
+	static_cast<ComponentPool<T>&>(pool).emplace(entity, *static_cast<const T*>(prototype));
+}
+
+template <class T>
+void PrefabTemplate::relocateComponent(void* from, void* to)
+{
+	T* component = static_cast<T*>(from);
+	new (to) T(std::move(*component));
+	component->~T();
+}
+
+template <class T>
+void PrefabTemplate::destroyComponent(void* prototype)
+{
+	static_cast<T*>(prototype)->~T();
+}
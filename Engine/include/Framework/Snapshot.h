@@ -0,0 +1,212 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/*! Appends raw bytes to a buffer, for World::snapshot and component serialize hooks.
+	Values are written in the machine's own layout, so snapshots are only meant to be
+	read back by the same build. */
+class SnapshotWriter
+{
+public:
+	SnapshotWriter(std::vector<char>& buffer) : buffer(buffer) { }
+
+	void write(const void* data, size_t size);
+
+	/*!
+	 * \brief Writes a trivially copyable value, such as a component's Data struct.
+	 */
+	template <class T>
+	void write(const T& value);
+
+	/*!
+	 * \brief Writes count trivially copyable values in one go.
+	 */
+	template <class T>
+	void writeArray(const T* values, size_t count);
+
+	void writeString(const std::string& string);
+
+	/*!
+	 * \brief Returns the number of bytes in the buffer, for use with overwrite.
+	 */
+	size_t position() const;
+
+	/*!
+	 * \brief Replaces a value written earlier at the given position, such as a length
+	 * which wasn't known until after what it measures was written.
+	 */
+	template <class T>
+	void overwrite(size_t position, const T& value);
+private:
+	std::vector<char>& buffer;
+};
+
+/*! Reads back what a SnapshotWriter wrote. Reading past the end of the data fails
+	the reader: the read value is zeroed, and every later read fails too. */
+class SnapshotReader
+{
+public:
+	SnapshotReader(const char* data, size_t size) : data(data), size(size), offset(0), failed(false) { }
+
+	bool read(void* value, size_t valueSize);
+
+	template <class T>
+	bool read(T& value);
+
+	template <class T>
+	bool readArray(T* values, size_t count);
+
+	bool readString(std::string& string);
+
+	/*!
+	 * \brief Moves past bytes without reading them.
+	 */
+	bool skip(size_t count);
+
+	/*!
+	 * \brief Returns the number of bytes left to read.
+	 */
+	size_t remaining() const;
+
+	bool hasFailed() const;
+private:
+	const char* data;
+	size_t size;
+	size_t offset;
+	bool failed;
+};
+
+/*!
+ * \brief Checks if a component type can be stored in a world snapshot. A component opts
+ * in by defining both of these members, which write and read whatever state it needs:
+ *
+ *     void serialize(SnapshotWriter& writer) const;
+ *     void deserialize(SnapshotReader& reader);
+ *
+ * deserialize is called on a default-constructed component.
+ */
+template <class T>
+class IsSnapshotSerializable
+{
+	template <class U>
+	static auto test(int) -> decltype(
+		std::declval<const U&>().serialize(std::declval<SnapshotWriter&>()),
+		std::declval<U&>().deserialize(std::declval<SnapshotReader&>()),
+		std::true_type());
+
+	template <class U>
+	static std::false_type test(...);
+public:
+	static const bool value = decltype(test<T>(0))::value;
+};
+
+inline void SnapshotWriter::write(const void* data, size_t size)
+{
+	size_t offset = buffer.size();
+	buffer.resize(offset + size);
+	if (size > 0) {
+		std::memcpy(&buffer[offset], data, size);
+	}
+}
+
+template <class T>
+void SnapshotWriter::write(const T& value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written directly");
+	write(&value, sizeof(T));
+}
+
+template <class T>
+void SnapshotWriter::writeArray(const T* values, size_t count)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written directly");
+	write(values, sizeof(T) * count);
+}
+
+inline void SnapshotWriter::writeString(const std::string& string)
+{
+	write((uint32_t)string.size());
+	write(string.data(), string.size());
+}
+
+inline size_t SnapshotWriter::position() const
+{
+	return buffer.size();
+}
+
+template <class T>
+void SnapshotWriter::overwrite(size_t position, const T& value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written directly");
+	std::memcpy(&buffer[position], &value, sizeof(T));
+}
+
+inline bool SnapshotReader::read(void* value, size_t valueSize)
+{
+	if (failed || valueSize > size - offset) {
+		failed = true;
+		std::memset(value, 0, valueSize);
+		return false;
+	}
+
+	if (valueSize > 0) {
+		std::memcpy(value, data + offset, valueSize);
+	}
+	offset += valueSize;
+	return true;
+}
+
+template <class T>
+bool SnapshotReader::read(T& value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read directly");
+	return read(&value, sizeof(T));
+}
+
+template <class T>
+bool SnapshotReader::readArray(T* values, size_t count)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read directly");
+	if (count > (size - offset) / sizeof(T)) {
+		failed = true;
+		return false;
+	}
+	return read(values, sizeof(T) * count);
+}
+
+inline bool SnapshotReader::readString(std::string& string)
+{
+	uint32_t length = 0;
+	if (!read(length) || length > size - offset) {
+		failed = true;
+		return false;
+	}
+	string.assign(data + offset, length);
+	offset += length;
+	return true;
+}
+
+inline bool SnapshotReader::skip(size_t count)
+{
+	if (failed || count > size - offset) {
+		failed = true;
+		return false;
+	}
+	offset += count;
+	return true;
+}
+
+inline size_t SnapshotReader::remaining() const
+{
+	return size - offset;
+}
+
+inline bool SnapshotReader::hasFailed() const
+{
+	return failed;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cassert>
+#include <vector>
+
+/*! A view of a contiguous array owned by something else, such as a ComponentPool's
+	entity list. Copying a span copies the pointer, not the elements. It is only valid
+	until its owner changes size. */
+template <class T>
+class Span
+{
+public:
+	Span() : elements(nullptr), count(0) { }
+	Span(T* elements, size_t count) : elements(elements), count(count) { }
+
+	template <class U>
+	Span(const std::vector<U>& vector) : elements(vector.data()), count(vector.size()) { }
+
+	T* begin() const { return elements; }
+	T* end() const { return elements + count; }
+	T* data() const { return elements; }
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	T& operator[](size_t index) const
+	{
+		assert(index < count);
+		return elements[index];
+	}
+private:
+	T* elements;
+	size_t count;
+};
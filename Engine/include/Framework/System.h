@@ -4,8 +4,13 @@
 #include <typeinfo>
 #include <vector>
 #include <cassert>
+#include <initializer_list>
+#include <functional>
+#include <atomic>
 
 #include "World.h"
+#include "WorldCommandBuffer.h"
+#include "WorkerPool.h"
 
 /*! Abstract base class for the System in ECS. Matches entities by component
 	and operates upon those components. */
@@ -13,12 +18,15 @@ class System
 {
 public:
 	System(World& world);
+	virtual ~System() = default;
 
 	/*!
 	 * \brief Updates all corresponding entities in the world (passed in the constructor).
+	 * Entities are taken from the world's query cache. Entities which gain the required
+	 * components during the update are not updated until the next call.
 	 * \param dt The time which passed since the last call to this function.
 	 */
-	void update(float dt);
+	virtual void update(float dt);
 
 	/*!
 	 * \brief Updates a single entity. Must be overriden in subclasses.
@@ -26,6 +34,38 @@ public:
 	 * \param entity The entity which should be updated.
 	 */
 	virtual void updateEntity(float dt, eid_t entity) = 0;
+
+	/*!
+	 * \brief Checks if this system and other may not update at the same time.
+	 * Systems which haven't declared their access conflict with every other system.
+	 */
+	bool conflictsWith(const System& other) const;
+
+	/*!
+	 * \brief Checks if the system has declared which components and resources it uses.
+	 */
+	bool hasDeclaredAccess() const;
+
+	/*!
+	 * \brief Returns the components passed to require.
+	 */
+	const ComponentBitmask& getRequiredComponents() const;
+
+	/*!
+	 * \brief Splits each update into chunks of entities which are updated on a worker pool.
+	 * updateEntity may then only modify the entity it is given, and must make structural
+	 * changes (creating and removing entities, adding and removing components) through getCommands.
+	 * Updates with no more than grainSize entities still run on the calling thread.
+	 * \param workerPool The pool to update on, or nullptr to update serially again.
+	 * \param grainSize The number of entities handed to a thread at a time.
+	 */
+	void setParallel(WorkerPool* workerPool, size_t grainSize = 64);
+	bool isParallel() const;
+
+	/*!
+	 * \brief Returns the number of entities the last update passed over with skipEntity.
+	 */
+	size_t getSkippedEntities() const;
 protected:
 	/*!
 	 * \brief Called by subclasses in their constructors. updateEntity will only
@@ -34,14 +74,124 @@ protected:
 	template<class T>
 	void require();
 
+	/*!
+	 * \brief Declares that the system reads, but never modifies, components of type T.
+	 * Once a system declares any access, SystemScheduler may update it alongside other
+	 * systems, so every component it touches (including required ones) must be declared.
+	 * Systems which add or remove components or construct entities must not declare access,
+	 * unless they only do so through getCommands.
+	 */
+	template<class T>
+	void reads();
+
+	/*!
+	 * \brief Declares that the system modifies components of type T. See reads.
+	 */
+	template<class T>
+	void writes();
+
+	/*!
+	 * \brief Declares that the system reads something outside of the world, such as the
+	 * physics world. Systems conflict if one writes a resource the other reads or writes.
+	 * \param resource Any pointer which identifies the resource, usually its address.
+	 */
+	void readsResource(const void* resource);
+
+	/*!
+	 * \brief Declares that the system modifies something outside of the world. See readsResource.
+	 */
+	void writesResource(const void* resource);
+
+	/*!
+	 * \brief Returns a buffer for structural changes to the world, which is played back
+	 * once update has visited every entity. During a parallel update each thread records
+	 * into its own buffer, and the buffers are played back one thread after another, so
+	 * commands are only kept in order relative to others from the same call to updateEntity.
+	 * Subclasses which override update must call playbackCommands themselves.
+	 * Systems added to a SystemScheduler run alongside each other, so their commands are
+	 * instead played back by the scheduler once every system has finished updating.
+	 */
+	WorldCommandBuffer& getCommands();
+
+	/*!
+	 * \brief Plays back everything recorded through getCommands, unless the system belongs
+	 * to a SystemScheduler, which plays them back itself.
+	 */
+	void playbackCommands();
+
+	/*!
+	 * \brief Starts a new update: takes a new change tick from the world and resets the
+	 * skipped entity count. Subclasses which override update must call this first.
+	 */
+	void beginUpdate();
+
+	/*!
+	 * \brief Returns the change tick at which the previous update started, or 0 before
+	 * the first update.
+	 */
+	uint32_t getLastUpdateTick() const;
+
+	/*!
+	 * \brief Checks if an entity's component of type T was added or marked as changed
+	 * since the previous update started. Changes the system made itself are not counted.
+	 */
+	template<class T>
+	bool changedSinceLastUpdate(eid_t entity);
+
+	/*!
+	 * \brief Records that the system modified an entity's component of type T, for
+	 * other systems checking changedSinceLastUpdate.
+	 */
+	template<class T>
+	void markChanged(eid_t entity);
+
+	/*!
+	 * \brief Counts an entity which updateEntity had no work to do for, for getSkippedEntities.
+	 */
+	void skipEntity();
+
+	/*!
+	 * \brief Counts several skipped entities at once, for systems which don't go through updateEntity.
+	 */
+	void skipEntities(size_t count);
+
+	/*!
+	 * \brief Calls updateRange over [0, count), splitting it across the worker pool if the
+	 * system is parallel. Whatever is being iterated must not change until this returns.
+	 */
+	void updateParallel(size_t count, const std::function<void(size_t, size_t)>& updateRange);
+
 	/*! The world which this system operates on. */
 	World& world;
 
 	/*! The bitmask of component IDs which is generated from calls to require. */
 	ComponentBitmask requiredComponents;
 private:
-	/*! Iterator we use to get entities to update. */
-	World::eid_iterator entityIterator;
+	friend class SystemScheduler;
+
+	/*! Plays back the command buffers, whether or not the system is scheduled. */
+	void flushCommands();
+
+	static bool sharesResource(const std::vector<const void*>& resources, const std::vector<const void*>& otherResources);
+
+	ComponentBitmask readComponents;
+	ComponentBitmask writeComponents;
+	std::vector<const void*> readResources;
+	std::vector<const void*> writeResources;
+	bool declaredAccess;
+
+	/*! Set while the system belongs to a SystemScheduler. */
+	bool scheduled;
+
+	uint32_t lastUpdateTick;
+	uint32_t currentUpdateTick;
+	std::atomic<size_t> skippedEntities;
+
+	WorkerPool* workerPool;
+	size_t grainSize;
+
+	/*! One buffer per pool thread, or a single buffer if the system isn't parallel. */
+	std::vector<std::unique_ptr<WorldCommandBuffer>> commandBuffers;
 };
 
 template <class T>
@@ -49,4 +199,90 @@ void System::require()
 {
 	cid_t cid = world.getComponentId<T>();
 	requiredComponents.setBit(cid, true);
+}
+
+template <class T>
+bool System::changedSinceLastUpdate(eid_t entity)
+{
+	return world.changedSince<T>(entity, lastUpdateTick);
+}
+
+template <class T>
+void System::markChanged(eid_t entity)
+{
+	world.markChanged<T>(entity, currentUpdateTick);
+}
+
+template <class T>
+void System::reads()
+{
+	readComponents.setBit(world.getComponentId<T>(), true);
+	declaredAccess = true;
+}
+
+template <class T>
+void System::writes()
+{
+	writeComponents.setBit(world.getComponentId<T>(), true);
+	declaredAccess = true;
+}
+
+/*! A System which is handed its components directly. Entities are matched through
+	World::view, so the components don't have to be looked up again in updateEntity.
+	Matches entities which have at least the components Ts; other components can still
+	be fetched through the world inside updateEntity. */
+template <class... Ts>
+class TypedSystem : public System
+{
+public:
+	TypedSystem(World& world);
+
+	virtual void update(float dt);
+
+	/*!
+	 * \brief Updates a single entity. Must be overriden in subclasses.
+	 * \param dt The time which passed since the last call to update.
+	 * \param entity The entity which should be updated.
+	 * \param components The entity's components, in the order given to TypedSystem.
+	 */
+	virtual void updateEntity(float dt, eid_t entity, Ts&... components) = 0;
+
+	/*!
+	 * \brief Looks up the entity's components and forwards to the typed updateEntity.
+	 */
+	virtual void updateEntity(float dt, eid_t entity);
+};
+
+template <class... Ts>
+TypedSystem<Ts...>::TypedSystem(World& world)
+	: System(world)
+{
+	(void)std::initializer_list<int>{ (this->template require<Ts>(), 0)... };
+}
+
+template <class... Ts>
+void TypedSystem<Ts...>::update(float dt)
+{
+	beginUpdate();
+
+	View<Ts...> view = world.view<Ts...>();
+	if (!isParallel()) {
+		view.each([this, dt](eid_t entity, Ts&... components) {
+			this->updateEntity(dt, entity, components...);
+		});
+	} else {
+		updateParallel(view.sizeHint(), [this, dt, &view](size_t begin, size_t end) {
+			view.each(begin, end, [this, dt](eid_t entity, Ts&... components) {
+				this->updateEntity(dt, entity, components...);
+			});
+		});
+	}
+	playbackCommands();
+}
+
+template <class... Ts>
+void TypedSystem<Ts...>::updateEntity(float dt, eid_t entity)
+{
+	assert(world.entityHasComponents(entity, requiredComponents));
+	updateEntity(dt, entity, *world.getComponent<Ts>(entity)...);
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Framework/System.h"
+#include "Framework/WorkerPool.h"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+/*! Updates a list of systems, running systems which don't conflict (see
+	System::conflictsWith) on a worker pool at the same time. Whenever two systems
+	conflict, the one added first always finishes updating before the other starts,
+	so the result is the same as updating every system in the order it was added.
+	Commands systems record through System::getCommands are played back after every
+	system has finished, on the thread which called update, in the order systems were added. */
+class SystemScheduler
+{
+public:
+	SystemScheduler(WorkerPool& workerPool);
+	~SystemScheduler();
+
+	/*!
+	 * \brief Adds a system to the end of the update order.
+	 * The system must outlive the scheduler.
+	 */
+	void add(System& system);
+
+	/*!
+	 * \brief Updates every system once, then plays back their commands.
+	 * \param dt The time which passed since the last call to this function.
+	 */
+	void update(float dt);
+
+	/*!
+	 * \brief When set, systems are updated one at a time on the calling thread in the
+	 * order they were added, which makes debugging easier.
+	 */
+	void setDeterministic(bool deterministic);
+	bool isDeterministic() const;
+
+	/*!
+	 * \brief Returns the systems which must finish before the system at index can start.
+	 * Indices are in the order systems were added.
+	 */
+	std::vector<size_t> getDependencies(size_t index) const;
+private:
+	void run(size_t index, float dt, TaskCounter& counter);
+	void playbackCommands();
+
+	WorkerPool& workerPool;
+	bool deterministic;
+
+	std::vector<System*> systems;
+
+	/*! For each system, the later systems which conflict with it. */
+	std::vector<std::vector<size_t>> dependents;
+
+	/*! For each system, the number of earlier systems which conflict with it. */
+	std::vector<unsigned> dependencyCounts;
+
+	/*! Dependencies still running during an update. */
+	std::unique_ptr<std::atomic<unsigned>[]> remainingDependencies;
+};
\ No newline at end of file
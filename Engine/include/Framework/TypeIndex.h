@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/*! Hands out a small, dense index to each type of a family, such as every component
+	type or every event type, the first time it is asked about. Later calls are a
+	load from a function-local static, so they are cheap enough for hot paths where
+	typeid and a hash map lookup aren't. Indices are shared by the whole program and
+	are safe to request from any thread, but they depend on the order types are first
+	seen in, so don't save them. */
+template <class Family>
+class TypeIndex
+{
+public:
+	/*!
+	 * \brief Returns the index of T within Family, in [0, count()).
+	 */
+	template <class T>
+	static uint32_t get();
+
+	/*!
+	 * \brief Returns the number of types in Family given an index so far.
+	 */
+	static uint32_t count();
+private:
+	static std::atomic<uint32_t>& counter();
+};
+
+template <class Family>
+template <class T>
+uint32_t TypeIndex<Family>::get()
+{
+	static const uint32_t index = counter()++;
+	return index;
+}
+
+template <class Family>
+uint32_t TypeIndex<Family>::count()
+{
+	return counter();
+}
+
+template <class Family>
+std::atomic<uint32_t>& TypeIndex<Family>::counter()
+{
+	static std::atomic<uint32_t> next(0);
+	return next;
+}
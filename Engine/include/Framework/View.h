@@ -0,0 +1,201 @@
+#pragma once
+
+#include "Framework/ComponentPool.h"
+
+#include <tuple>
+#include <initializer_list>
+
+/*! Iterates every entity which has all of the components Ts, handing back the
+	entity and references to its components. Obtained through World::view.
+
+	Iteration walks the smallest of the pools backwards and looks the entity up in
+	the other pools, so it is safe to remove the current entity's components (or
+	add components to other entities) while iterating; components added during
+	iteration are not visited. */
+template <class... Ts>
+class View
+{
+public:
+	static_assert(sizeof...(Ts) > 0, "A view needs at least one component type");
+
+	typedef std::tuple<eid_t, Ts&...> value_type;
+
+	class iterator
+	{
+	public:
+		iterator(View* view, size_t remaining);
+		value_type operator*() const;
+		iterator& operator++();
+		bool operator==(const iterator& other) const;
+		bool operator!=(const iterator& other) const;
+	private:
+		void skipUnmatched();
+
+		View* view;
+
+		/*! Index past the current entity in the smallest pool's dense array. */
+		size_t remaining;
+	};
+
+	View(ComponentPool<Ts>&... pools);
+
+	iterator begin();
+	iterator end();
+
+	/*!
+	 * \brief Calls func(entity, components...) for every matching entity.
+	 * This is faster than iterating with begin/end, since each component is only looked up once.
+	 */
+	template <class Func>
+	void each(Func func);
+
+	/*!
+	 * \brief Calls func(entity, components...) for the matching entities among [begin, end)
+	 * of the pool being iterated, where end is at most sizeHint(). Components must not be
+	 * added or removed while this runs, but disjoint ranges may be iterated on different threads.
+	 */
+	template <class Func>
+	void each(size_t begin, size_t end, Func func);
+
+	/*!
+	 * \brief Returns an upper bound on the number of entities in the view.
+	 */
+	size_t sizeHint() const;
+private:
+	bool matches(eid_t entity) const;
+	static bool allValid(const Ts*... components);
+
+	std::tuple<ComponentPool<Ts>*...> pools;
+
+	/*! The pool we iterate over. Every other pool is only used for lookups. */
+	const BaseComponentPool* smallest;
+};
+
+template <class... Ts>
+View<Ts...>::View(ComponentPool<Ts>&... pools)
+	: pools(&pools...), smallest(nullptr)
+{
+	for (const BaseComponentPool* pool : { static_cast<const BaseComponentPool*>(&pools)... }) {
+		if (smallest == nullptr || pool->size() < smallest->size()) {
+			smallest = pool;
+		}
+	}
+}
+
+template <class... Ts>
+typename View<Ts...>::iterator View<Ts...>::begin()
+{
+	return iterator(this, smallest->size());
+}
+
+template <class... Ts>
+typename View<Ts...>::iterator View<Ts...>::end()
+{
+	return iterator(this, 0);
+}
+
+template <class... Ts>
+size_t View<Ts...>::sizeHint() const
+{
+	return smallest->size();
+}
+
+template <class... Ts>
+bool View<Ts...>::allValid(const Ts*... components)
+{
+	bool valid = true;
+	(void)std::initializer_list<int>{ (valid = valid && components != nullptr, 0)... };
+	return valid;
+}
+
+template <class... Ts>
+bool View<Ts...>::matches(eid_t entity) const
+{
+	bool match = true;
+	(void)std::initializer_list<int>{ (match = match && std::get<ComponentPool<Ts>*>(pools)->has(entity), 0)... };
+	return match;
+}
+
+template <class... Ts>
+template <class Func>
+void View<Ts...>::each(Func func)
+{
+	const std::vector<eid_t>& entities = smallest->getEntities();
+	for (size_t i = entities.size(); i > 0; i--) {
+		// Components may have been removed by func
+		if (i > entities.size()) {
+			i = entities.size();
+			if (i == 0) {
+				break;
+			}
+		}
+
+		eid_t entity = entities[i - 1];
+		std::tuple<Ts*...> components(std::get<ComponentPool<Ts>*>(pools)->get(entity)...);
+		if (allValid(std::get<Ts*>(components)...)) {
+			func(entity, *std::get<Ts*>(components)...);
+		}
+	}
+}
+
+template <class... Ts>
+template <class Func>
+void View<Ts...>::each(size_t begin, size_t end, Func func)
+{
+	const std::vector<eid_t>& entities = smallest->getEntities();
+	assert(end <= entities.size());
+	for (size_t i = begin; i < end; i++) {
+		eid_t entity = entities[i];
+		std::tuple<Ts*...> components(std::get<ComponentPool<Ts>*>(pools)->get(entity)...);
+		if (allValid(std::get<Ts*>(components)...)) {
+			func(entity, *std::get<Ts*>(components)...);
+		}
+	}
+}
+
+template <class... Ts>
+View<Ts...>::iterator::iterator(View* view, size_t remaining)
+	: view(view), remaining(remaining)
+{
+	skipUnmatched();
+}
+
+template <class... Ts>
+typename View<Ts...>::value_type View<Ts...>::iterator::operator*() const
+{
+	eid_t entity = view->smallest->getEntities()[remaining - 1];
+	return value_type(entity, *std::get<ComponentPool<Ts>*>(view->pools)->get(entity)...);
+}
+
+template <class... Ts>
+typename View<Ts...>::iterator& View<Ts...>::iterator::operator++()
+{
+	--remaining;
+	skipUnmatched();
+	return *this;
+}
+
+template <class... Ts>
+bool View<Ts...>::iterator::operator==(const iterator& other) const
+{
+	return remaining == other.remaining;
+}
+
+template <class... Ts>
+bool View<Ts...>::iterator::operator!=(const iterator& other) const
+{
+	return remaining != other.remaining;
+}
+
+template <class... Ts>
+void View<Ts...>::iterator::skipUnmatched()
+{
+	const std::vector<eid_t>& entities = view->smallest->getEntities();
+	if (remaining > entities.size()) {
+		remaining = entities.size();
+	}
+
+	while (remaining > 0 && !view->matches(entities[remaining - 1])) {
+		--remaining;
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+
+/*! Counts the unfinished tasks pushed with it, so that a caller can wait for its
+	own tasks without waiting for everything else running on the pool. */
+class TaskCounter
+{
+public:
+	TaskCounter() : count(0) { }
+	bool done() const { return count == 0; }
+private:
+	friend class WorkerPool;
+	std::atomic<unsigned> count;
+};
+
+/*! A fixed set of threads which run queued tasks. Each thread has its own queue:
+	tasks pushed from inside a task go to the pushing thread's queue, and threads
+	with nothing to do steal from the others. Threads waiting on a TaskCounter also
+	run tasks, so a pool of N threads only starts N - 1 of its own. */
+class WorkerPool
+{
+public:
+	/*!
+	 * \brief Starts the worker threads.
+	 * \param threadCount The number of threads to run tasks on, including the thread
+	 *  which calls wait. Zero uses one thread per hardware thread.
+	 */
+	WorkerPool(unsigned threadCount = 0);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/*!
+	 * \brief Queues a task. Tasks may push more tasks while they run.
+	 * \param counter Incremented now and decremented when the task finishes.
+	 */
+	void push(std::function<void()> task, TaskCounter& counter);
+
+	/*!
+	 * \brief Runs queued tasks on the calling thread until every task pushed with
+	 * counter has finished. May be called from inside a task.
+	 */
+	void wait(TaskCounter& counter);
+
+	/*!
+	 * \brief Calls func(begin, end) over [0, count) in chunks of at most grainSize,
+	 * spread over the pool, and returns when every chunk has finished.
+	 */
+	template <class Func>
+	void parallelFor(size_t count, size_t grainSize, Func func);
+
+	/*!
+	 * \brief Returns the number of threads which run tasks, including the caller of wait.
+	 */
+	unsigned getThreadCount() const;
+
+	/*!
+	 * \brief Returns the index of the calling thread within the pool, in [0, getThreadCount()).
+	 * Threads which don't belong to the pool share index 0.
+	 */
+	unsigned getCurrentThreadIndex() const;
+private:
+	struct Task {
+		std::function<void()> function;
+		TaskCounter* counter;
+	};
+
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void workerLoop(unsigned index);
+
+	/*! Takes a task from the given thread's queue, or steals one from another queue. */
+	bool pop(unsigned index, Task& task);
+	void run(Task& task);
+
+	std::vector<std::thread> threads;
+
+	/*! One queue per thread. Index 0 is shared by every thread outside the pool. */
+	std::vector<std::unique_ptr<Queue>> queues;
+
+	/*! Tasks sitting in a queue, so sleeping threads know when to wake. */
+	std::atomic<unsigned> queued;
+
+	std::mutex sleepMutex;
+	/*! Signalled when a task is pushed, when a counter reaches zero and on shutdown. */
+	std::condition_variable condition;
+	bool stopping;
+};
+
+template <class Func>
+void WorkerPool::parallelFor(size_t count, size_t grainSize, Func func)
+{
+	grainSize = std::max<size_t>(grainSize, 1);
+
+	TaskCounter counter;
+	for (size_t begin = 0; begin < count; begin += grainSize) {
+		size_t end = std::min(begin + grainSize, count);
+		push([&func, begin, end]() { func(begin, end); }, counter);
+	}
+	wait(counter);
+}
\ No newline at end of file
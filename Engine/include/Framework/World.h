@@ -2,35 +2,78 @@
 
 #include "Framework/Component.h"
 #include "Framework/ComponentBitmask.h"
+#include "Framework/ComponentPool.h"
+#include "Framework/View.h"
+#include "Framework/TypeIndex.h"
+#include "Framework/Span.h"
+#include "Framework/Snapshot.h"
 
 #include <unordered_map>
-#include <map>
 #include <memory>
+#include <mutex>
+#include <atomic>
 #include <cassert>
 #include <string>
+#include <utility>
 
 class Prefab;
+class PrefabTemplate;
+class WorldCommandBuffer;
 
-typedef uint32_t eid_t;
-typedef uint32_t cid_t;
+/*! The ID of an interned entity name. 0 means the entity has no name.
+
+	Defining WORLD_STRIP_NAMES drops entity names, saving their memory and the cost of
+	looking them up on every spawn. Entities are then only named "Entity <slot>", and
+	getEntityWithName always fails, so only define it for programs which don't look
+	entities up by name. */
+typedef uint32_t nid_t;
+
+/*! Counters for World's query cache, for profiling. */
+struct WorldStats
+{
+	WorldStats() : queryHits(0), queryRebuilds(0), queryUpdates(0),
+		entitiesDeleted(0), lastCleanupDeletions(0), lastCleanupMicros(0.0) { }
+
+	/*! Calls to getEntitiesMatching which were answered from the cache. */
+	unsigned long long queryHits;
+
+	/*! Calls to getEntitiesMatching which had to build a new list by scanning every entity. */
+	unsigned long long queryRebuilds;
+
+	/*! Entities added to or removed from cached lists as their components changed. */
+	unsigned long long queryUpdates;
+
+	/*! Entities destroyed by cleanupEntities. */
+	unsigned long long entitiesDeleted;
+
+	/*! Entities destroyed by the most recent call to cleanupEntities. */
+	unsigned lastCleanupDeletions;
+
+	/*! Time taken by the most recent call to cleanupEntities, in microseconds. */
+	double lastCleanupMicros;
+};
 
 class World
 {
 public:
-	World() : nextComponentId(0), nextEntityId(0) { }
+	World();
 	
 	/*!
 	\brief Frees the memory from deleted entities. Can be called every frame.
+	Only the entities passed to removeEntity since the last call are visited, and only
+	the pools they have components in are touched, so this is free if nothing was deleted.
 	*/
 	void cleanupEntities();
 
 	/*!
-	 \brief Gets the name of an entity.
+	 \brief Gets the name of an entity. Unnamed entities are called "Entity <slot>".
+	 \return The name, or an empty string if the entity has been deleted.
 	 */
 	std::string getEntityName(eid_t eid) const;
 
 	/*!
-	 \brief Returns the first entity found with a given name.
+	 \brief Returns the oldest living entity with a given name. Takes a single hash lookup.
+	 \return The entity, or NullEntity if no entity has the name.
 	 */
 	eid_t getEntityWithName(const std::string& name);
 
@@ -50,9 +93,16 @@ public:
 
 	/*!
 	 \brief Deletes an entity from the world.
+	 The entity stays alive until the next call to cleanupEntities.
 	*/
 	void removeEntity(eid_t entity);
 
+	/*!
+	 \brief Checks if an entity exists. IDs of deleted entities are never reused, so this
+	 is false for them even after their slot is given to a new entity.
+	 */
+	bool isAlive(eid_t entity) const;
+
 	/*!
 	 \brief Checks if an entity has components.
 	 To construct the ComponentBitmask, call getComponentId and set the corresponding bitmask bit.
@@ -79,6 +129,47 @@ public:
 	template <class T>
 	T* addComponent(eid_t entity);
 
+	/*!
+	 \brief Constructs a component in place in its pool and attaches it to an entity.
+	 Once a pool has grown to fit, adding components this way doesn't allocate.
+	 \param entity The entity to which the component is added.
+	 \param args Passed to the component's constructor.
+	 \return The component which was added, or the entity's existing component of the
+	 same type, in which case args are ignored.
+	 */
+	template <class T, class... Args>
+	T* emplaceComponent(eid_t entity, Args&&... args);
+
+	/*!
+	 \brief Records that an entity's component of type T was modified, so systems which
+	 check changedSince skip it only while it stays untouched. Components are also stamped
+	 when they are added. Does nothing if the entity has no such component.
+	 \param tick The tick to stamp the component with. Defaults to the current change tick.
+	 */
+	template <class T>
+	void markChanged(eid_t entity);
+	template <class T>
+	void markChanged(eid_t entity, uint32_t tick);
+
+	/*!
+	 \brief Checks if an entity's component of type T was added or marked as changed after
+	 the given change tick. Entities without the component count as unchanged.
+	 */
+	template <class T>
+	bool changedSince(eid_t entity, uint32_t tick);
+
+	/*!
+	 \brief Returns the current change tick, which components are stamped with when they change.
+	 */
+	uint32_t getChangeTick() const;
+
+	/*!
+	 \brief Returns the current change tick and moves it on by one. Systems call this as they
+	 start updating, so that changes stamped from then on are newer than the returned tick.
+	 This may be called from several systems updating at once.
+	 */
+	uint32_t advanceChangeTick();
+
 	/*!
 	 \brief Removes a component from an entity.
 	 \param entity The entity from which the component is removed.
@@ -98,27 +189,142 @@ public:
 	T* getComponent(eid_t entity, bool insert=false);
 
 	/*!
-	 \brief Returns the internal ID of a component.
+	 \brief Returns the internal ID of a component, registering the type the first time.
+	 After that it is an array lookup, with no hashing.
 	 */
 	template <class T>
 	cid_t getComponentId();
 
 	/*!
-	 \brief Returns all entities with the given component attached.
+	 \brief Returns a copy of the list of entities with the given component attached.
+	 Prefer each, first or count, which don't copy.
 	 */
 	template <class T>
 	std::vector<eid_t> getEntitiesWithComponent();
 
 	/*!
-	 \brief Immediately deletes all entities.
+	 \brief Returns the entities with the given component attached, straight from the
+	 component's pool. Adding or removing components of type T invalidates the span, so
+	 copy it with getEntitiesWithComponent if the loop does that.
+	 */
+	template <class T>
+	Span<const eid_t> each();
+
+	/*!
+	 \brief Returns an entity with the given component attached, or NullEntity if there
+	 are none. Meant for components only one entity has, like the player's.
+	 */
+	template <class T>
+	eid_t first();
+
+	/*!
+	 \brief Returns the number of entities with the given component attached.
+	 */
+	template <class T>
+	size_t count();
+
+	/*!
+	 \brief Returns a view over all entities which have every one of the given components.
+	 Iterating the view yields (entity, T1&, T2&, ...) tuples; see View.
+	 */
+	template <class... Ts>
+	View<Ts...> view();
+
+	/*!
+	 \brief Returns all entities which have every component in the given bitmask.
+	 The first call with a signature scans every entity and caches the result. World keeps
+	 the cached list up to date as components are added and removed, so later calls are
+	 only a lookup. The list is modified in place when components change, and the
+	 order of entities in it is unspecified.
+	 This may be called from several systems updating at once.
+	 */
+	const std::vector<eid_t>& getEntitiesMatching(const ComponentBitmask& signature);
+
+	/*!
+	 \brief Returns counters for the query cache.
+	 */
+	const WorldStats& getStats() const;
+
+	/*!
+	 \brief Zeroes the counters returned by getStats.
+	 */
+	void resetStats();
+
+	/*!
+	 \brief Immediately deletes all entities. Resources are kept.
 	 */
 	void clear();
 
+	/*!
+	 \brief Writes the world's entities, their names and their components into buffer,
+	 replacing what was there. Only components with snapshot hooks are stored (see
+	 IsSnapshotSerializable); resources aren't. Reusing a buffer avoids allocating it again.
+	 Command buffers must be played back first.
+	 */
+	void snapshot(std::vector<char>& buffer) const;
+
+	/*!
+	 \brief Puts the world back the way it was when a snapshot was taken. Every existing
+	 component is destroyed, including those of types the snapshot couldn't store. Entity
+	 IDs come back exactly, so IDs kept in components stay valid, and restored components
+	 count as changed. Components are matched up by type, so a snapshot can be restored
+	 into another world from the same build once it has registered the component types
+	 with getComponentId. Cached queries are refilled in place.
+	 \return False if the data isn't a snapshot from this build, leaving the world as it
+	 was, or if it is cut short, leaving the world empty.
+	 */
+	bool restore(const std::vector<char>& buffer);
+
+	/*!
+	 \brief Stores the world's one object of type T, such as the level or the player's
+	 entity, replacing any existing one. Systems can then get at it with resource<T>
+	 instead of searching for an entity which has it.
+	 \param args Passed to T's constructor.
+	 \return The new resource.
+	 */
+	template <class T, class... Args>
+	T& setResource(Args&&... args);
+
+	/*!
+	 \brief Gets the world's object of type T. Takes an array lookup.
+	 \return The resource, or nullptr if none has been set.
+	 */
+	template <class T>
+	T* resource();
+
+	/*!
+	 \brief Destroys the world's object of type T, if it has one.
+	 */
+	template <class T>
+	void removeResource();
+
+	/*!
+	 \brief Records that the resource of type T was modified in place, for getResourceVersion.
+	 */
+	template <class T>
+	void markResourceChanged();
+
+	/*!
+	 \brief Returns a number which changes whenever the resource of type T is set, removed
+	 or marked as changed. Systems can keep the last version they saw, and only redo work
+	 which depends on the resource when it differs.
+	 */
+	template <class T>
+	unsigned long long getResourceVersion();
+
 	struct Entity {
-		Entity(const std::string& name, ComponentBitmask components)
-			: name(name), components(components), markedForDeletion(false) { }
+		Entity(eid_t id);
+
+		/*! The ID of the entity in this slot, or of the next entity to use it if the slot is free. */
+		eid_t id;
+		bool alive;
 		bool markedForDeletion;
-		std::string name;
+#ifndef WORLD_STRIP_NAMES
+		nid_t name;
+		/*! Neighbours in the list of living entities sharing this name, oldest first. */
+		eid_t previousWithName;
+		eid_t nextWithName;
+#endif
 		ComponentBitmask components;
 	};
 
@@ -126,53 +332,239 @@ public:
 	{
 	public:
 		eid_iterator();
-		eid_iterator(std::map<eid_t, Entity>::iterator entityIterBegin,
-			std::map<eid_t, Entity>::iterator entityIterEnd,
+		eid_iterator(std::vector<Entity>::iterator entityIterBegin,
+			std::vector<Entity>::iterator entityIterEnd,
 			ComponentBitmask match);
 		eid_t value();
 		void reset();
 		void next();
 		bool atEnd();
 	private:
-		std::map<eid_t, Entity>::iterator entityIterBegin;
-		std::map<eid_t, Entity>::iterator entityIter;
-		std::map<eid_t, Entity>::iterator entityIterEnd;
+		bool matches(const Entity& entity) const;
+
+		std::vector<Entity>::iterator entityIterBegin;
+		std::vector<Entity>::iterator entityIter;
+		std::vector<Entity>::iterator entityIterEnd;
 		ComponentBitmask match;
 	};
 
 	eid_iterator getEidIterator(ComponentBitmask match);
 	const static eid_t NullEntity;
 private:
-	typedef std::unordered_map<eid_t, std::unique_ptr<Component>> ComponentPool;
+	friend class WorldCommandBuffer;
+
+	typedef std::unique_ptr<BaseComponentPool> (*PoolFactory)();
 
 	template <class T>
-	cid_t registerComponent();
+	ComponentPool<T>& getPool();
+
+	/*! The same as the template version, for callers which only have the type's TypeIndex. */
+	cid_t getComponentId(uint32_t typeIndex, PoolFactory createPool);
+	cid_t registerComponent(uint32_t typeIndex, PoolFactory createPool);
+
+	/*! A cached list of the entities matching a signature. */
+	struct Query {
+		Query(const ComponentBitmask& signature) : signature(signature) { }
+		ComponentBitmask signature;
+		EntitySet entities;
+	};
+
+	/*!
+	 \brief Moves an entity in or out of the cached queries after its components change.
+	 \param oldComponents The entity's components before the change, or nullptr if it was just created.
+	 \param newComponents The entity's components after the change, or nullptr if it is being deleted.
+	 */
+	void updateQueries(eid_t entity, const ComponentBitmask* oldComponents, const ComponentBitmask* newComponents);
+
+	std::vector<std::unique_ptr<Query>> queries;
+	WorldStats stats;
+
+	/*! Guards queries and stats in getEntitiesMatching, which SystemScheduler calls from worker threads. */
+	std::mutex queryMutex;
+
+	/*! Free slots are only reused once there are more than this many, so that any
+		one slot's generation climbs slowly. */
+	static const size_t minimumFreeIndices = 1024;
+
+	/*!
+	 \brief Returns the entity with the given ID, or nullptr if it has been deleted.
+	 */
+	Entity* getEntity(eid_t entity);
+	const Entity* getEntity(eid_t entity) const;
+
+	/*!
+	 \brief Drops an entity from the cached queries and frees its slot. Its components
+	 must already have been removed, or be removed straight afterwards.
+	 */
+	void releaseEntity(Entity& entity);
+
+	/*!
+	 \brief Picks the ID of an entity without creating it. isAlive is false for the ID
+	 until it is passed to activateEntity. May be called from several threads at once,
+	 as long as nothing else is changing the world.
+	 */
+	eid_t reserveEntity();
+
+	/*!
+	 \brief Brings a reserved entity to life, without any components. Queries are not
+	 updated; the caller must call updateQueries once the entity has its components.
+	 */
+	Entity& activateEntity(eid_t entity, const std::string& name);
+	Entity& activateEntity(eid_t entity, nid_t name);
+
+	/*!
+	 \brief Constructs a prefab as a reserved entity. See the public constructPrefab.
+	 */
+	void constructPrefab(eid_t entity, const Prefab& prefab, eid_t parent, void* userinfo);
+
+	/*! What a world needs to know to spawn a prefab template, worked out on first use. */
+	struct PrefabLayout {
+		PrefabLayout() : built(false), name(0) { }
+		bool built;
+		/*! The component ID of each of the template's entries, in the same order. */
+		std::vector<cid_t> componentIds;
+		ComponentBitmask components;
+		nid_t name;
+	};
+
+	/*! Indexed by PrefabTemplate::getId. Forgotten by reset, since it forgets the names. */
+	std::vector<PrefabLayout> prefabLayouts;
+
+	const PrefabLayout& getPrefabLayout(const PrefabTemplate& prefabTemplate);
+
+	/*! Component IDs in this world, indexed by TypeIndex<Component>. Types this world
+		hasn't seen are invalidComponentId. */
+	std::vector<cid_t> componentIds;
+	static const cid_t invalidComponentId = UINT32_MAX;
+	std::vector<std::unique_ptr<BaseComponentPool>> componentPools;
+
+	/*! Indexed by entityIndex. */
+	std::vector<Entity> entities;
+
+	/*! Scratch space for restore, so that restoring a snapshot over and over doesn't allocate. */
+	std::vector<eid_t> restoredOwners;
 
-	cid_t getComponentId(size_t typeidHash);
-	cid_t registerComponent(size_t typeidHash);
+	/*! Resets the world to no entities at all, forgetting their generations. */
+	void reset();
 
-	std::unordered_map<size_t, cid_t> componentIdMap;
-	std::vector<ComponentPool> entityComponentMaps;
-	std::map<eid_t, Entity> entities;
+	/*! Entities passed to removeEntity which cleanupEntities hasn't destroyed yet. */
+	std::vector<eid_t> pendingDeletions;
+
+	/*! Scratch space for cleanupEntities: the entities to remove from each pool, indexed by
+		component ID. Kept between calls so that cleanup doesn't allocate every frame. */
+	std::vector<std::vector<eid_t>> pendingRemovals;
+
+	/*! Slots of deleted entities, oldest first, starting at freeIndicesHead. Used as a
+		queue; unlike std::deque it keeps its memory as entities come and go. */
+	std::vector<uint32_t> freeIndices;
+	size_t freeIndicesHead;
+
+	/*! Entities whose prefabs are being constructed, innermost last. Their components
+		are attached as the constructors run, but they only join queries once finished. */
+	std::vector<eid_t> constructingEntities;
+
+	bool isConstructing(eid_t entity) const;
+
+	/*! The first slot never handed out by reserveEntity. Reserved slots past the end of
+		entities are only added to it once they are activated. */
+	uint32_t nextUnusedIndex;
+
+	/*! Guards freeIndices and nextUnusedIndex in reserveEntity. */
+	std::mutex reserveMutex;
 
 	cid_t nextComponentId;
-	eid_t nextEntityId;
+
+#ifndef WORLD_STRIP_NAMES
+	/*! An interned name, and the living entities which have it. */
+	struct Name {
+		Name(const std::string& name) : name(name), first(NullEntity), last(NullEntity) { }
+		std::string name;
+		eid_t first;
+		eid_t last;
+	};
+
+	/*! Indexed by nid_t. Names are never forgotten, since a game only uses a handful. */
+	std::vector<Name> names;
+	std::unordered_map<std::string, nid_t> nameIds;
+
+	/*!
+	 \brief Gets the ID of a name, adding it to the table the first time it is seen.
+	 */
+	nid_t internName(const std::string& name);
+
+	/*! Adds an entity to, or removes it from, the list of entities with its name. */
+	void linkName(Entity& entity);
+	void unlinkName(Entity& entity);
+#endif
+
+	/*! Type-erased holder for a resource, so resources of any type can share one array. */
+	struct BaseResource {
+		BaseResource() : version(0) { }
+		virtual ~BaseResource() = default;
+		unsigned long long version;
+	};
+
+	template <class T>
+	struct Resource : public BaseResource {
+		template <class... Args>
+		Resource(Args&&... args) : value(std::forward<Args>(args)...) { }
+		T value;
+	};
+
+	/*! Indexed by TypeIndex<BaseResource>. Unset resources are null. */
+	std::vector<std::unique_ptr<BaseResource>> resources;
+
+	/*! Versions of removed resources, indexed like resources. */
+	std::vector<unsigned long long> removedResourceVersions;
+
+	/*! Source of resource versions, so a version is never handed out twice. */
+	unsigned long long nextResourceVersion;
+
+	/*! Starts at 1, so that components stamped with it are newer than a system which has never updated. */
+	std::atomic<uint32_t> changeTick;
 
 	ComponentBitmask getEntityBitmask(eid_t eid) const;
 };
 
-template <class T>
-cid_t World::registerComponent()
+inline World::Entity* World::getEntity(eid_t entity)
+{
+	uint32_t index = entityIndex(entity);
+	if (index >= entities.size() || entities[index].id != entity || !entities[index].alive) {
+		return nullptr;
+	}
+	return &entities[index];
+}
+
+inline const World::Entity* World::getEntity(eid_t entity) const
+{
+	return const_cast<World*>(this)->getEntity(entity);
+}
+
+inline bool World::isConstructing(eid_t entity) const
 {
-	size_t hash = typeid(T).hash_code();
-	return id;
+	for (eid_t constructing : constructingEntities) {
+		if (constructing == entity) {
+			return true;
+		}
+	}
+	return false;
 }
 
 template <class T>
 cid_t World::getComponentId()
 {
-	size_t hash = typeid(T).hash_code();
-	return getComponentId(hash);
+	uint32_t typeIndex = TypeIndex<Component>::get<T>();
+	if (typeIndex < componentIds.size() && componentIds[typeIndex] != invalidComponentId) {
+		return componentIds[typeIndex];
+	}
+	return registerComponent(typeIndex, &ComponentPool<T>::create);
+}
+
+template <class T>
+ComponentPool<T>& World::getPool()
+{
+	cid_t cid = getComponentId<T>();
+	return static_cast<ComponentPool<T>&>(*this->componentPools[cid]);
 }
 	
 template <class T>
@@ -183,56 +575,166 @@ T* World::addComponent(eid_t entity)
 
 template <class T>
 T* World::getComponent(eid_t entity, bool insert)
+{
+	T* component = getPool<T>().get(entity);
+	if (component == nullptr && insert) {
+		component = emplaceComponent<T>(entity);
+	}
+	return component;
+}
+
+template <class T, class... Args>
+T* World::emplaceComponent(eid_t entity, Args&&... args)
 {
 	cid_t cid = getComponentId<T>();
-	ComponentPool& componentPool = this->entityComponentMaps[cid];
+	ComponentPool<T>& componentPool = static_cast<ComponentPool<T>&>(*this->componentPools[cid]);
 
-	auto iter = componentPool.find(entity);
-	if (iter == componentPool.end()) {
-		if (!insert) {
-			return nullptr;
-		} else {
-			std::unique_ptr<Component> newComponent(static_cast<Component*>(new T()));
-			auto emplaceIter = componentPool.emplace(entity, std::move(newComponent));
-			iter = emplaceIter.first;
+	T* component = componentPool.get(entity);
+	if (component != nullptr) {
+		return component;
+	}
 
-			auto entityIter = entities.find(entity);
-			assert (entityIter != entities.end());
+	Entity* entityData = getEntity(entity);
+	assert (entityData != nullptr);
 
-			entityIter->second.components.setBit(cid, true);
-		}
+	component = componentPool.emplace(entity, std::forward<Args>(args)...);
+	componentPool.setChangeTick(entity, getChangeTick());
+
+	ComponentBitmask oldComponents = entityData->components;
+	entityData->components.setBit(cid, true);
+	if (!isConstructing(entity)) {
+		updateQueries(entity, &oldComponents, &entityData->components);
 	}
 
-	return static_cast<T*>(iter->second.get());
+	return component;
+}
+
+template <class T>
+void World::markChanged(eid_t entity)
+{
+	markChanged<T>(entity, getChangeTick());
+}
+
+template <class T>
+void World::markChanged(eid_t entity, uint32_t tick)
+{
+	getPool<T>().setChangeTick(entity, tick);
+}
+
+template <class T>
+bool World::changedSince(eid_t entity, uint32_t tick)
+{
+	return getPool<T>().getChangeTick(entity) > tick;
+}
+
+inline uint32_t World::getChangeTick() const
+{
+	return changeTick.load(std::memory_order_relaxed);
+}
+
+inline uint32_t World::advanceChangeTick()
+{
+	return changeTick.fetch_add(1);
 }
 
 template <class T>
 void World::removeComponent(eid_t entity)
 {
-	cid_t cid = getComponentId<T>();
-	ComponentPool& componentPool = this->entityComponentMaps[cid];
+	ComponentPool<T>& componentPool = getPool<T>();
 
-	auto iter = componentPool.find(entity);
-	if (iter == componentPool.end()) {
-		componentPool.erase(iter);
+	if (componentPool.has(entity)) {
+		componentPool.remove(entity);
 
-		auto entityIter = entities.find(entity);
-		assert (entityIter != entities.end());
+		Entity* entityData = getEntity(entity);
+		assert (entityData != nullptr);
 
-		entityIter->second.components.setBit(cid, false);
+		ComponentBitmask oldComponents = entityData->components;
+		entityData->components.setBit(getComponentId<T>(), false);
+		updateQueries(entity, &oldComponents, &entityData->components);
 	}
 }
 
 template <class T>
 std::vector<eid_t> World::getEntitiesWithComponent()
 {
-	cid_t cid = getComponentId<T>();
-	ComponentPool& componentPool = this->entityComponentMaps[cid];
-	std::vector<eid_t> entities;
+	return getPool<T>().getEntities();
+}
+
+template <class T>
+Span<const eid_t> World::each()
+{
+	return Span<const eid_t>(getPool<T>().getEntities());
+}
+
+template <class T>
+eid_t World::first()
+{
+	const std::vector<eid_t>& entities = getPool<T>().getEntities();
+	return (entities.empty() ? NullEntity : entities[0]);
+}
+
+template <class T>
+size_t World::count()
+{
+	return getPool<T>().size();
+}
 
-	for (auto iter = componentPool.begin(); iter != componentPool.end(); ++iter) {
-		entities.push_back(iter->first);
+template <class T, class... Args>
+T& World::setResource(Args&&... args)
+{
+	uint32_t index = TypeIndex<BaseResource>::get<T>();
+	if (resources.size() <= index) {
+		resources.resize(index + 1);
+		removedResourceVersions.resize(index + 1, 0);
 	}
-	
-	return entities;
+
+	Resource<T>* resource = new Resource<T>(std::forward<Args>(args)...);
+	resource->version = ++nextResourceVersion;
+	resources[index].reset(resource);
+	return resource->value;
+}
+
+template <class T>
+T* World::resource()
+{
+	uint32_t index = TypeIndex<BaseResource>::get<T>();
+	if (index >= resources.size() || !resources[index]) {
+		return nullptr;
+	}
+	return &static_cast<Resource<T>*>(resources[index].get())->value;
 }
+
+template <class T>
+void World::removeResource()
+{
+	uint32_t index = TypeIndex<BaseResource>::get<T>();
+	if (index < resources.size() && resources[index]) {
+		resources[index].reset();
+		removedResourceVersions[index] = ++nextResourceVersion;
+	}
+}
+
+template <class T>
+void World::markResourceChanged()
+{
+	uint32_t index = TypeIndex<BaseResource>::get<T>();
+	if (index < resources.size() && resources[index]) {
+		resources[index]->version = ++nextResourceVersion;
+	}
+}
+
+template <class T>
+unsigned long long World::getResourceVersion()
+{
+	uint32_t index = TypeIndex<BaseResource>::get<T>();
+	if (index >= resources.size()) {
+		return 0;
+	}
+	return (resources[index] ? resources[index]->version : removedResourceVersions[index]);
+}
+
+template <class... Ts>
+View<Ts...> World::view()
+{
+	return View<Ts...>(getPool<Ts>()...);
+}
\ No newline at end of file
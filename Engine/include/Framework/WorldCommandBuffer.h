@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Framework/World.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+
+/*! Records changes to a world's entities and components, and applies them later in
+	one pass with playback. Systems use this to create and delete entities and to add
+	and remove components without disturbing the entity lists they are iterating.
+
+	Entities created through the buffer get their IDs straight away, so later commands
+	(and other components) can refer to them, but they don't exist in the world until
+	playback. Several buffers may record on different threads at once, as long as
+	nothing changes the world while they do. */
+class WorldCommandBuffer
+{
+public:
+	WorldCommandBuffer(World& world);
+	~WorldCommandBuffer();
+
+	WorldCommandBuffer(const WorldCommandBuffer&) = delete;
+	WorldCommandBuffer& operator=(const WorldCommandBuffer&) = delete;
+
+	/*!
+	 * \brief Records the creation of an empty entity.
+	 * \return The ID the entity will have once the buffer is played back.
+	 */
+	eid_t createEntity(const std::string& name = "");
+
+	/*!
+	 * \brief Records the construction of a prefab. See World::constructPrefab.
+	 * The prefab, and userinfo if given, must stay alive until playback.
+	 * \return The ID the entity will have once the buffer is played back.
+	 */
+	eid_t constructPrefab(const Prefab& prefab, eid_t parent = World::NullEntity, void* userinfo = nullptr);
+
+	/*!
+	 * \brief Records the deletion of an entity. See World::removeEntity.
+	 */
+	void removeEntity(eid_t entity);
+
+	/*!
+	 * \brief Records adding a component to an entity. The component is default-constructed
+	 * now, in a pool kept by the buffer, and can be filled in through the returned reference
+	 * until playback moves it into the world. If the entity already has a component of the
+	 * type at playback, the new component is dropped.
+	 */
+	template <class T>
+	T& addComponent(eid_t entity);
+
+	/*!
+	 * \brief Records removing a component from an entity.
+	 */
+	template <class T>
+	void removeComponent(eid_t entity);
+
+	/*!
+	 * \brief Applies every recorded command in the order it was recorded, then empties the buffer.
+	 * Pools are grown once for all of the components being added, and each entity's cached
+	 * queries are updated once no matter how many of its components changed. Commands on
+	 * entities which have been deleted by the time of playback are skipped.
+	 */
+	void playback();
+
+	/*!
+	 * \brief Checks if there are commands waiting for playback.
+	 */
+	bool empty() const;
+private:
+	enum class CommandType { CreateEntity, ConstructPrefab, RemoveEntity, AddComponent, RemoveComponent };
+
+	struct Command
+	{
+		CommandType type;
+		eid_t entity;
+
+		/*! For CreateEntity, an index into names. For ConstructPrefab, an index into prefabs.
+			For AddComponent, the key of the staged component in its staging pool. */
+		size_t argument;
+
+		/*! The component's TypeIndex, for AddComponent and RemoveComponent. Component IDs are
+			only looked up on playback, since registering a type isn't safe while recording. */
+		uint32_t typeIndex;
+		World::PoolFactory createPool;
+
+		/*! Where the component to add is staged, for AddComponent. */
+		BaseComponentPool* staging;
+	};
+
+	struct PrefabArguments
+	{
+		const Prefab* prefab;
+		eid_t parent;
+		void* userinfo;
+	};
+
+	/*! An entity whose components changed during playback, and what they were before. */
+	struct PendingQueryUpdate
+	{
+		eid_t entity;
+		bool created;
+		ComponentBitmask oldComponents;
+	};
+
+	/*! Gets the pool staging components of a type, creating it the first time. */
+	BaseComponentPool& getStagingPool(uint32_t typeIndex, World::PoolFactory createPool);
+
+	World& world;
+
+	/*! Kept small and trivially copyable, since a busy frame records a lot of these. */
+	std::vector<Command> commands;
+	std::vector<std::string> names;
+	std::vector<PrefabArguments> prefabs;
+
+	/*! Components waiting to be added, indexed by TypeIndex<Component>. They are keyed by their order within
+		the pool rather than by entity, and the pools are only cleared on playback, so once
+		they have grown, recording doesn't allocate. */
+	std::vector<std::unique_ptr<BaseComponentPool>> stagingPools;
+
+	/*! Scratch space for playback, kept between calls so their memory is reused. */
+	std::vector<cid_t> cids;
+	std::vector<size_t> additions;
+	std::vector<PendingQueryUpdate> pending;
+	/*! Entity slots which already have a pending query update, indexed by entityIndex. */
+	std::vector<bool> isPending;
+};
+
+template <class T>
+T& WorldCommandBuffer::addComponent(eid_t entity)
+{
+	uint32_t typeIndex = TypeIndex<Component>::get<T>();
+	ComponentPool<T>& staging = static_cast<ComponentPool<T>&>(getStagingPool(typeIndex, &ComponentPool<T>::create));
+
+	size_t key = staging.size();
+	commands.push_back(Command{ CommandType::AddComponent, entity, key, typeIndex, &ComponentPool<T>::create, &staging });
+	return *staging.emplace((eid_t)key);
+}
+
+template <class T>
+void WorldCommandBuffer::removeComponent(eid_t entity)
+{
+	commands.push_back(Command{ CommandType::RemoveComponent, entity, 0, TypeIndex<Component>::get<T>(), &ComponentPool<T>::create, nullptr });
+}
\ No newline at end of file
@@ -1,87 +1,466 @@
 #pragma once
 
-#include <unordered_map>
-#include <memory>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <utility>
+#include <vector>
 
 #include "Optional.h"
 
+/*! Type-erased half of a HandlePool. Holds the table of slots which handles index, and
+	the reference counts of ref-counted handles, so that handles can be copied and
+	destroyed where the pool's object type is incomplete. It is shared by the pool and its
+	handles, and deletes itself once the pool and every handle are gone. */
+class HandleTable
+{
+public:
+	struct Slot
+	{
+		/*! Where the slot's object is in the pool's dense array, or UINT32_MAX if it has none. */
+		uint32_t dense;
+		/*! Bumped whenever the slot's object is removed, so that old handles stop matching. */
+		uint32_t generation;
+		/*! The number of ref-counted handles to the slot. It isn't reused until this drops to 0. */
+		uint32_t references;
+	};
+
+	HandleTable() : handleCount(0), poolAlive(true) { }
+	virtual ~HandleTable() { }
+
+	HandleTable(const HandleTable&) = delete;
+	HandleTable& operator=(const HandleTable&) = delete;
+
+	void addReference(uint32_t index);
+
+	/*!
+	 * \brief Drops a reference to a slot, removing its object if it was the last one.
+	 */
+	void releaseReference(uint32_t index);
+
+	/*!
+	 * \brief Called by the pool as it is destroyed. Destroys the objects now, and the
+	 * table once no handles refer to it.
+	 */
+	void releasePool();
+
+	std::vector<Slot> slots;
+protected:
+	/*!
+	 * \brief Returns a free slot, with no object and no references, growing the table if need be.
+	 */
+	uint32_t allocateSlot();
+
+	/*!
+	 * \brief Marks a slot's object as removed, and frees the slot if nothing refers to it.
+	 */
+	void vacateSlot(uint32_t index);
+
+	/*!
+	 * \brief Removes the object in a slot, which must have one, and vacates the slot.
+	 */
+	virtual void eraseObject(uint32_t index) = 0;
+
+	virtual void clearObjects() = 0;
+
+	std::vector<uint32_t> freeSlots;
+	/*! The ref-counted handles to any slot. */
+	size_t handleCount;
+	bool poolAlive;
+};
+
+/*! What happens to the order of the objects in a HandlePool when one is removed. */
+enum HandlePoolOrder
+{
+	/*! The last object is moved into the hole. Removal takes constant time. */
+	HandlePoolOrder_Unordered,
+
+	/*! The objects after it are shifted down, so the rest stay in the order they were
+		added or last sorted in. Removal takes linear time. */
+	HandlePoolOrder_Stable,
+};
+
+/*! Stores objects in one dense array, and hands out generational handles to them. A
+	handle is the index of a slot, which says where its object is in the array, plus the
+	generation the slot was on when the object was added. Removing an object bumps the
+	generation, so stale handles find nothing rather than another object, and looking one
+	up is two array reads. Objects move when others are removed or the pool is sorted, so
+	references and iterators into the pool are only good until the next insertion,
+	removal or sort.
+
+	Iteration walks the array, so it touches memory in order. New objects go at the end,
+	and removals either keep the order or move the last object into the hole, depending
+	on the HandlePoolOrder. sort rearranges the array in place, so that whoever iterates
+	the pool can have it in the order they want to process it in.
+
+	WeakHandles are plain values which keep nothing alive; objects added with insert stay
+	until they are erased. Handles, from getNewHandle, are reference counted, and their
+	object is removed when the last copy goes away. Objects can be erased while Handles
+	still refer to them, which then find nothing. Handles of either kind may outlive the
+	pool. Neither the pool nor its handles are thread safe. */
 template <class T>
 class HandlePool
 {
+	class Storage;
 public:
-	HandlePool() : nextHandle(0), pool(new Pool), deleter(pool) { }
-	struct HandleData {
-		HandleData(uint32_t handle) : handle(handle) { }
-		uint32_t handle;
+	struct WeakHandle
+	{
+		WeakHandle() : index(UINT32_MAX), generation(0) { }
+		WeakHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) { }
+
+		bool operator==(const WeakHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const WeakHandle& other) const { return !(*this == other); }
+
+		uint32_t index;
+		uint32_t generation;
+	};
+
+	/*! A reference-counted handle. Null when default constructed or assigned nullptr. */
+	class Handle
+	{
+	public:
+		Handle() : table(nullptr) { }
+		Handle(std::nullptr_t) : table(nullptr) { }
+		Handle(const Handle& other);
+		Handle(Handle&& other);
+		Handle& operator=(const Handle& other);
+		Handle& operator=(Handle&& other);
+		~Handle();
+
+		/*!
+		 * \brief Drops this reference, leaving the handle null.
+		 */
+		void reset();
+
+		WeakHandle getWeakHandle() const { return weak; }
+
+		explicit operator bool() const { return table != nullptr; }
+		bool operator==(const Handle& other) const { return table == other.table && (table == nullptr || weak == other.weak); }
+		bool operator!=(const Handle& other) const { return !(*this == other); }
+	private:
+		friend class HandlePool;
+		Handle(HandleTable* table, WeakHandle weak) : table(table), weak(weak) { }
+
+		HandleTable* table;
+		WeakHandle weak;
 	};
 
-	using Pool = std::unordered_map<uint32_t, T>;
-	using Handle = std::shared_ptr<HandleData>;
-	using WeakHandle = std::weak_ptr<HandleData>;
+	using iterator = typename std::vector<T>::iterator;
+
+	HandlePool(HandlePoolOrder order = HandlePoolOrder_Unordered);
+	~HandlePool();
+
+	HandlePool(const HandlePool&) = delete;
+	HandlePool& operator=(const HandlePool&) = delete;
+
+	/*!
+	 * \brief Adds an object, which stays until the last copy of the returned handle is gone.
+	 */
+	Handle getNewHandle(const T& obj);
 
-	typename Handle getNewHandle(const T& obj);
-	typename Pool::iterator begin();
-	typename Pool::iterator end();
-	std::experimental::optional<std::reference_wrapper<T>> get(Handle handle);
+	/*!
+	 * \brief Adds an object, which stays until it is erased.
+	 */
+	WeakHandle insert(const T& obj);
+
+	/*!
+	 * \brief Removes an object now, if the handle still refers to one. Handles to it,
+	 * ref-counted or not, then find nothing.
+	 */
+	void erase(WeakHandle handle);
+	void erase(const Handle& handle);
+
+	std::experimental::optional<std::reference_wrapper<T>> get(WeakHandle handle);
+	std::experimental::optional<std::reference_wrapper<T>> get(const Handle& handle);
+
+	/*!
+	 * \brief Iterates over the objects in the order they are stored in. See HandlePoolOrder and sort.
+	 */
+	iterator begin();
+	iterator end();
+	size_t size() const;
+
+	/*!
+	 * \brief Stably sorts the objects in place, by a comparator callable as
+	 * bool(const T&, const T&). Handles keep referring to the same objects.
+	 */
+	template <class Compare>
+	void sort(Compare compare);
+
+	/*!
+	 * \brief Checks if the objects are still in the order the last sort left them in,
+	 * meaning none have been added since, nor removed from an unordered pool. Lets a
+	 * caller whose sort key doesn't change only sort when objects come and go.
+	 */
+	bool isSorted() const;
 
 	const static Handle invalidHandle;
 private:
-	class HandleDeleter {
+	class Storage : public HandleTable
+	{
 	public:
-		HandleDeleter(const std::shared_ptr<Pool> pool) : pool(pool) { }
-		void operator() (HandleData* handle) const;
-		std::weak_ptr<Pool> pool;
+		Storage(HandlePoolOrder order) : order(order), sorted(false) { }
+
+		WeakHandle insert(const T& obj);
+		T* find(WeakHandle handle);
+
+		virtual void eraseObject(uint32_t index);
+		virtual void clearObjects();
+
+		std::vector<T> objects;
+		/*! The slot of each object, indexed like objects. */
+		std::vector<uint32_t> objectSlots;
+
+		/*! Where each object goes during a sort. Kept to reuse its memory. */
+		std::vector<uint32_t> sortOrder;
+
+		HandlePoolOrder order;
+		bool sorted;
 	};
-	uint32_t nextHandle;
-	std::shared_ptr<Pool> pool;
-	HandleDeleter deleter;
+
+	Storage* storage;
 };
 
-template<class T>
-const typename HandlePool<T>::Handle HandlePool<T>::invalidHandle(std::make_shared<typename HandlePool<T>::HandleData>(UINT32_MAX));
+template <class T>
+const typename HandlePool<T>::Handle HandlePool<T>::invalidHandle;
 
 template <class T>
-typename HandlePool<T>::Handle HandlePool<T>::getNewHandle(const T& obj)
+HandlePool<T>::Handle::Handle(const Handle& other)
+	: table(other.table), weak(other.weak)
 {
-	this->pool->emplace(this->nextHandle, obj);
-	HandlePool<T>::Handle handle(new HandlePool<T>::HandleData(this->nextHandle), deleter);
-	this->nextHandle++;
-	return handle;
+	if (table != nullptr) {
+		table->addReference(weak.index);
+	}
 }
 
 template <class T>
-void HandlePool<T>::HandleDeleter::operator() (typename HandlePool<T>::HandleData* handle) const
+HandlePool<T>::Handle::Handle(Handle&& other)
+	: table(other.table), weak(other.weak)
 {
-	if (!this->pool.expired()) {
-		this->pool.lock()->erase(handle->handle);
+	other.table = nullptr;
+}
+
+template <class T>
+typename HandlePool<T>::Handle& HandlePool<T>::Handle::operator=(const Handle& other)
+{
+	// Reference the new slot first, in case both are the last reference to the same one
+	if (other.table != nullptr) {
+		other.table->addReference(other.weak.index);
+	}
+	reset();
+	table = other.table;
+	weak = other.weak;
+	return *this;
+}
+
+template <class T>
+typename HandlePool<T>::Handle& HandlePool<T>::Handle::operator=(Handle&& other)
+{
+	if (this != &other) {
+		reset();
+		table = other.table;
+		weak = other.weak;
+		other.table = nullptr;
 	}
-	delete handle;
+	return *this;
+}
+
+template <class T>
+HandlePool<T>::Handle::~Handle()
+{
+	reset();
 }
 
-template<class T>
-typename HandlePool<T>::Pool::iterator HandlePool<T>::begin()
+template <class T>
+void HandlePool<T>::Handle::reset()
 {
-	return this->pool->begin();
+	if (table != nullptr) {
+		HandleTable* released = table;
+		table = nullptr;
+		released->releaseReference(weak.index);
+	}
 }
 
 template <class T>
-typename HandlePool<T>::Pool::iterator HandlePool<T>::end()
+HandlePool<T>::HandlePool(HandlePoolOrder order)
+	: storage(new Storage(order))
+{ }
+
+template <class T>
+HandlePool<T>::~HandlePool()
 {
-	return this->pool->end();
+	storage->releasePool();
 }
 
 template <class T>
-std::experimental::optional<std::reference_wrapper<T>> HandlePool<T>::get(Handle handle)
+typename HandlePool<T>::Handle HandlePool<T>::getNewHandle(const T& obj)
 {
-	if (handle == nullptr || handle == invalidHandle) {
+	WeakHandle weak = storage->insert(obj);
+	storage->addReference(weak.index);
+	return Handle(storage, weak);
+}
+
+template <class T>
+typename HandlePool<T>::WeakHandle HandlePool<T>::insert(const T& obj)
+{
+	return storage->insert(obj);
+}
+
+template <class T>
+void HandlePool<T>::erase(WeakHandle handle)
+{
+	if (storage->find(handle) != nullptr) {
+		storage->eraseObject(handle.index);
+	}
+}
+
+template <class T>
+void HandlePool<T>::erase(const Handle& handle)
+{
+	if (handle.table == storage) {
+		erase(handle.weak);
+	}
+}
+
+template <class T>
+std::experimental::optional<std::reference_wrapper<T>> HandlePool<T>::get(WeakHandle handle)
+{
+	T* object = storage->find(handle);
+	if (object == nullptr) {
 		return std::experimental::optional<std::reference_wrapper<T>>();
 	}
+	return std::experimental::optional<std::reference_wrapper<T>>(*object);
+}
 
-	auto iter = this->pool->find(handle->handle);
-	if (iter == this->pool->end()) {
+template <class T>
+std::experimental::optional<std::reference_wrapper<T>> HandlePool<T>::get(const Handle& handle)
+{
+	if (handle.table != storage) {
 		return std::experimental::optional<std::reference_wrapper<T>>();
 	}
+	return get(handle.weak);
+}
+
+template <class T>
+typename HandlePool<T>::iterator HandlePool<T>::begin()
+{
+	return storage->objects.begin();
+}
+
+template <class T>
+typename HandlePool<T>::iterator HandlePool<T>::end()
+{
+	return storage->objects.end();
+}
+
+template <class T>
+size_t HandlePool<T>::size() const
+{
+	return storage->objects.size();
+}
 
-	return std::experimental::optional<std::reference_wrapper<T>>(iter->second);
+template <class T>
+template <class Compare>
+void HandlePool<T>::sort(Compare compare)
+{
+	std::vector<T>& objects = storage->objects;
+	std::vector<uint32_t>& objectSlots = storage->objectSlots;
+	std::vector<uint32_t>& sortOrder = storage->sortOrder;
+
+	// Sort indices rather than the objects, so that each object only moves once
+	sortOrder.resize(objects.size());
+	for (uint32_t i = 0; i < sortOrder.size(); i++) {
+		sortOrder[i] = i;
+	}
+	std::stable_sort(sortOrder.begin(), sortOrder.end(), [&objects, &compare](uint32_t a, uint32_t b) {
+		return compare(objects[a], objects[b]);
+	});
+
+	// Object sortOrder[i] goes to i. Follow each cycle of the permutation, moving every
+	// object in it into place with one temporary.
+	for (uint32_t start = 0; start < sortOrder.size(); start++) {
+		if (sortOrder[start] == start) {
+			continue;
+		}
+
+		T object(std::move(objects[start]));
+		uint32_t slot = objectSlots[start];
+		uint32_t current = start;
+		while (sortOrder[current] != start) {
+			uint32_t next = sortOrder[current];
+			objects[current] = std::move(objects[next]);
+			objectSlots[current] = objectSlots[next];
+			sortOrder[current] = current;
+			current = next;
+		}
+		objects[current] = std::move(object);
+		objectSlots[current] = slot;
+		sortOrder[current] = current;
+	}
+
+	for (uint32_t i = 0; i < objectSlots.size(); i++) {
+		storage->slots[objectSlots[i]].dense = i;
+	}
+	storage->sorted = true;
+}
+
+template <class T>
+bool HandlePool<T>::isSorted() const
+{
+	return storage->sorted;
+}
+
+template <class T>
+typename HandlePool<T>::WeakHandle HandlePool<T>::Storage::insert(const T& obj)
+{
+	sorted = false;
+	uint32_t index = allocateSlot();
+	objects.push_back(obj);
+	objectSlots.push_back(index);
+	slots[index].dense = (uint32_t)objects.size() - 1;
+	return WeakHandle(index, slots[index].generation);
+}
+
+template <class T>
+T* HandlePool<T>::Storage::find(WeakHandle handle)
+{
+	// Free and vacated slots are a generation ahead of any handle to them
+	if (handle.index >= slots.size() || slots[handle.index].generation != handle.generation) {
+		return nullptr;
+	}
+	return &objects[slots[handle.index].dense];
+}
+
+template <class T>
+void HandlePool<T>::Storage::eraseObject(uint32_t index)
+{
+	uint32_t dense = slots[index].dense;
+	uint32_t last = (uint32_t)objects.size() - 1;
+	vacateSlot(index);
+
+	// Take the object out before destroying it, in case it holds handles into this pool
+	T removed(std::move(objects[dense]));
+	if (order == HandlePoolOrder_Stable) {
+		for (uint32_t i = dense; i < last; i++) {
+			objects[i] = std::move(objects[i + 1]);
+			objectSlots[i] = objectSlots[i + 1];
+			slots[objectSlots[i]].dense = i;
+		}
+	} else if (dense != last) {
+		objects[dense] = std::move(objects[last]);
+		objectSlots[dense] = objectSlots[last];
+		slots[objectSlots[dense]].dense = dense;
+		sorted = false;
+	}
+	objects.pop_back();
+	objectSlots.pop_back();
+}
+
+template <class T>
+void HandlePool<T>::Storage::clearObjects()
+{
+	std::vector<T> removed;
+	removed.swap(objects);
+	objectSlots.clear();
 }
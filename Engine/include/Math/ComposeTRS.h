@@ -0,0 +1,18 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+
+/*!
+ * \brief Builds the matrix translate(position) * toMat4(rotation) * scale(scale) for each of
+ * count transforms, without multiplying any matrices together. The results are the same as
+ * the three matrix products, since every other term in them is a multiplication by 0 or 1.
+ * Uses SSE2 four transforms at a time where it's available.
+ * \param positions Array of count positions.
+ * \param rotations Array of count normalized rotations.
+ * \param scales Array of count scales.
+ * \param out Array of count matrices to write to. May not overlap the inputs.
+ */
+void composeTRS(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count);
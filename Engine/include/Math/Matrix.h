@@ -2,23 +2,38 @@
 
 #include <glm/glm.hpp>
 
-struct mat4
-{
-	/*float m11, m12, m13, m14;
-	float m21, m22, m23, m24;
-	float m31, m32, m33, m34;
-	float m41, m42, m43, m44;*/
-	float m11, m21, m31, m41;
-	float m12, m22, m32, m42;
-	float m13, m23, m33, m43;
-	float m14, m24, m34, m44;
-
-	mat4 operator*(const mat4 other);
-	mat4(const glm::mat4& matrix);
-	mat4();
-	mat4(float m11, float m21, float m31, float m41,
-		float m12, float m22, float m32, float m42,
-		float m13, float m23, float m33, float m43,
-		float m14, float m24, float m34, float m44);
-	glm::mat4 toGlm();
-};
+#include <cstddef>
+
+/*! Matrix kernels for the animation hot path. They work in place on glm::mat4, which is
+	sixteen column-major floats, so there's nothing to convert on the way in or out.
+	The instruction set is picked when building: AVX, then SSE2, then NEON, falling
+	back to plain C++. Every path adds up the same products in the same order as glm's
+	own operator*, so results don't depend on which one was built. */
+
+/*!
+ * \brief Sets out to a * b. out may be the same matrix as a or b.
+ */
+void mat4Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out);
+
+/*!
+ * \brief Returns a * b.
+ */
+glm::mat4 mat4Multiply(const glm::mat4& a, const glm::mat4& b);
+
+/*!
+ * \brief Adds a * b to accumulator, as when blending weighted transforms. accumulator may
+ * not be the same matrix as a or b.
+ */
+void mat4MultiplyAdd(const glm::mat4& a, const glm::mat4& b, glm::mat4& accumulator);
+
+/*!
+ * \brief Inverts an affine matrix, one whose bottom row is 0 0 0 1, such as any composition
+ * of translations, rotations and scales. Much cheaper than glm::inverse, but the result is
+ * meaningless for projections.
+ */
+glm::mat4 mat4AffineInverse(const glm::mat4& matrix);
+
+/*!
+ * \brief Sets out[i] to a * b[i] for count matrices. out may be the same array as b.
+ */
+void mat4MultiplyBatch(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count);
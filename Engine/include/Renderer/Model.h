@@ -135,6 +135,13 @@ struct Model
 	/*! Cached transforms returned from getNodeTransforms. */
 	std::vector<glm::mat4> nodeTransforms;
 
+	/*! Scratch space for getNodeTransforms: the animated nodes, in order, and their local transforms. */
+	std::vector<unsigned> animatedNodes;
+	std::vector<glm::vec3> animatedPositions;
+	std::vector<glm::quat> animatedRotations;
+	std::vector<glm::vec3> animatedScales;
+	std::vector<glm::mat4> animatedTransforms;
+
 	Model();
 	Model(const Mesh& mesh, const Material& material);
 	Model(const Mesh& mesh, const Material& material, const AnimationData& animationData);
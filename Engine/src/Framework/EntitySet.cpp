@@ -0,0 +1,65 @@
+
+#include "Framework/EntitySet.h"
+
+#include <algorithm>
+#include <cassert>
+
+const uint32_t EntitySet::invalidIndex;
+const uint32_t EntitySet::sparsePageSize;
+
+uint32_t EntitySet::insert(eid_t entity)
+{
+	// Another generation of the same slot would share our sparse entry
+	assert(slotIndex(entity) == invalidIndex);
+
+	uint32_t index = (uint32_t)dense.size();
+	dense.push_back(entity);
+	setIndex(entity, index);
+	return index;
+}
+
+void EntitySet::erase(eid_t entity)
+{
+	uint32_t index = indexOf(entity);
+	if (index == invalidIndex) {
+		return;
+	}
+
+	eid_t last = dense.back();
+	dense[index] = last;
+	setIndex(last, index);
+
+	dense.pop_back();
+	setIndex(entity, invalidIndex);
+}
+
+void EntitySet::clear()
+{
+	for (eid_t entity : dense) {
+		setIndex(entity, invalidIndex);
+	}
+	dense.clear();
+}
+
+void EntitySet::reserve(size_t count)
+{
+	dense.reserve(count);
+}
+
+void EntitySet::setIndex(eid_t entity, uint32_t index)
+{
+	uint32_t slot = entityIndex(entity);
+	uint32_t page = slot / sparsePageSize;
+	if (page >= sparse.size() || !sparse[page]) {
+		if (index == invalidIndex) {
+			return;
+		}
+		if (page >= sparse.size()) {
+			sparse.resize(page + 1);
+		}
+		sparse[page].reset(new uint32_t[sparsePageSize]);
+		std::fill(sparse[page].get(), sparse[page].get() + sparsePageSize, invalidIndex);
+	}
+
+	sparse[page][slot % sparsePageSize] = index;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+
+#include "Framework/EventManager.h"
+
+EventSubscription::EventSubscription(EventSubscription&& other)
+	: eventManager(other.eventManager), eventid(other.eventid), listenerId(other.listenerId), batch(other.batch)
+{
+	other.eventManager = nullptr;
+}
+
+EventSubscription& EventSubscription::operator=(EventSubscription&& other)
+{
+	if (this != &other) {
+		reset();
+		eventManager = other.eventManager;
+		eventid = other.eventid;
+		listenerId = other.listenerId;
+		batch = other.batch;
+		other.eventManager = nullptr;
+	}
+	return *this;
+}
+
+EventSubscription::~EventSubscription()
+{
+	reset();
+}
+
+void EventSubscription::reset()
+{
+	if (eventManager != nullptr) {
+		eventManager->unsubscribe(eventid, listenerId, batch);
+		eventManager = nullptr;
+	}
+}
+
+bool EventSubscription::isActive() const
+{
+	return eventManager != nullptr;
+}
+
+void EventManager::unsubscribe(eventid_t eventid, uint32_t listenerId, bool batch)
+{
+	eventTypes[eventid]->removeListener(listenerId, batch);
+}
+
+void EventManager::dispatchEvents()
+{
+	for (eventid_t eventid = 0; eventid < eventTypes.size(); eventid++) {
+		if (eventTypes[eventid]) {
+			eventTypes[eventid]->drainChannel();
+		}
+	}
+
+	// Listeners may queue more events, which go around again, so keep going until none are left
+	bool dispatched = true;
+	while (dispatched) {
+		dispatched = false;
+		for (eventid_t eventid = 0; eventid < eventTypes.size(); eventid++) {
+			if (eventTypes[eventid]) {
+				dispatched |= eventTypes[eventid]->dispatchQueued();
+			}
+		}
+	}
+}
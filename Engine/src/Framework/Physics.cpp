@@ -50,7 +50,9 @@ void Physics::fixedUpdate(btDynamicsWorld* world, float timeStep)
 		PhysicsContact& contact = contacts[std::make_pair(emin, emax)];
 
 		if (contact.lastContactFrame != currentFrame-1) {
-			this->handleContact(e1, e2, contactManifold, CollisionResponseType_Began);
+			contact.flagsMin = (e1 == emin ? obA : obB)->getCollisionFlags();
+			contact.flagsMax = (e1 == emin ? obB : obA)->getCollisionFlags();
+			this->handleContact(e1, e2, obA, obB, obA->getCollisionFlags(), obB->getCollisionFlags(), contactManifold, CollisionResponseType_Began);
 		}
 
 		contact.lastContactFrame = currentFrame;
@@ -64,7 +66,8 @@ void Physics::fixedUpdate(btDynamicsWorld* world, float timeStep)
 		PhysicsContact& contact = iter->second;
 
 		if (contact.lastContactFrame == currentFrame-1) {
-			this->handleContact(e1, e2, contact.contactManifold, CollisionResponseType_Ended);
+			// Either entity may have died, taking its body with it, so only what was kept is passed on
+			this->handleContact(e1, e2, nullptr, nullptr, contact.flagsMin, contact.flagsMax, nullptr, CollisionResponseType_Ended);
 		}
 
 		if (currentFrame - contact.lastContactFrame >= framesBeforeUncaching) {
@@ -75,14 +78,19 @@ void Physics::fixedUpdate(btDynamicsWorld* world, float timeStep)
 	}
 }
 
-void Physics::handleContact(eid_t e1, eid_t e2, btPersistentManifold* contactManifold, CollisionResponseType type)
+void Physics::handleContact(eid_t e1, eid_t e2, const btCollisionObject* body1, const btCollisionObject* body2, int flags1, int flags2, btPersistentManifold* contactManifold, CollisionResponseType type)
 {
+	// This runs in the middle of Bullet's step, so responders hear about it afterwards
 	CollisionEvent event;
 	event.e1 = e1;
 	event.e2 = e2;
+	event.body1 = body1;
+	event.body2 = body2;
+	event.flags1 = flags1;
+	event.flags2 = flags2;
 	event.collisionManifold = contactManifold;
 	event.type = type;
-	eventManager.sendEvent(event);
+	eventManager.queueEvent(event);
 }
 
 btPersistentManifold* Physics::getContact(eid_t e1, eid_t e2)
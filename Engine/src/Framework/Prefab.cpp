@@ -11,22 +11,28 @@ Prefab::Prefab(const std::string& name)
 void Prefab::addConstructor(ComponentConstructor* constructor)
 {
 	constructors.push_back(std::shared_ptr<ComponentConstructor>(constructor));
+	compiled.reset();
 }
 
-std::vector<ComponentConstructorInfo> Prefab::construct(World& world, eid_t parent, void* userinfo) const
+void Prefab::finish(World& world, eid_t entity) const
 {
-	std::vector<ComponentConstructorInfo> infos;
 	for (unsigned i = 0; i < constructors.size(); i++) {
-		infos.emplace_back(constructors[i]->construct(world, parent, userinfo));
+		constructors[i]->finish(world, entity);
 	}
-	return infos;
 }
 
-void Prefab::finish(World& world, eid_t entity) const
+const PrefabTemplate& Prefab::getTemplate() const
 {
-	for (unsigned i = 0; i < constructors.size(); i++) {
-		constructors[i]->finish(world, entity);
+	if (!compiled) {
+		std::shared_ptr<PrefabTemplate> prefabTemplate = std::make_shared<PrefabTemplate>(name);
+		for (unsigned i = 0; i < constructors.size(); i++) {
+			if (!constructors[i]->compile(*prefabTemplate)) {
+				prefabTemplate->addConstructor(constructors[i]);
+			}
+		}
+		compiled = prefabTemplate;
 	}
+	return *compiled;
 }
 
 void Prefab::addChild(const std::shared_ptr<Prefab>& prefab)
@@ -34,7 +40,7 @@ void Prefab::addChild(const std::shared_ptr<Prefab>& prefab)
 	this->childPrefabs.push_back(prefab);
 }
 
-std::vector<std::shared_ptr<Prefab>> Prefab::getChildPrefabs() const
+const std::vector<std::shared_ptr<Prefab>>& Prefab::getChildPrefabs() const
 {
 	return childPrefabs;
 }
@@ -42,6 +48,7 @@ std::vector<std::shared_ptr<Prefab>> Prefab::getChildPrefabs() const
 void Prefab::setName(const std::string& name)
 {
 	this->name = name;
+	compiled.reset();
 }
 
 std::string Prefab::getName() const
@@ -0,0 +1,63 @@
+
+#include "Framework/PrefabTemplate.h"
+
+#include "Framework/ComponentConstructor.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+	std::atomic<uint32_t> nextTemplateId(0);
+}
+
+PrefabTemplate::PrefabTemplate(const std::string& name)
+	: data(nullptr), size(0), capacity(0), id(nextTemplateId++), name(name)
+{ }
+
+PrefabTemplate::~PrefabTemplate()
+{
+	for (const Entry& entry : entries) {
+		entry.destroy(data + entry.offset);
+	}
+	::operator delete(data);
+}
+
+void PrefabTemplate::addConstructor(const std::shared_ptr<ComponentConstructor>& constructor)
+{
+	constructors.push_back(constructor);
+}
+
+void PrefabTemplate::construct(World& world, eid_t entity, eid_t parent, void* userinfo) const
+{
+	for (unsigned i = 0; i < constructors.size(); i++) {
+		constructors[i]->construct(world, entity, parent, userinfo);
+	}
+}
+
+uint32_t PrefabTemplate::getId() const
+{
+	return id;
+}
+
+const std::string& PrefabTemplate::getName() const
+{
+	return name;
+}
+
+size_t PrefabTemplate::allocate(size_t bytes, size_t alignment)
+{
+	size_t offset = (size + alignment - 1) / alignment * alignment;
+	if (offset + bytes > capacity) {
+		size_t newCapacity = std::max(capacity * 2, offset + bytes);
+		char* newData = static_cast<char*>(::operator new(newCapacity));
+		for (const Entry& entry : entries) {
+			entry.relocate(data + entry.offset, newData + entry.offset);
+		}
+		::operator delete(data);
+		data = newData;
+		capacity = newCapacity;
+	}
+	size = offset + bytes;
+	return offset;
+}
@@ -1,16 +1,170 @@
 
 #include "Framework/System.h"
 
+#include <algorithm>
+
 System::System(World& world)
-	: world(world)
-{ }
+	: world(world), declaredAccess(false), scheduled(false), lastUpdateTick(0), currentUpdateTick(0),
+	skippedEntities(0), workerPool(nullptr), grainSize(64)
+{
+	commandBuffers.emplace_back(new WorldCommandBuffer(world));
+}
 
 void System::update(float dt)
 {
-	entityIterator = world.getEidIterator(requiredComponents);
-	while(!entityIterator.atEnd())
+	beginUpdate();
+
+	if (isParallel()) {
+		const std::vector<eid_t>& entities = world.getEntitiesMatching(requiredComponents);
+		updateParallel(entities.size(), [this, dt, &entities](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				updateEntity(dt, entities[i]);
+			}
+		});
+		playbackCommands();
+		return;
+	}
+
+	// Walk backwards, so that entities which drop out of the list during the update
+	// are swapped for ones we've already visited
+	const std::vector<eid_t>& entities = world.getEntitiesMatching(requiredComponents);
+	for (size_t i = entities.size(); i > 0; i--)
 	{
-		updateEntity(dt, entityIterator.value());
-		entityIterator.next();
+		if (i > entities.size()) {
+			i = entities.size();
+			if (i == 0) {
+				break;
+			}
+		}
+		updateEntity(dt, entities[i - 1]);
 	}
+	playbackCommands();
+}
+
+void System::beginUpdate()
+{
+	lastUpdateTick = currentUpdateTick;
+	currentUpdateTick = world.advanceChangeTick();
+	skippedEntities = 0;
+}
+
+uint32_t System::getLastUpdateTick() const
+{
+	return lastUpdateTick;
+}
+
+void System::skipEntity()
+{
+	skippedEntities.fetch_add(1, std::memory_order_relaxed);
+}
+
+void System::skipEntities(size_t count)
+{
+	skippedEntities.fetch_add(count, std::memory_order_relaxed);
+}
+
+size_t System::getSkippedEntities() const
+{
+	return skippedEntities;
+}
+
+void System::updateParallel(size_t count, const std::function<void(size_t, size_t)>& updateRange)
+{
+	if (workerPool == nullptr || count <= grainSize) {
+		updateRange(0, count);
+		return;
+	}
+
+	workerPool->parallelFor(count, grainSize, updateRange);
+}
+
+void System::setParallel(WorkerPool* workerPool, size_t grainSize)
+{
+	flushCommands();
+
+	this->workerPool = workerPool;
+	this->grainSize = std::max<size_t>(grainSize, 1);
+
+	size_t bufferCount = (workerPool != nullptr ? workerPool->getThreadCount() : 1);
+	commandBuffers.resize(1);
+	while (commandBuffers.size() < bufferCount) {
+		commandBuffers.emplace_back(new WorldCommandBuffer(world));
+	}
+}
+
+bool System::isParallel() const
+{
+	return workerPool != nullptr;
 }
+
+WorldCommandBuffer& System::getCommands()
+{
+	if (workerPool == nullptr) {
+		return *commandBuffers[0];
+	}
+	return *commandBuffers[workerPool->getCurrentThreadIndex()];
+}
+
+void System::playbackCommands()
+{
+	// Other scheduled systems may still be iterating the world
+	if (scheduled) {
+		return;
+	}
+	flushCommands();
+}
+
+void System::flushCommands()
+{
+	for (std::unique_ptr<WorldCommandBuffer>& commands : commandBuffers) {
+		commands->playback();
+	}
+}
+
+bool System::conflictsWith(const System& other) const
+{
+	if (!this->declaredAccess || !other.declaredAccess) {
+		return true;
+	}
+
+	ComponentBitmask otherAccess = other.readComponents | other.writeComponents;
+	if (this->writeComponents.intersects(otherAccess) || other.writeComponents.intersects(this->readComponents)) {
+		return true;
+	}
+
+	return sharesResource(this->writeResources, other.readResources)
+		|| sharesResource(this->writeResources, other.writeResources)
+		|| sharesResource(this->readResources, other.writeResources);
+}
+
+bool System::hasDeclaredAccess() const
+{
+	return declaredAccess;
+}
+
+const ComponentBitmask& System::getRequiredComponents() const
+{
+	return requiredComponents;
+}
+
+void System::readsResource(const void* resource)
+{
+	readResources.push_back(resource);
+	declaredAccess = true;
+}
+
+void System::writesResource(const void* resource)
+{
+	writeResources.push_back(resource);
+	declaredAccess = true;
+}
+
+bool System::sharesResource(const std::vector<const void*>& resources, const std::vector<const void*>& otherResources)
+{
+	for (const void* resource : resources) {
+		if (std::find(otherResources.begin(), otherResources.end(), resource) != otherResources.end()) {
+			return true;
+		}
+	}
+	return false;
+}
\ No newline at end of file
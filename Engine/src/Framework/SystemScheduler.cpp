@@ -0,0 +1,98 @@
+
+#include "Framework/SystemScheduler.h"
+
+SystemScheduler::SystemScheduler(WorkerPool& workerPool)
+	: workerPool(workerPool), deterministic(false)
+{ }
+
+SystemScheduler::~SystemScheduler()
+{
+	for (System* system : systems) {
+		system->scheduled = false;
+	}
+}
+
+void SystemScheduler::add(System& system)
+{
+	size_t index = systems.size();
+	systems.push_back(&system);
+	system.scheduled = true;
+	dependents.emplace_back();
+	dependencyCounts.push_back(0);
+
+	for (size_t i = 0; i < index; i++) {
+		if (systems[i]->conflictsWith(system)) {
+			dependents[i].push_back(index);
+			dependencyCounts[index]++;
+		}
+	}
+
+	remainingDependencies.reset(new std::atomic<unsigned>[systems.size()]);
+}
+
+void SystemScheduler::update(float dt)
+{
+	if (deterministic || workerPool.getThreadCount() == 1) {
+		for (System* system : systems) {
+			system->update(dt);
+		}
+		playbackCommands();
+		return;
+	}
+
+	for (size_t i = 0; i < systems.size(); i++) {
+		remainingDependencies[i] = dependencyCounts[i];
+	}
+
+	TaskCounter counter;
+	for (size_t i = 0; i < systems.size(); i++) {
+		if (dependencyCounts[i] == 0) {
+			workerPool.push([this, i, dt, &counter]() { this->run(i, dt, counter); }, counter);
+		}
+	}
+	workerPool.wait(counter);
+	playbackCommands();
+}
+
+void SystemScheduler::playbackCommands()
+{
+	// Structural changes can't be made while other systems are iterating the world,
+	// and the dependency graph doesn't know about them, so they wait until everything is done
+	for (System* system : systems) {
+		system->flushCommands();
+	}
+}
+
+void SystemScheduler::run(size_t index, float dt, TaskCounter& counter)
+{
+	systems[index]->update(dt);
+
+	for (size_t dependent : dependents[index]) {
+		if (--remainingDependencies[dependent] == 0) {
+			workerPool.push([this, dependent, dt, &counter]() { this->run(dependent, dt, counter); }, counter);
+		}
+	}
+}
+
+void SystemScheduler::setDeterministic(bool deterministic)
+{
+	this->deterministic = deterministic;
+}
+
+bool SystemScheduler::isDeterministic() const
+{
+	return deterministic;
+}
+
+std::vector<size_t> SystemScheduler::getDependencies(size_t index) const
+{
+	std::vector<size_t> dependencies;
+	for (size_t i = 0; i < index; i++) {
+		for (size_t dependent : dependents[i]) {
+			if (dependent == index) {
+				dependencies.push_back(i);
+			}
+		}
+	}
+	return dependencies;
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+
+#include "Framework/WorkerPool.h"
+
+namespace
+{
+	thread_local const WorkerPool* currentPool = nullptr;
+	thread_local unsigned currentIndex = 0;
+}
+
+WorkerPool::WorkerPool(unsigned threadCount)
+	: queued(0), stopping(false)
+{
+	if (threadCount == 0) {
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	for (unsigned i = 0; i < threadCount; i++) {
+		queues.emplace_back(new Queue());
+	}
+	for (unsigned i = 1; i < threadCount; i++) {
+		threads.emplace_back(&WorkerPool::workerLoop, this, i);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	condition.notify_all();
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::push(std::function<void()> task, TaskCounter& counter)
+{
+	counter.count++;
+
+	Queue& queue = *queues[getCurrentThreadIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(Task{ std::move(task), &counter });
+	}
+	queued++;
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	condition.notify_all();
+}
+
+void WorkerPool::wait(TaskCounter& counter)
+{
+	unsigned index = getCurrentThreadIndex();
+	Task task;
+	while (!counter.done()) {
+		if (pop(index, task)) {
+			run(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		condition.wait(lock, [this, &counter]() { return counter.done() || queued > 0; });
+	}
+}
+
+unsigned WorkerPool::getThreadCount() const
+{
+	return (unsigned)queues.size();
+}
+
+unsigned WorkerPool::getCurrentThreadIndex() const
+{
+	return (currentPool == this ? currentIndex : 0);
+}
+
+void WorkerPool::workerLoop(unsigned index)
+{
+	currentPool = this;
+	currentIndex = index;
+
+	Task task;
+	while (true) {
+		if (pop(index, task)) {
+			run(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		condition.wait(lock, [this]() { return stopping || queued > 0; });
+		if (stopping) {
+			return;
+		}
+	}
+}
+
+bool WorkerPool::pop(unsigned index, Task& task)
+{
+	// Newest first from our own queue, since its data is most likely still in cache
+	{
+		Queue& queue = *queues[index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			queued--;
+			return true;
+		}
+	}
+
+	// Oldest first from everyone else's, since those tend to be the biggest pieces of work
+	for (size_t i = 1; i < queues.size(); i++) {
+		Queue& queue = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			queued--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkerPool::run(Task& task)
+{
+	task.function();
+
+	if (--task.counter->count == 0) {
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		condition.notify_all();
+	}
+}
\ No newline at end of file
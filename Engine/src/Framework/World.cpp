@@ -2,21 +2,51 @@
 #include "Framework/World.h"
 
 #include "Framework/Prefab.h"
+#include "Framework/PrefabTemplate.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cstring>
 
 const eid_t World::NullEntity = UINT32_MAX;
+const size_t World::minimumFreeIndices;
+const cid_t World::invalidComponentId;
+
+namespace
+{
+	/*! "WSNP", and the version of the layout written by World::snapshot. */
+	const uint32_t snapshotMagic = 0x504E5357;
+	const uint32_t snapshotVersion = 2;
+}
+
+World::World()
+	: freeIndicesHead(0), nextUnusedIndex(0), nextComponentId(0), nextResourceVersion(0), changeTick(1)
+{
+#ifndef WORLD_STRIP_NAMES
+	// nid_t 0 is the empty name, which entities without a name share
+	names.emplace_back("");
+#endif
+}
+
+World::Entity::Entity(eid_t id)
+	: id(id), alive(false), markedForDeletion(false)
+#ifndef WORLD_STRIP_NAMES
+	, name(0), previousWithName(World::NullEntity), nextWithName(World::NullEntity)
+#endif
+{ }
 
 World::eid_iterator::eid_iterator()
 { }
 
-World::eid_iterator::eid_iterator(std::map<eid_t, Entity>::iterator entityIterBegin,
-	std::map<eid_t, Entity>::iterator entityIterEnd,
+World::eid_iterator::eid_iterator(std::vector<Entity>::iterator entityIterBegin,
+	std::vector<Entity>::iterator entityIterEnd,
 	ComponentBitmask match)
 {
 	this->entityIter = entityIterBegin;
 	this->entityIterEnd = entityIterEnd;
 	this->match = match;
 
-	while (this->entityIter != this->entityIterEnd && !this->entityIter->second.components.hasComponents(match)) {
+	while (this->entityIter != this->entityIterEnd && !matches(*this->entityIter)) {
 		this->entityIter++;
 	}
 	this->entityIterBegin = this->entityIter;
@@ -24,14 +54,19 @@ World::eid_iterator::eid_iterator(std::map<eid_t, Entity>::iterator entityIterBe
 
 eid_t World::eid_iterator::value()
 {
-	return entityIter->first;
+	return entityIter->id;
 }
 
 void World::eid_iterator::next()
 {
 	do {
 		entityIter++;
-	} while (entityIter != entityIterEnd && !entityIter->second.components.hasComponents(match));
+	} while (entityIter != entityIterEnd && !matches(*entityIter));
+}
+
+bool World::eid_iterator::matches(const Entity& entity) const
+{
+	return entity.alive && entity.components.hasComponents(match);
 }
 
 bool World::eid_iterator::atEnd()
@@ -46,107 +81,235 @@ void World::eid_iterator::reset()
 
 eid_t World::constructPrefab(const Prefab& prefab, eid_t parent, void* userinfo)
 {
-	eid_t entity = this->getNewEntity(prefab.getName());
-	auto entityIter = entities.find(entity);
+	eid_t entity = reserveEntity();
+	constructPrefab(entity, prefab, parent, userinfo);
+	return entity;
+}
 
-	std::vector<ComponentConstructorInfo> infos = prefab.construct(*this, parent, userinfo);
-	for (unsigned i = 0; i < infos.size(); i++) {
-		ComponentConstructorInfo& info = infos[i];
-		cid_t cid = getComponentId(info.typeidHash);
-		ComponentPool& componentPool = this->entityComponentMaps[cid];
-		componentPool.emplace(entity, std::unique_ptr<Component>(info.component));
-		entityIter->second.components.setBit(cid, true);
+void World::constructPrefab(eid_t entity, const Prefab& prefab, eid_t parent, void* userinfo)
+{
+	const PrefabTemplate& prefabTemplate = prefab.getTemplate();
+	const PrefabLayout& layout = getPrefabLayout(prefabTemplate);
+
+	Entity& entityData = activateEntity(entity, layout.name);
+	entityData.components = layout.components;
+
+	uint32_t tick = getChangeTick();
+	const std::vector<PrefabTemplate::Entry>& entries = prefabTemplate.getEntries();
+	for (size_t i = 0; i < entries.size(); i++) {
+		BaseComponentPool& pool = *componentPools[layout.componentIds[i]];
+		entries[i].copy(pool, entity, prefabTemplate.getPrototype(entries[i]));
+		pool.setChangeTick(entity, tick);
 	}
 
+	// The entity stays out of the queries until all of its components are attached.
+	// Constructors may construct prefabs of their own, so layout and entityData can't be used after this
+	constructingEntities.push_back(entity);
+	prefabTemplate.construct(*this, entity, parent, userinfo);
+	constructingEntities.pop_back();
+
+	updateQueries(entity, nullptr, &getEntity(entity)->components);
+
 	prefab.finish(*this, entity);
 
-	std::vector<std::shared_ptr<Prefab>> children;
+	const std::vector<std::shared_ptr<Prefab>>& children = prefab.getChildPrefabs();
 	for (unsigned i = 0; i < children.size(); i++) {
 		this->constructPrefab(*children[i], entity, userinfo);
 	}
+}
 
-	return entity;
+const World::PrefabLayout& World::getPrefabLayout(const PrefabTemplate& prefabTemplate)
+{
+	uint32_t id = prefabTemplate.getId();
+	if (prefabLayouts.size() <= id) {
+		prefabLayouts.resize(id + 1);
+	}
+
+	PrefabLayout& layout = prefabLayouts[id];
+	if (!layout.built) {
+		for (const PrefabTemplate::Entry& entry : prefabTemplate.getEntries()) {
+			cid_t cid = getComponentId(entry.typeIndex, entry.createPool);
+			layout.componentIds.push_back(cid);
+			layout.components.setBit(cid, true);
+		}
+#ifndef WORLD_STRIP_NAMES
+		layout.name = internName(prefabTemplate.getName());
+#endif
+		layout.built = true;
+	}
+	return layout;
 }
 
-cid_t World::getComponentId(size_t typeidHash)
+cid_t World::getComponentId(uint32_t typeIndex, PoolFactory createPool)
 {
-	auto iter = componentIdMap.find(typeidHash);
-	cid_t id;
-	if (iter == componentIdMap.end()) {
-		id = this->registerComponent(typeidHash);
-	} else {
-		id = iter->second;
+	if (typeIndex < componentIds.size() && componentIds[typeIndex] != invalidComponentId) {
+		return componentIds[typeIndex];
 	}
-	return id;
+	return this->registerComponent(typeIndex, createPool);
 }
 
-cid_t World::registerComponent(size_t typeidHash)
+cid_t World::registerComponent(uint32_t typeIndex, PoolFactory createPool)
 {
 	cid_t id = nextComponentId++;
-	componentIdMap.emplace(typeidHash, id);
-	entityComponentMaps.push_back(ComponentPool());
-	assert(componentIdMap.size() == entityComponentMaps.size());
+	assert(id < ComponentBitmask::size && "Too many component types; raise MAX_COMPONENTS");
+	if (componentIds.size() <= typeIndex) {
+		componentIds.resize(typeIndex + 1, invalidComponentId);
+	}
+	componentIds[typeIndex] = id;
+	componentPools.push_back(createPool());
 	return id;
 }
 
 eid_t World::getNewEntity(const std::string& name)
 {
-	eid_t id = nextEntityId++;
-	std::string actualName = name;
-	if (name.length() == 0) {
-		actualName = "Entity " + id;
+	Entity& entity = activateEntity(reserveEntity(), name);
+	updateQueries(entity.id, nullptr, &entity.components);
+	return entity.id;
+}
+
+eid_t World::reserveEntity()
+{
+	std::lock_guard<std::mutex> lock(reserveMutex);
+	if (freeIndices.size() - freeIndicesHead > minimumFreeIndices) {
+		uint32_t index = freeIndices[freeIndicesHead++];
+
+		// Shift the queue back to the start once half of it is used up
+		if (freeIndicesHead * 2 >= freeIndices.size()) {
+			freeIndices.erase(freeIndices.begin(), freeIndices.begin() + freeIndicesHead);
+			freeIndicesHead = 0;
+		}
+		return entities[index].id;
 	}
 
-	entities.emplace(id, World::Entity(actualName, ComponentBitmask()));
-	return id;
+	uint32_t index = nextUnusedIndex++;
+	assert(index < maxEntityIndex && "Too many entities");
+	return makeEntityId(index, 0);
+}
+
+World::Entity& World::activateEntity(eid_t entityId, const std::string& name)
+{
+#ifndef WORLD_STRIP_NAMES
+	return activateEntity(entityId, internName(name));
+#else
+	return activateEntity(entityId, (nid_t)0);
+#endif
+}
+
+World::Entity& World::activateEntity(eid_t entityId, nid_t name)
+{
+	uint32_t index = entityIndex(entityId);
+	while (entities.size() <= index) {
+		entities.emplace_back(makeEntityId((uint32_t)entities.size(), 0));
+	}
+
+	Entity& entity = entities[index];
+	assert(entity.id == entityId && !entity.alive);
+	entity.alive = true;
+	entity.markedForDeletion = false;
+	entity.components = ComponentBitmask();
+#ifndef WORLD_STRIP_NAMES
+	entity.name = name;
+	linkName(entity);
+#endif
+	return entity;
 }
 
 void World::removeEntity(eid_t entity)
 {
-	auto entityIter = entities.find(entity);
-	if (entityIter == entities.end()) {
+	Entity* entityData = getEntity(entity);
+	if (entityData == nullptr) {
 		return;
 	}
 
-	entityIter->second.markedForDeletion = true;
+	if (!entityData->markedForDeletion) {
+		entityData->markedForDeletion = true;
+		pendingDeletions.push_back(entity);
+	}
+}
+
+bool World::isAlive(eid_t entity) const
+{
+	return getEntity(entity) != nullptr;
 }
 
 void World::cleanupEntities()
 {
-	auto iter = entities.begin();
-	while (iter != entities.end())
-	{
-		if (iter->second.markedForDeletion) {
-			eid_t eid = iter->first;
-			for (unsigned i = 0; i < entityComponentMaps.size(); i++) {
-				ComponentPool& componentPool = entityComponentMaps[i];
-				auto componentIter = componentPool.find(eid);
-				if (componentIter != componentPool.end()) {
-					componentPool.erase(componentIter);
-				}
-			}
+	if (pendingDeletions.empty()) {
+		stats.lastCleanupDeletions = 0;
+		stats.lastCleanupMicros = 0.0;
+		return;
+	}
 
-			iter = entities.erase(iter);
-		} else {
-			++iter;
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// Sort the doomed components by pool, so each pool can remove all of its own at once
+	pendingRemovals.resize(componentPools.size());
+	unsigned deleted = 0;
+	for (eid_t id : pendingDeletions) {
+		Entity* entity = getEntity(id);
+		if (entity == nullptr) {
+			continue;
 		}
+
+		entity->components.forEachSetBit([this, id](msize_t cid) {
+			pendingRemovals[cid].push_back(id);
+		});
+		releaseEntity(*entity);
+		deleted++;
+	}
+	pendingDeletions.clear();
+
+	for (cid_t cid = 0; cid < pendingRemovals.size(); cid++) {
+		if (!pendingRemovals[cid].empty()) {
+			componentPools[cid]->removeBatch(pendingRemovals[cid]);
+			pendingRemovals[cid].clear();
+		}
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.entitiesDeleted += deleted;
+	stats.lastCleanupDeletions = deleted;
+	stats.lastCleanupMicros = std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void World::releaseEntity(Entity& entity)
+{
+	updateQueries(entity.id, &entity.components, nullptr);
+
+	uint32_t index = entityIndex(entity.id);
+	uint32_t generation = entityGeneration(entity.id);
+	entity.alive = false;
+#ifndef WORLD_STRIP_NAMES
+	unlinkName(entity);
+#endif
+
+	// A slot whose generation would wrap is retired, so old IDs can never come back to life
+	if (generation < maxEntityGeneration) {
+		entity.id = makeEntityId(index, generation + 1);
+		freeIndices.push_back(index);
 	}
 }
 
 std::string World::getEntityName(eid_t eid) const
 {
-	auto iter = entities.find(eid);
-	if (iter != entities.end()) {
-		return iter->second.name;
+	const Entity* entity = getEntity(eid);
+	if (entity == nullptr) {
+		return "";
 	}
-	return "";
+
+#ifndef WORLD_STRIP_NAMES
+	if (entity->name != 0) {
+		return names[entity->name].name;
+	}
+#endif
+	return "Entity " + std::to_string(entityIndex(eid));
 }
 
 ComponentBitmask World::getEntityBitmask(eid_t eid) const
 {
-	auto iter = entities.find(eid);
-	if (iter != entities.end()) {
-		return iter->second.components;
+	const Entity* entity = getEntity(eid);
+	if (entity != nullptr) {
+		return entity->components;
 	}
 	return ComponentBitmask();
 }
@@ -162,14 +325,74 @@ eid_t World::getEntityWithName(const std::string& name)
 		fprintf(stderr, "getEntityWithName called with empty name - did you mean to do that?");
 	}
 
-	for (auto& pair : this->entities) {
-		if (pair.second.name.compare(name) == 0) {
-			return pair.first;
-		}
+#ifndef WORLD_STRIP_NAMES
+	auto iter = nameIds.find(name);
+	if (iter != nameIds.end()) {
+		return names[iter->second].first;
 	}
+#endif
 	return World::NullEntity;
 }
 
+#ifndef WORLD_STRIP_NAMES
+nid_t World::internName(const std::string& name)
+{
+	if (name.empty()) {
+		return 0;
+	}
+
+	auto iter = nameIds.find(name);
+	if (iter != nameIds.end()) {
+		return iter->second;
+	}
+
+	nid_t id = (nid_t)names.size();
+	names.emplace_back(name);
+	nameIds.emplace(name, id);
+	return id;
+}
+
+void World::linkName(Entity& entity)
+{
+	if (entity.name == 0) {
+		return;
+	}
+
+	Name& name = names[entity.name];
+	entity.previousWithName = name.last;
+	entity.nextWithName = NullEntity;
+	if (name.last != NullEntity) {
+		entities[entityIndex(name.last)].nextWithName = entity.id;
+	} else {
+		name.first = entity.id;
+	}
+	name.last = entity.id;
+}
+
+void World::unlinkName(Entity& entity)
+{
+	if (entity.name == 0) {
+		return;
+	}
+
+	Name& name = names[entity.name];
+	if (entity.previousWithName != NullEntity) {
+		entities[entityIndex(entity.previousWithName)].nextWithName = entity.nextWithName;
+	} else {
+		name.first = entity.nextWithName;
+	}
+	if (entity.nextWithName != NullEntity) {
+		entities[entityIndex(entity.nextWithName)].previousWithName = entity.previousWithName;
+	} else {
+		name.last = entity.previousWithName;
+	}
+
+	entity.name = 0;
+	entity.previousWithName = NullEntity;
+	entity.nextWithName = NullEntity;
+}
+#endif
+
 bool World::orderEntities(eid_t& e1, eid_t& e2, const ComponentBitmask& b1, const ComponentBitmask& b2) const
 {
 	ComponentBitmask eb1 = this->getEntityBitmask(e1);
@@ -186,6 +409,56 @@ bool World::orderEntities(eid_t& e1, eid_t& e2, const ComponentBitmask& b1, cons
 	return false;
 }
 
+const std::vector<eid_t>& World::getEntitiesMatching(const ComponentBitmask& signature)
+{
+	std::lock_guard<std::mutex> lock(queryMutex);
+	for (unsigned i = 0; i < queries.size(); i++) {
+		if (queries[i]->signature == signature) {
+			stats.queryHits++;
+			return queries[i]->entities.getEntities();
+		}
+	}
+
+	stats.queryRebuilds++;
+	queries.emplace_back(new Query(signature));
+	Query& query = *queries.back();
+	for (auto& entity : entities) {
+		if (entity.alive && entity.components.hasComponents(signature) && !isConstructing(entity.id)) {
+			query.entities.insert(entity.id);
+		}
+	}
+	return query.entities.getEntities();
+}
+
+void World::updateQueries(eid_t entity, const ComponentBitmask* oldComponents, const ComponentBitmask* newComponents)
+{
+	for (unsigned i = 0; i < queries.size(); i++) {
+		Query& query = *queries[i];
+		bool matched = oldComponents != nullptr && oldComponents->hasComponents(query.signature);
+		bool matches = newComponents != nullptr && newComponents->hasComponents(query.signature);
+		if (matched == matches) {
+			continue;
+		}
+
+		if (matches) {
+			query.entities.insert(entity);
+		} else {
+			query.entities.erase(entity);
+		}
+		stats.queryUpdates++;
+	}
+}
+
+const WorldStats& World::getStats() const
+{
+	return stats;
+}
+
+void World::resetStats()
+{
+	stats = WorldStats();
+}
+
 bool World::entityHasComponents(eid_t entity, const ComponentBitmask& bitmask) const
 {
 	ComponentBitmask eb = this->getEntityBitmask(entity);
@@ -194,10 +467,245 @@ bool World::entityHasComponents(eid_t entity, const ComponentBitmask& bitmask) c
 
 void World::clear()
 {
+	for (unsigned i = 0; i < this->componentPools.size(); i++) {
+		this->componentPools[i]->clear();
+	}
+	for (unsigned i = 0; i < this->queries.size(); i++) {
+		this->queries[i]->entities.clear();
+	}
+
+	// Keep the slots and their generations, so IDs from before the clear stay dead
+	for (Entity& entity : entities) {
+		if (entity.alive) {
+			entity.components = ComponentBitmask();
+			releaseEntity(entity);
+		}
+	}
+	pendingDeletions.clear();
+}
+
+void World::snapshot(std::vector<char>& buffer) const
+{
+	assert(constructingEntities.empty() && "Snapshot taken while a prefab was being constructed");
+
+	buffer.clear();
+	SnapshotWriter writer(buffer);
+	writer.write(snapshotMagic);
+	writer.write(snapshotVersion);
+	// Catches snapshots from builds with a different entity layout, e.g. WORLD_STRIP_NAMES
+	writer.write((uint32_t)sizeof(Entity));
+
+	// Entity slots go in field by field, generations and name links included. Writing
+	// them whole would copy their padding, so equal worlds could give different bytes
+	writer.write((uint32_t)entities.size());
+	for (const Entity& entity : entities) {
+		writer.write(entity.id);
+		writer.write(entity.alive);
+		writer.write(entity.markedForDeletion);
+#ifndef WORLD_STRIP_NAMES
+		writer.write(entity.name);
+		writer.write(entity.previousWithName);
+		writer.write(entity.nextWithName);
+#endif
+		writer.write(entity.components);
+	}
+	writer.write(nextUnusedIndex);
+	writer.write((uint32_t)(freeIndices.size() - freeIndicesHead));
+	writer.writeArray(freeIndices.data() + freeIndicesHead, freeIndices.size() - freeIndicesHead);
+	writer.write((uint32_t)pendingDeletions.size());
+	writer.writeArray(pendingDeletions.data(), pendingDeletions.size());
+
+#ifndef WORLD_STRIP_NAMES
+	writer.write((uint32_t)names.size());
+	for (const Name& name : names) {
+		writer.writeString(name.name);
+		writer.write(name.first);
+		writer.write(name.last);
+	}
+#else
+	writer.write((uint32_t)0);
+#endif
+
+	size_t poolCountPosition = writer.position();
+	uint32_t poolCount = 0;
+	writer.write(poolCount);
+	for (const std::unique_ptr<BaseComponentPool>& pool : componentPools) {
+		if (!pool->isSerializable()) {
+			continue;
+		}
+
+		// The length lets restore skip pools it has no matching type for
+		writer.writeString(pool->getTypeName());
+		writer.write((uint32_t)pool->size());
+		size_t lengthPosition = writer.position();
+		writer.write((uint64_t)0);
+		writer.writeArray(pool->getEntities().data(), pool->size());
+		pool->serialize(writer);
+		writer.overwrite(lengthPosition, (uint64_t)(writer.position() - lengthPosition - sizeof(uint64_t)));
+		poolCount++;
+	}
+	writer.overwrite(poolCountPosition, poolCount);
+}
+
+bool World::restore(const std::vector<char>& buffer)
+{
+	assert(constructingEntities.empty() && "Snapshot restored while a prefab was being constructed");
+
+	SnapshotReader reader(buffer.data(), buffer.size());
+	uint32_t magic, version, entitySize;
+	reader.read(magic);
+	reader.read(version);
+	reader.read(entitySize);
+	if (reader.hasFailed() || magic != snapshotMagic || version != snapshotVersion || entitySize != sizeof(Entity)) {
+		return false;
+	}
+
+	for (std::unique_ptr<BaseComponentPool>& pool : componentPools) {
+		pool->clear();
+	}
+
+	uint32_t entityCount = 0;
+	reader.read(entityCount);
+	const size_t entityBytes = sizeof(eid_t) + 2 * sizeof(bool) + sizeof(ComponentBitmask)
+#ifndef WORLD_STRIP_NAMES
+		+ sizeof(nid_t) + 2 * sizeof(eid_t)
+#endif
+		;
 	entities.clear();
-	for (unsigned i = 0; i < this->entityComponentMaps.size(); i++) {
-		this->entityComponentMaps[i].clear();
+	entities.reserve(std::min<size_t>(entityCount, reader.remaining() / entityBytes));
+	for (uint32_t i = 0; i < entityCount && !reader.hasFailed(); i++) {
+		entities.emplace_back(NullEntity);
+		Entity& entity = entities.back();
+		reader.read(entity.id);
+		reader.read(entity.alive);
+		reader.read(entity.markedForDeletion);
+#ifndef WORLD_STRIP_NAMES
+		reader.read(entity.name);
+		reader.read(entity.previousWithName);
+		reader.read(entity.nextWithName);
+#endif
+		reader.read(entity.components);
+	}
+	reader.read(nextUnusedIndex);
+
+	uint32_t freeCount = 0;
+	reader.read(freeCount);
+	freeIndices.resize(std::min<size_t>(freeCount, reader.remaining() / sizeof(uint32_t)));
+	freeIndicesHead = 0;
+	reader.readArray(freeIndices.data(), freeCount);
+
+	uint32_t pendingCount = 0;
+	reader.read(pendingCount);
+	pendingDeletions.resize(std::min<size_t>(pendingCount, reader.remaining() / sizeof(eid_t)));
+	reader.readArray(pendingDeletions.data(), pendingCount);
+
+	uint32_t nameCount = 0;
+	reader.read(nameCount);
+#ifndef WORLD_STRIP_NAMES
+	names.clear();
+	nameIds.clear();
+	// Prefab layouts hold IDs from the old name table
+	prefabLayouts.clear();
+#endif
+	for (uint32_t i = 0; i < nameCount && !reader.hasFailed(); i++) {
+		std::string name;
+		eid_t first, last;
+		reader.readString(name);
+		reader.read(first);
+		reader.read(last);
+#ifndef WORLD_STRIP_NAMES
+		names.emplace_back(name);
+		names.back().first = first;
+		names.back().last = last;
+		if (i > 0) {
+			nameIds.emplace(name, (nid_t)i);
+		}
+#endif
 	}
+#ifndef WORLD_STRIP_NAMES
+	if (names.empty()) {
+		reset();
+		return false;
+	}
+#endif
+
+	uint32_t poolCount = 0;
+	reader.read(poolCount);
+	for (uint32_t i = 0; i < poolCount && !reader.hasFailed(); i++) {
+		std::string typeName;
+		uint32_t count = 0;
+		uint64_t length = 0;
+		reader.readString(typeName);
+		reader.read(count);
+		reader.read(length);
+
+		BaseComponentPool* pool = nullptr;
+		for (std::unique_ptr<BaseComponentPool>& candidate : componentPools) {
+			if (candidate->isSerializable() && candidate->size() == 0 && typeName == candidate->getTypeName()) {
+				pool = candidate.get();
+				break;
+			}
+		}
+		if (pool == nullptr) {
+			reader.skip((size_t)length);
+			continue;
+		}
 
-	nextEntityId = 0;
+		restoredOwners.resize(std::min<size_t>(count, reader.remaining() / sizeof(eid_t)));
+		if (reader.readArray(restoredOwners.data(), count)) {
+			pool->deserialize(reader, restoredOwners.data(), count, getChangeTick());
+		}
+	}
+
+	if (reader.hasFailed()) {
+		reset();
+		return false;
+	}
+
+	// Component IDs may differ from the world which took the snapshot, so the bitmasks are rebuilt
+	for (Entity& entity : entities) {
+		entity.components = ComponentBitmask();
+	}
+	for (cid_t cid = 0; cid < componentPools.size(); cid++) {
+		for (eid_t entity : componentPools[cid]->getEntities()) {
+			Entity* entityData = getEntity(entity);
+			if (entityData == nullptr) {
+				reset();
+				return false;
+			}
+			entityData->components.setBit(cid, true);
+		}
+	}
+
+	for (std::unique_ptr<Query>& query : queries) {
+		query->entities.clear();
+		for (Entity& entity : entities) {
+			if (entity.alive && entity.components.hasComponents(query->signature)) {
+				query->entities.insert(entity.id);
+			}
+		}
+	}
+	return true;
+}
+
+void World::reset()
+{
+	for (std::unique_ptr<BaseComponentPool>& pool : componentPools) {
+		pool->clear();
+	}
+	for (std::unique_ptr<Query>& query : queries) {
+		query->entities.clear();
+	}
+
+	entities.clear();
+	freeIndices.clear();
+	freeIndicesHead = 0;
+	nextUnusedIndex = 0;
+	pendingDeletions.clear();
+#ifndef WORLD_STRIP_NAMES
+	names.clear();
+	nameIds.clear();
+	names.emplace_back("");
+#endif
+	prefabLayouts.clear();
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+
+#include "Framework/WorldCommandBuffer.h"
+
+#include <algorithm>
+
+WorldCommandBuffer::WorldCommandBuffer(World& world)
+	: world(world)
+{ }
+
+WorldCommandBuffer::~WorldCommandBuffer()
+{
+	// Entities reserved by unplayed commands would never get their slots back
+	assert(commands.empty() && "WorldCommandBuffer destroyed without being played back");
+}
+
+eid_t WorldCommandBuffer::createEntity(const std::string& name)
+{
+	eid_t entity = world.reserveEntity();
+	commands.push_back(Command{ CommandType::CreateEntity, entity, names.size(), 0, nullptr, nullptr });
+	names.push_back(name);
+	return entity;
+}
+
+eid_t WorldCommandBuffer::constructPrefab(const Prefab& prefab, eid_t parent, void* userinfo)
+{
+	eid_t entity = world.reserveEntity();
+	commands.push_back(Command{ CommandType::ConstructPrefab, entity, prefabs.size(), 0, nullptr, nullptr });
+	prefabs.push_back(PrefabArguments{ &prefab, parent, userinfo });
+	return entity;
+}
+
+void WorldCommandBuffer::removeEntity(eid_t entity)
+{
+	commands.push_back(Command{ CommandType::RemoveEntity, entity, 0, 0, nullptr, nullptr });
+}
+
+bool WorldCommandBuffer::empty() const
+{
+	return commands.empty();
+}
+
+BaseComponentPool& WorldCommandBuffer::getStagingPool(uint32_t typeIndex, World::PoolFactory createPool)
+{
+	if (stagingPools.size() <= typeIndex) {
+		stagingPools.resize(typeIndex + 1);
+	}
+	if (!stagingPools[typeIndex]) {
+		stagingPools[typeIndex] = createPool();
+	}
+	return *stagingPools[typeIndex];
+}
+
+void WorldCommandBuffer::playback()
+{
+	// Look up every component ID first, so each pool can be grown once for all its new components
+	cids.assign(commands.size(), 0);
+	additions.clear();
+	for (size_t i = 0; i < commands.size(); i++) {
+		Command& command = commands[i];
+		if (command.type != CommandType::AddComponent && command.type != CommandType::RemoveComponent) {
+			continue;
+		}
+
+		cids[i] = world.getComponentId(command.typeIndex, command.createPool);
+		if (command.type == CommandType::AddComponent) {
+			if (additions.size() <= cids[i]) {
+				additions.resize(cids[i] + 1);
+			}
+			additions[cids[i]]++;
+		}
+	}
+	for (cid_t cid = 0; cid < additions.size(); cid++) {
+		if (additions[cid] > 0) {
+			BaseComponentPool& pool = *world.componentPools[cid];
+			pool.reserve(pool.size() + additions[cid]);
+		}
+	}
+
+	auto touch = [&](eid_t entity, bool created, const ComponentBitmask& components) {
+		uint32_t index = entityIndex(entity);
+		if (isPending.size() <= index) {
+			isPending.resize(std::max<size_t>(index + 1, world.entities.size()));
+		}
+		if (!isPending[index]) {
+			isPending[index] = true;
+			pending.push_back(PendingQueryUpdate{ entity, created, components });
+		}
+	};
+	auto flush = [&]() {
+		for (PendingQueryUpdate& update : pending) {
+			isPending[entityIndex(update.entity)] = false;
+			World::Entity* entityData = world.getEntity(update.entity);
+			if (entityData != nullptr) {
+				world.updateQueries(update.entity, update.created ? nullptr : &update.oldComponents, &entityData->components);
+			}
+		}
+		pending.clear();
+	};
+
+	for (size_t i = 0; i < commands.size(); i++) {
+		Command& command = commands[i];
+		switch (command.type) {
+		case CommandType::CreateEntity:
+			world.activateEntity(command.entity, names[command.argument]);
+			touch(command.entity, true, ComponentBitmask());
+			break;
+		case CommandType::ConstructPrefab:
+		{
+			// Prefab constructors may query the world, so it has to be up to date
+			flush();
+			PrefabArguments& arguments = prefabs[command.argument];
+			world.constructPrefab(command.entity, *arguments.prefab, arguments.parent, arguments.userinfo);
+			break;
+		}
+		case CommandType::RemoveEntity:
+			world.removeEntity(command.entity);
+			break;
+		case CommandType::AddComponent:
+		case CommandType::RemoveComponent:
+		{
+			World::Entity* entityData = world.getEntity(command.entity);
+			BaseComponentPool& pool = *world.componentPools[cids[i]];
+			bool adding = (command.type == CommandType::AddComponent);
+			if (entityData == nullptr || pool.has(command.entity) == adding) {
+				break;
+			}
+
+			touch(command.entity, false, entityData->components);
+			if (adding) {
+				pool.emplaceFrom(command.entity, *command.staging, (eid_t)command.argument);
+				pool.setChangeTick(command.entity, world.getChangeTick());
+			} else {
+				pool.remove(command.entity);
+			}
+			entityData->components.setBit(cids[i], adding);
+			break;
+		}
+		}
+	}
+
+	flush();
+	commands.clear();
+	names.clear();
+	prefabs.clear();
+	for (auto& stagingPool : stagingPools) {
+		if (stagingPool) {
+			stagingPool->clear();
+		}
+	}
+}
\ No newline at end of file
@@ -1,2 +1,69 @@
 
 #include "HandlePool.h"
+
+void HandleTable::addReference(uint32_t index)
+{
+	slots[index].references++;
+	handleCount++;
+}
+
+void HandleTable::releaseReference(uint32_t index)
+{
+	slots[index].references--;
+	handleCount--;
+
+	if (!poolAlive) {
+		if (handleCount == 0) {
+			delete this;
+		}
+		return;
+	}
+
+	if (slots[index].references == 0) {
+		if (slots[index].dense != UINT32_MAX) {
+			eraseObject(index);
+		} else {
+			// The object was erased while handles still referred to it
+			freeSlots.push_back(index);
+		}
+	}
+}
+
+void HandleTable::releasePool()
+{
+	// Handles held by the objects being destroyed mustn't delete the table out from under this
+	poolAlive = false;
+	handleCount++;
+	clearObjects();
+	handleCount--;
+
+	if (handleCount == 0) {
+		delete this;
+	}
+}
+
+uint32_t HandleTable::allocateSlot()
+{
+	if (!freeSlots.empty()) {
+		uint32_t index = freeSlots.back();
+		freeSlots.pop_back();
+		return index;
+	}
+
+	Slot slot;
+	slot.dense = UINT32_MAX;
+	slot.generation = 0;
+	slot.references = 0;
+	slots.push_back(slot);
+	return (uint32_t)slots.size() - 1;
+}
+
+void HandleTable::vacateSlot(uint32_t index)
+{
+	Slot& slot = slots[index];
+	slot.dense = UINT32_MAX;
+	slot.generation++;
+	if (slot.references == 0) {
+		freeSlots.push_back(index);
+	}
+}
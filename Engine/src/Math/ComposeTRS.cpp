@@ -0,0 +1,120 @@
+
+#include "Math/ComposeTRS.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMPOSETRS_SSE2
+#endif
+
+namespace
+{
+	// Rotation terms are computed in the same order as glm's mat3_cast, so that the
+	// results match glm::toMat4 to the bit
+	void composeOne(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale, glm::mat4& out)
+	{
+		float qxx = rotation.x * rotation.x;
+		float qyy = rotation.y * rotation.y;
+		float qzz = rotation.z * rotation.z;
+		float qxz = rotation.x * rotation.z;
+		float qxy = rotation.x * rotation.y;
+		float qyz = rotation.y * rotation.z;
+		float qwx = rotation.w * rotation.x;
+		float qwy = rotation.w * rotation.y;
+		float qwz = rotation.w * rotation.z;
+
+		out[0][0] = (1.0f - 2.0f * (qyy + qzz)) * scale.x;
+		out[0][1] = (2.0f * (qxy + qwz)) * scale.x;
+		out[0][2] = (2.0f * (qxz - qwy)) * scale.x;
+		out[0][3] = 0.0f;
+
+		out[1][0] = (2.0f * (qxy - qwz)) * scale.y;
+		out[1][1] = (1.0f - 2.0f * (qxx + qzz)) * scale.y;
+		out[1][2] = (2.0f * (qyz + qwx)) * scale.y;
+		out[1][3] = 0.0f;
+
+		out[2][0] = (2.0f * (qxz + qwy)) * scale.z;
+		out[2][1] = (2.0f * (qyz - qwx)) * scale.z;
+		out[2][2] = (1.0f - 2.0f * (qxx + qyy)) * scale.z;
+		out[2][3] = 0.0f;
+
+		out[3][0] = position.x;
+		out[3][1] = position.y;
+		out[3][2] = position.z;
+		out[3][3] = 1.0f;
+	}
+
+#ifdef COMPOSETRS_SSE2
+	/*! Stores one column of each of four matrices, given the column's rows across the matrices. */
+	inline void storeColumns(glm::mat4* out, int column, __m128 row0, __m128 row1, __m128 row2, __m128 row3)
+	{
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+		_mm_storeu_ps(&out[0][column][0], row0);
+		_mm_storeu_ps(&out[1][column][0], row1);
+		_mm_storeu_ps(&out[2][column][0], row2);
+		_mm_storeu_ps(&out[3][column][0], row3);
+	}
+
+	/*! composeOne for four transforms at once, each lane of a register holding one transform. */
+	void composeFour(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out)
+	{
+		__m128 x = _mm_setr_ps(rotations[0].x, rotations[1].x, rotations[2].x, rotations[3].x);
+		__m128 y = _mm_setr_ps(rotations[0].y, rotations[1].y, rotations[2].y, rotations[3].y);
+		__m128 z = _mm_setr_ps(rotations[0].z, rotations[1].z, rotations[2].z, rotations[3].z);
+		__m128 w = _mm_setr_ps(rotations[0].w, rotations[1].w, rotations[2].w, rotations[3].w);
+
+		__m128 qxx = _mm_mul_ps(x, x);
+		__m128 qyy = _mm_mul_ps(y, y);
+		__m128 qzz = _mm_mul_ps(z, z);
+		__m128 qxz = _mm_mul_ps(x, z);
+		__m128 qxy = _mm_mul_ps(x, y);
+		__m128 qyz = _mm_mul_ps(y, z);
+		__m128 qwx = _mm_mul_ps(w, x);
+		__m128 qwy = _mm_mul_ps(w, y);
+		__m128 qwz = _mm_mul_ps(w, z);
+
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		__m128 scale = _mm_setr_ps(scales[0].x, scales[1].x, scales[2].x, scales[3].x);
+		storeColumns(out, 0,
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qyy, qzz))), scale),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qxy, qwz)), scale),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qxz, qwy)), scale),
+			zero);
+
+		scale = _mm_setr_ps(scales[0].y, scales[1].y, scales[2].y, scales[3].y);
+		storeColumns(out, 1,
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qxy, qwz)), scale),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qxx, qzz))), scale),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qyz, qwx)), scale),
+			zero);
+
+		scale = _mm_setr_ps(scales[0].z, scales[1].z, scales[2].z, scales[3].z);
+		storeColumns(out, 2,
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qxz, qwy)), scale),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qyz, qwx)), scale),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qxx, qyy))), scale),
+			zero);
+
+		storeColumns(out, 3,
+			_mm_setr_ps(positions[0].x, positions[1].x, positions[2].x, positions[3].x),
+			_mm_setr_ps(positions[0].y, positions[1].y, positions[2].y, positions[3].y),
+			_mm_setr_ps(positions[0].z, positions[1].z, positions[2].z, positions[3].z),
+			one);
+	}
+#endif
+}
+
+void composeTRS(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count)
+{
+	size_t i = 0;
+#ifdef COMPOSETRS_SSE2
+	for (; i + 4 <= count; i += 4) {
+		composeFour(positions + i, rotations + i, scales + i, out + i);
+	}
+#endif
+	for (; i < count; i++) {
+		composeOne(positions[i], rotations[i], scales[i], out[i]);
+	}
+}
@@ -1,58 +1,241 @@
 
 #include "Math/Matrix.h"
 
-mat4::mat4()
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MATRIX_AVX
+#define MATRIX_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MATRIX_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MATRIX_NEON
+#endif
+
+namespace
+{
+	inline const float* columns(const glm::mat4& matrix)
+	{
+		return &matrix[0][0];
+	}
+
+	inline float* columns(glm::mat4& matrix)
+	{
+		return &matrix[0][0];
+	}
+
+#if defined(MATRIX_SSE2)
+	/*! One column of a * b, given a's columns and the column of b. */
+	inline __m128 multiplyColumn(__m128 a0, __m128 a1, __m128 a2, __m128 a3, const float* b)
+	{
+		__m128 result = _mm_mul_ps(a0, _mm_set1_ps(b[0]));
+		result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_set1_ps(b[1])));
+		result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_set1_ps(b[2])));
+		return _mm_add_ps(result, _mm_mul_ps(a3, _mm_set1_ps(b[3])));
+	}
+#endif
+
+#if defined(MATRIX_AVX)
+	/*! Two neighbouring columns of a * b at once, given a's columns repeated in both halves. */
+	inline __m256 multiplyColumnPair(__m256 a0, __m256 a1, __m256 a2, __m256 a3, const float* b)
+	{
+		__m256 pair = _mm256_loadu_ps(b);
+		__m256 result = _mm256_mul_ps(a0, _mm256_permute_ps(pair, _MM_SHUFFLE(0, 0, 0, 0)));
+		result = _mm256_add_ps(result, _mm256_mul_ps(a1, _mm256_permute_ps(pair, _MM_SHUFFLE(1, 1, 1, 1))));
+		result = _mm256_add_ps(result, _mm256_mul_ps(a2, _mm256_permute_ps(pair, _MM_SHUFFLE(2, 2, 2, 2))));
+		return _mm256_add_ps(result, _mm256_mul_ps(a3, _mm256_permute_ps(pair, _MM_SHUFFLE(3, 3, 3, 3))));
+	}
+#endif
+
+#if defined(MATRIX_NEON)
+	inline float32x4_t multiplyColumn(float32x4_t a0, float32x4_t a1, float32x4_t a2, float32x4_t a3, const float* b)
+	{
+		float32x4_t result = vmulq_n_f32(a0, b[0]);
+		result = vaddq_f32(result, vmulq_n_f32(a1, b[1]));
+		result = vaddq_f32(result, vmulq_n_f32(a2, b[2]));
+		return vaddq_f32(result, vmulq_n_f32(a3, b[3]));
+	}
+#endif
+
+	/*! Writes a * b to out, which must not overlap a. b and out may be the same, since each
+		column of b is read before the same column of out is written. */
+	inline void multiplyInto(const float* a, const float* b, float* out)
+	{
+#if defined(MATRIX_AVX)
+		__m256 a0 = _mm256_broadcast_ps((const __m128*)(a + 0));
+		__m256 a1 = _mm256_broadcast_ps((const __m128*)(a + 4));
+		__m256 a2 = _mm256_broadcast_ps((const __m128*)(a + 8));
+		__m256 a3 = _mm256_broadcast_ps((const __m128*)(a + 12));
+		__m256 low = multiplyColumnPair(a0, a1, a2, a3, b);
+		__m256 high = multiplyColumnPair(a0, a1, a2, a3, b + 8);
+		_mm256_storeu_ps(out, low);
+		_mm256_storeu_ps(out + 8, high);
+#elif defined(MATRIX_SSE2)
+		__m128 a0 = _mm_loadu_ps(a + 0);
+		__m128 a1 = _mm_loadu_ps(a + 4);
+		__m128 a2 = _mm_loadu_ps(a + 8);
+		__m128 a3 = _mm_loadu_ps(a + 12);
+		for (int column = 0; column < 4; column++) {
+			_mm_storeu_ps(out + column * 4, multiplyColumn(a0, a1, a2, a3, b + column * 4));
+		}
+#elif defined(MATRIX_NEON)
+		float32x4_t a0 = vld1q_f32(a + 0);
+		float32x4_t a1 = vld1q_f32(a + 4);
+		float32x4_t a2 = vld1q_f32(a + 8);
+		float32x4_t a3 = vld1q_f32(a + 12);
+		for (int column = 0; column < 4; column++) {
+			vst1q_f32(out + column * 4, multiplyColumn(a0, a1, a2, a3, b + column * 4));
+		}
+#else
+		for (int column = 0; column < 4; column++) {
+			const float* bColumn = b + column * 4;
+			float result[4];
+			for (int row = 0; row < 4; row++) {
+				result[row] = a[row] * bColumn[0] + a[4 + row] * bColumn[1] + a[8 + row] * bColumn[2] + a[12 + row] * bColumn[3];
+			}
+			for (int row = 0; row < 4; row++) {
+				out[column * 4 + row] = result[row];
+			}
+		}
+#endif
+	}
+}
+
+void mat4Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
 {
-	this->m11 = 1.0f; this->m21 = this->m31 = this->m41 = 0.0f;
-	this->m22 = 1.0f; this->m12 = this->m32 = this->m42 = 0.0f;
-	this->m33 = 1.0f; this->m13 = this->m23 = this->m43 = 0.0f;
-	this->m44 = 1.0f; this->m14 = this->m24 = this->m34 = 0.0f;
+	if (&out == &a) {
+		glm::mat4 copy = a;
+		multiplyInto(columns(copy), columns(b), columns(out));
+	} else {
+		multiplyInto(columns(a), columns(b), columns(out));
+	}
 }
 
-mat4::mat4(float m11, float m21, float m31, float m41,
-	float m12, float m22, float m32, float m42,
-	float m13, float m23, float m33, float m43,
-	float m14, float m24, float m34, float m44)
-	: m11(m11), m21(m21), m31(m31), m41(m41),
-	m12(m12), m22(m22), m32(m32), m42(m42),
-	m13(m13), m23(m23), m33(m33), m43(m43),
-	m14(m14), m24(m24), m34(m34), m44(m44)
-{ }
-
-mat4::mat4(const glm::mat4& matrix)
+glm::mat4 mat4Multiply(const glm::mat4& a, const glm::mat4& b)
 {
-	memcpy(this, &matrix[0][0], sizeof(float)*16);
+	glm::mat4 result;
+	multiplyInto(columns(a), columns(b), columns(result));
+	return result;
 }
 
-glm::mat4 mat4::toGlm()
+void mat4MultiplyAdd(const glm::mat4& a, const glm::mat4& b, glm::mat4& accumulator)
 {
-	glm::mat4 matrix = glm::mat4();
-	memcpy(&matrix[0][0], this, sizeof(float)*16);
-	return matrix;
+	const float* aColumns = columns(a);
+	const float* bColumns = columns(b);
+	float* out = columns(accumulator);
+#if defined(MATRIX_AVX)
+	__m256 a0 = _mm256_broadcast_ps((const __m128*)(aColumns + 0));
+	__m256 a1 = _mm256_broadcast_ps((const __m128*)(aColumns + 4));
+	__m256 a2 = _mm256_broadcast_ps((const __m128*)(aColumns + 8));
+	__m256 a3 = _mm256_broadcast_ps((const __m128*)(aColumns + 12));
+	for (int pair = 0; pair < 2; pair++) {
+		__m256 product = multiplyColumnPair(a0, a1, a2, a3, bColumns + pair * 8);
+		_mm256_storeu_ps(out + pair * 8, _mm256_add_ps(_mm256_loadu_ps(out + pair * 8), product));
+	}
+#elif defined(MATRIX_SSE2)
+	__m128 a0 = _mm_loadu_ps(aColumns + 0);
+	__m128 a1 = _mm_loadu_ps(aColumns + 4);
+	__m128 a2 = _mm_loadu_ps(aColumns + 8);
+	__m128 a3 = _mm_loadu_ps(aColumns + 12);
+	for (int column = 0; column < 4; column++) {
+		__m128 product = multiplyColumn(a0, a1, a2, a3, bColumns + column * 4);
+		_mm_storeu_ps(out + column * 4, _mm_add_ps(_mm_loadu_ps(out + column * 4), product));
+	}
+#elif defined(MATRIX_NEON)
+	float32x4_t a0 = vld1q_f32(aColumns + 0);
+	float32x4_t a1 = vld1q_f32(aColumns + 4);
+	float32x4_t a2 = vld1q_f32(aColumns + 8);
+	float32x4_t a3 = vld1q_f32(aColumns + 12);
+	for (int column = 0; column < 4; column++) {
+		float32x4_t product = multiplyColumn(a0, a1, a2, a3, bColumns + column * 4);
+		vst1q_f32(out + column * 4, vaddq_f32(vld1q_f32(out + column * 4), product));
+	}
+#else
+	float product[16];
+	multiplyInto(aColumns, bColumns, product);
+	for (int i = 0; i < 16; i++) {
+		out[i] += product[i];
+	}
+#endif
+}
+
+glm::mat4 mat4AffineInverse(const glm::mat4& matrix)
+{
+	// The inverse of the upper 3x3 has the cross products of its columns as rows,
+	// divided by the determinant; the translation is then moved back through it
+	glm::mat4 result;
+	const float* in = columns(matrix);
+	float* out = columns(result);
+#if defined(MATRIX_SSE2)
+	__m128 c0 = _mm_loadu_ps(in + 0);
+	__m128 c1 = _mm_loadu_ps(in + 4);
+	__m128 c2 = _mm_loadu_ps(in + 8);
+	__m128 translation = _mm_loadu_ps(in + 12);
+
+	auto cross = [](__m128 u, __m128 v) {
+		__m128 uYZX = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 vYZX = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 crossZXY = _mm_sub_ps(_mm_mul_ps(u, vYZX), _mm_mul_ps(uYZX, v));
+		return _mm_shuffle_ps(crossZXY, crossZXY, _MM_SHUFFLE(3, 0, 2, 1));
+	};
+	__m128 r0 = cross(c1, c2);
+	__m128 r1 = cross(c2, c0);
+	__m128 r2 = cross(c0, c1);
+
+	__m128 products = _mm_mul_ps(c0, r0);
+	float determinant = _mm_cvtss_f32(products) + _mm_cvtss_f32(_mm_shuffle_ps(products, products, _MM_SHUFFLE(1, 1, 1, 1)))
+		+ _mm_cvtss_f32(_mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 2, 2, 2)));
+	__m128 inverseDeterminant = _mm_set1_ps(1.0f / determinant);
+	r0 = _mm_mul_ps(r0, inverseDeterminant);
+	r1 = _mm_mul_ps(r1, inverseDeterminant);
+	r2 = _mm_mul_ps(r2, inverseDeterminant);
+
+	// The cross products' last lanes are 0, so after transposing, so is each column's
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	__m128 moved = _mm_mul_ps(r0, _mm_shuffle_ps(translation, translation, _MM_SHUFFLE(0, 0, 0, 0)));
+	moved = _mm_add_ps(moved, _mm_mul_ps(r1, _mm_shuffle_ps(translation, translation, _MM_SHUFFLE(1, 1, 1, 1))));
+	moved = _mm_add_ps(moved, _mm_mul_ps(r2, _mm_shuffle_ps(translation, translation, _MM_SHUFFLE(2, 2, 2, 2))));
+	moved = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), moved);
+
+	_mm_storeu_ps(out + 0, r0);
+	_mm_storeu_ps(out + 4, r1);
+	_mm_storeu_ps(out + 8, r2);
+	_mm_storeu_ps(out + 12, moved);
+#else
+	const float* c0 = in + 0;
+	const float* c1 = in + 4;
+	const float* c2 = in + 8;
+	const float* translation = in + 12;
+
+	float rows[3][3] = {
+		{ c1[1] * c2[2] - c1[2] * c2[1], c1[2] * c2[0] - c1[0] * c2[2], c1[0] * c2[1] - c1[1] * c2[0] },
+		{ c2[1] * c0[2] - c2[2] * c0[1], c2[2] * c0[0] - c2[0] * c0[2], c2[0] * c0[1] - c2[1] * c0[0] },
+		{ c0[1] * c1[2] - c0[2] * c1[1], c0[2] * c1[0] - c0[0] * c1[2], c0[0] * c1[1] - c0[1] * c1[0] }
+	};
+	float inverseDeterminant = 1.0f / (c0[0] * rows[0][0] + c0[1] * rows[0][1] + c0[2] * rows[0][2]);
+
+	for (int column = 0; column < 3; column++) {
+		for (int row = 0; row < 3; row++) {
+			out[column * 4 + row] = rows[row][column] * inverseDeterminant;
+		}
+		out[column * 4 + 3] = 0.0f;
+	}
+	for (int row = 0; row < 3; row++) {
+		out[12 + row] = -(out[row] * translation[0] + out[4 + row] * translation[1] + out[8 + row] * translation[2]);
+	}
+	out[15] = 1.0f;
+#endif
+	return result;
 }
 
-mat4 mat4::operator*(const mat4 other)
+void mat4MultiplyBatch(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count)
 {
-	mat4 retval;
-	retval.m11 = this->m11 * other.m11 + this->m12 * other.m21 + this->m13 * other.m31 + this->m14 * other.m41;
-	retval.m12 = this->m11 * other.m12 + this->m12 * other.m22 + this->m13 * other.m32 + this->m14 * other.m42;
-	retval.m13 = this->m11 * other.m13 + this->m12 * other.m23 + this->m13 * other.m33 + this->m14 * other.m43;
-	retval.m14 = this->m11 * other.m14 + this->m12 * other.m24 + this->m13 * other.m34 + this->m14 * other.m44;
-
-	retval.m21 = this->m21 * other.m11 + this->m22 * other.m21 + this->m23 * other.m31 + this->m24 * other.m41;
-	retval.m22 = this->m21 * other.m12 + this->m22 * other.m22 + this->m23 * other.m32 + this->m24 * other.m42;
-	retval.m23 = this->m21 * other.m13 + this->m22 * other.m23 + this->m23 * other.m33 + this->m24 * other.m43;
-	retval.m24 = this->m21 * other.m14 + this->m22 * other.m24 + this->m23 * other.m34 + this->m24 * other.m44;
-
-	retval.m31 = this->m31 * other.m11 + this->m32 * other.m21 + this->m33 * other.m31 + this->m34 * other.m41;
-	retval.m32 = this->m31 * other.m12 + this->m32 * other.m22 + this->m33 * other.m32 + this->m34 * other.m42;
-	retval.m33 = this->m31 * other.m13 + this->m32 * other.m23 + this->m33 * other.m33 + this->m34 * other.m43;
-	retval.m34 = this->m31 * other.m14 + this->m32 * other.m24 + this->m33 * other.m34 + this->m34 * other.m44;
-
-	retval.m41 = this->m41 * other.m11 + this->m42 * other.m21 + this->m43 * other.m31 + this->m44 * other.m41;
-	retval.m42 = this->m41 * other.m12 + this->m42 * other.m22 + this->m43 * other.m32 + this->m44 * other.m42;
-	retval.m43 = this->m41 * other.m13 + this->m42 * other.m23 + this->m43 * other.m33 + this->m44 * other.m43;
-	retval.m44 = this->m41 * other.m14 + this->m42 * other.m24 + this->m43 * other.m34 + this->m44 * other.m44;
-
-	return retval;
+	// Copied in case a is one of the outputs
+	glm::mat4 left = a;
+	for (size_t i = 0; i < count; i++) {
+		multiplyInto(columns(left), columns(b[i]), columns(out[i]));
+	}
 }
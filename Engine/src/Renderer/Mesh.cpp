@@ -104,13 +104,11 @@ std::vector<glm::mat4> Mesh::getBoneTransforms(const std::vector<glm::mat4>& nod
 	}
 
 	// Assume 0 is the root node
-	mat4 globalInverse = glm::inverse(nodeTransforms[0]);
+	glm::mat4 globalInverse = mat4AffineInverse(nodeTransforms[0]);
 	for (unsigned int i = 0; i < impl->boneData.size(); i++) {
 		const BoneData& boneData = impl->boneData[i];
-		mat4 nodeTransform = nodeTransforms[boneData.nodeId];
-		mat4 boneOffset = boneData.boneOffset;
-		mat4 boneTransform = globalInverse * nodeTransform * boneOffset;
-		impl->boneTransforms[i] = boneTransform.toGlm();
+		glm::mat4 nodeTransform = mat4Multiply(globalInverse, nodeTransforms[boneData.nodeId]);
+		mat4Multiply(nodeTransform, boneData.boneOffset, impl->boneTransforms[i]);
 	}
 	
 	return impl->boneTransforms;
@@ -6,6 +6,7 @@
 #include "Renderer/Shader.h"
 #include "Renderer/Mesh.h"
 #include "Math/Matrix.h"
+#include "Math/ComposeTRS.h"
 
 #include <sstream>
 #include <string>
@@ -86,46 +87,47 @@ std::vector<glm::mat4> Model::getNodeTransforms(const std::string& animName, flo
 	const Animation& animation = iter->second;
 	time += animation.startTime;
 
+	// Interpolate every animated node's keyframes first, so their matrices can be composed in one batch
+	animatedNodes.clear();
+	animatedPositions.clear();
+	animatedRotations.clear();
+	animatedScales.clear();
 	for (unsigned i = 0; i < animationData.nodes.size(); i++) {
-		const ModelNode& node = animationData.nodes[i];
-
-		mat4 parentTransform = mat4();
-		if (node.parent < animationData.nodes.size()) {
-			 parentTransform = nodeTransforms[node.parent];
+		auto channelIdIter = animation.channelIdMap.find(i);
+		if (channelIdIter == animation.channelIdMap.end()) {
+			continue;
 		}
 
-		mat4 nodeTransform;
+		unsigned channelId = channelIdIter->second;
+		const Channel& channel = animation.channels[channelId];
+		ChannelContext& channelContext = context.channelContexts[channelId];
 
-		auto channelIdIter = animation.channelIdMap.find(i);
-		if (channelIdIter == animation.channelIdMap.end()) {
+		animatedNodes.push_back(i);
+		animatedPositions.push_back(interpolateKeyframes<glm::vec3, PositionKey>(channel.positionKeys, time, channelContext.positionKey));
+		animatedRotations.push_back(interpolateKeyframes<glm::quat, RotationKey>(channel.rotationKeys, time, channelContext.rotationKey));
+		animatedScales.push_back(interpolateKeyframes<glm::vec3, ScaleKey>(channel.scaleKeys, time, channelContext.scaleKey));
+	}
+
+	animatedTransforms.resize(animatedNodes.size());
+	composeTRS(animatedPositions.data(), animatedRotations.data(), animatedScales.data(), animatedTransforms.data(), animatedNodes.size());
+
+	size_t nextAnimated = 0;
+	for (unsigned i = 0; i < animationData.nodes.size(); i++) {
+		const ModelNode& node = animationData.nodes[i];
+
+		const glm::mat4* nodeTransform;
+		if (nextAnimated < animatedNodes.size() && animatedNodes[nextAnimated] == i) {
+			nodeTransform = &animatedTransforms[nextAnimated++];
+		} else {
 			// Not an animated node
-			nodeTransform = node.transform;
+			nodeTransform = &node.transform;
+		}
+
+		if (node.parent < animationData.nodes.size()) {
+			mat4Multiply(nodeTransforms[node.parent], *nodeTransform, nodeTransforms[i]);
 		} else {
-			unsigned channelId = channelIdIter->second;
-			const Channel& channel = animation.channels[channelId];
-			ChannelContext& channelContext = context.channelContexts[channelId];
-
-			glm::vec3 pos = interpolateKeyframes<glm::vec3, PositionKey>(channel.positionKeys, time, channelContext.positionKey);
-			glm::quat rot = interpolateKeyframes<glm::quat, RotationKey>(channel.rotationKeys, time, channelContext.rotationKey);
-			glm::vec3 scale = interpolateKeyframes<glm::vec3, ScaleKey>(channel.scaleKeys, time, channelContext.scaleKey);
-
-			mat4 posMatrix = mat4(
-				1.0f, 0.0f, 0.0f, 0.0f,
-				0.0f, 1.0f, 0.0f, 0.0f,
-				0.0f, 0.0f, 1.0f, 0.0f,
-				pos.x, pos.y, pos.z, 1.0f
-				);
-			mat4 rotMatrix(glm::toMat4(rot));
-			mat4 scaleMatrix = mat4(
-				scale.x, 0.0f, 0.0f, 0.0f,
-				0.0f, scale.y, 0.0f, 0.0f,
-				0.0f, 0.0f, scale.z, 0.0f,
-				0.0f, 0.0f, 0.0f, 1.0f
-				);
-			nodeTransform = posMatrix * rotMatrix * scaleMatrix;
+			nodeTransforms[i] = *nodeTransform;
 		}
-		mat4 globalTransform = parentTransform * nodeTransform;
-		nodeTransforms[i] = globalTransform.toGlm();
 	}
 
 	return nodeTransforms;
@@ -49,6 +49,10 @@ struct Renderer::ShaderCache
 	GLuint pointLightCount;
 };
 
+/*! Order in which renderables are drawn. Grouping them by shader, then by model, means
+	consecutive renderables mostly share their GL state. */
+static bool drawOrderLess(const Renderer::Entity& e1, const Renderer::Entity& e2);
+
 /*! A renderable, stored internally in the renderer.
 	Renderables can be equated to entities. They reference a model and a shader, but have
 	their own transforms. */
@@ -187,8 +191,8 @@ void Renderer::setRenderableRenderSpace(const RenderableHandle& handle, RenderSp
 void Renderer::update(float dt)
 {
 	for (auto iter = entityPool.begin(); iter != entityPool.end(); iter++) {
-		Entity& renderable = iter->second;
-		std::string animName = iter->second.animName;
+		Entity& renderable = *iter;
+		std::string animName = renderable.animName;
 
 		if (animName.size() == 0) {
 			// Not being animated
@@ -196,7 +200,7 @@ void Renderer::update(float dt)
 		}
 		renderable.time += dt;
 
-		std::experimental::optional<std::reference_wrapper<Model>> modelOpt = modelPool.get(iter->second.modelHandle);
+		std::experimental::optional<std::reference_wrapper<Model>> modelOpt = modelPool.get(renderable.modelHandle);
 		assert(modelOpt);
 
 		Model& model = *modelOpt;
@@ -231,6 +235,11 @@ void Renderer::draw()
 
 	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_FRAMEBUFFER_SRGB);
+
+	// The sort key never changes for a renderable, so only new ones can put the pool out of order
+	if (!entityPool.isSorted()) {
+		entityPool.sort(drawOrderLess);
+	}
 	this->drawInternal(RenderSpace_World);
 }
 
@@ -250,7 +259,7 @@ void Renderer::drawInternal(RenderSpace space)
 				break;
 			}
 
-			const PointLight& light = lightIter->second;
+			const PointLight& light = *lightIter;
 			glUniform1f(shaderCache.pointLights[pointLightCount].constant, light.constant);
 			glUniform1f(shaderCache.pointLights[pointLightCount].linear, light.linear);
 			glUniform1f(shaderCache.pointLights[pointLightCount].quadratic, light.quadratic);
@@ -272,20 +281,24 @@ void Renderer::drawInternal(RenderSpace space)
 	}
 
 	// Render each renderable we have loaded through getHandle
+	GLuint currentShader = 0;
 	for (auto iter = entityPool.begin(); iter != entityPool.end(); iter++) {
-		Entity& renderable = iter->second;
+		Entity& renderable = *iter;
 		if (renderable.space != space) {
 			continue;
 		}
 
-		std::experimental::optional<std::reference_wrapper<Model>> modelOpt = modelPool.get(iter->second.modelHandle);
+		std::experimental::optional<std::reference_wrapper<Model>> modelOpt = modelPool.get(renderable.modelHandle);
 		assert(modelOpt);
 
 		Model& model = *modelOpt;
 		ShaderCache& shaderCache = renderable.shaderCache;
 		glm::mat4 modelMatrix = renderable.transform;
 
-		shaderCache.shader.use();
+		if (shaderCache.shader.getID() != currentShader) {
+			shaderCache.shader.use();
+			currentShader = shaderCache.shader.getID();
+		}
 
 		if (renderable.animatable) {
 			Mesh& mesh = model.mesh;
@@ -357,6 +370,16 @@ PointLight Renderer::getPointLight(const Renderer::PointLightHandle& handle)
 	return *lightOpt;
 }
 
+static bool drawOrderLess(const Renderer::Entity& e1, const Renderer::Entity& e2)
+{
+	GLuint shader1 = e1.shaderCache.shader.getID();
+	GLuint shader2 = e2.shaderCache.shader.getID();
+	if (shader1 != shader2) {
+		return shader1 < shader2;
+	}
+	return e1.modelHandle.getWeakHandle().index < e2.modelHandle.getWeakHandle().index;
+}
+
 Renderer::ShaderCache::ShaderCache(const ShaderImpl& shader)
 	: shader(shader),
 	pointLights(maxPointLights),
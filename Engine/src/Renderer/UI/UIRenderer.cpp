@@ -3,6 +3,8 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+
 #include "Optional.h"
 
 #include "Renderer/Shader.h"
@@ -18,24 +20,28 @@ struct UIRenderer::Entity {
 	ShaderImpl shader;
 };
 
-/*! Comparator used when sorting sortedEntities. */
+/*! Comparator used when sorting drawOrder. */
 class UIRendererSortComparator
 {
 public:
-	bool operator() (const std::pair<HandlePool<UIRenderer::Entity>::WeakHandle, UIRenderer::Entity>& p1, const std::pair<HandlePool<UIRenderer::Entity>::WeakHandle, UIRenderer::Entity>& p2)
+	bool operator() (const UIRenderer::Entity* e1, const UIRenderer::Entity* e2)
 	{
 		// 3,2 is the location of z position in the matrix
-		return p1.second.renderable->getTransform()[3][2] < p2.second.renderable->getTransform()[3][2];
+		return e1->renderable->getTransform()[3][2] < e2->renderable->getTransform()[3][2];
 	}
 };
 
 struct UIRenderer::Impl
 {
-	/*! Pool of elements which have been initialized. */
+	Impl() : pool(HandlePoolOrder_Stable) { }
+
+	/*! Pool of elements which have been initialized, in the order they were added. */
 	HandlePool<UIRenderer::Entity> pool;
 
-	/*! List of entities sorted by z position, used when drawing. */
-	std::list<std::pair<HandlePool<UIRenderer::Entity>::WeakHandle, UIRenderer::Entity>> sortedEntities;
+	/*! The elements in the pool sorted by z position, rebuilt on each draw. The sort is
+		stable and starts from the pool's order, so elements at the same z are drawn in
+		the order they were added. Kept to reuse its memory. */
+	std::vector<UIRenderer::Entity*> drawOrder;
 
 	/*! Projection to use when drawing elements. */
 	glm::mat4 projection;
@@ -62,11 +68,7 @@ UIRenderer::UIElementHandle UIRenderer::getEntityHandle(const std::shared_ptr<Re
 	entity.renderable = renderable;
 	entity.shader = *shader.impl;
 
-	UIElementHandle handle = impl->pool.getNewHandle(entity);
-	HandlePool<UIRenderer::Entity>::WeakHandle weakHandle(handle);
-	impl->sortedEntities.push_back(std::make_pair(weakHandle, entity));
-
-	return handle;
+	return impl->pool.getNewHandle(entity);
 }
 
 void UIRenderer::draw()
@@ -74,23 +76,20 @@ void UIRenderer::draw()
 	// We can't sort only when an element is added - elements' transforms might change
 	// without us knowing. That being said, this is going to be slow for large amounts
 	// of UI elements. Right now we don't have that many...
-	impl->sortedEntities.sort(impl->comparator);
+	impl->drawOrder.clear();
+	for (auto iter = impl->pool.begin(); iter != impl->pool.end(); ++iter) {
+		impl->drawOrder.push_back(&*iter);
+	}
+	std::stable_sort(impl->drawOrder.begin(), impl->drawOrder.end(), impl->comparator);
 
 	glDisable(GL_DEPTH_TEST);
 
-	auto iter = impl->sortedEntities.begin();
-	while (iter != impl->sortedEntities.end())
+	for (Entity* entityPtr : impl->drawOrder)
 	{
-		if (iter->first.expired()) {
-			iter = impl->sortedEntities.erase(iter);
-			continue;
-		}
-
-		Entity& entity = iter->second;
+		Entity& entity = *entityPtr;
 		assert(entity.renderable != NULL);
 
 		if (!entity.renderable->getIsVisible()) {
-			++iter;
 			continue;
 		}
 
@@ -109,8 +108,6 @@ void UIRenderer::draw()
 		glDrawElements(glDrawTypeFromMaterial(material), renderable.getIndexCount(), GL_UNSIGNED_INT, 0);
 		glBindVertexArray(0);
 		glCheckError();
-
-		++iter;
 	}
 
 	glEnable(GL_DEPTH_TEST);
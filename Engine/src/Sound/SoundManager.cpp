@@ -70,7 +70,7 @@ bool SoundManager::initialize()
 		freeSources.push_back(i);
 
 		sources[i].alSource = alSources[i];
-		sources[i].logicalSourceHandle = 0;
+		sources[i].logicalSourceHandle = nullptr;
 		sources[i].playing = false;
 		sources[i].startPlaying = false;
 
@@ -208,7 +208,7 @@ void SoundManager::update()
 	}
 
 	for (auto iter = sourcePool.begin(); iter != sourcePool.end(); ++iter) {
-		iter->second.dirty = false;
+		iter->dirty = false;
 	}
 
 	alListener3f(AL_POSITION, listenerPosition.x, listenerPosition.y, listenerPosition.z);
@@ -243,7 +243,7 @@ void SoundManager::freeSource(unsigned sourceIndex)
 	freeSources.push_back(sourceIndex);
 
 	// If anyone tries to stop this clip from playing in the future, noop it
-	*source.clipHandle = sources.size();
+	clipPool.erase(source.clipHandle);
 	source.logicalSourceHandle = sourcePool.invalidHandle;
 	source.clipHandle = clipPool.invalidHandle;
 }
@@ -0,0 +1,79 @@
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<bool> counting(false);
+	std::atomic<size_t> allocations(0);
+	std::atomic<size_t> bytes(0);
+
+	void* allocate(size_t size)
+	{
+		if (counting) {
+			allocations++;
+			bytes += size;
+		}
+
+		void* p = std::malloc(size == 0 ? 1 : size);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// The standard library allocates some temporary buffers, such as std::stable_sort's, with the
+// nothrow forms, so they have to be counted and freed the same way as the rest
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	try {
+		return allocate(size);
+	} catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	try {
+		return allocate(size);
+	} catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+AllocationCounter::AllocationCounter()
+{
+	allocations = 0;
+	bytes = 0;
+	counting = true;
+}
+
+AllocationCounter::~AllocationCounter()
+{
+	counting = false;
+}
+
+size_t AllocationCounter::getAllocations() const
+{
+	return allocations;
+}
+
+size_t AllocationCounter::getBytes() const
+{
+	return bytes;
+}
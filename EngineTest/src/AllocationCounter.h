@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+/*! Counts heap allocations made through the global operator new while in scope, so
+	tests can check that a code path doesn't allocate. Only one may be live at a time,
+	and allocations on every thread are counted. */
+class AllocationCounter
+{
+public:
+	AllocationCounter();
+	~AllocationCounter();
+
+	AllocationCounter(const AllocationCounter&) = delete;
+	AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+	/*!
+	 * \brief Returns the number of allocations since construction.
+	 */
+	size_t getAllocations() const;
+
+	/*!
+	 * \brief Returns the number of bytes allocated since construction.
+	 */
+	size_t getBytes() const;
+};
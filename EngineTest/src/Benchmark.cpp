@@ -0,0 +1,4 @@
+
+#include "Benchmark.h"
+
+volatile unsigned long long benchmarkSink = 0;
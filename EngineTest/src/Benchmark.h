@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+/*! Benchmarks are tagged [.][benchmark] so they are hidden from a normal test run.
+	Run them explicitly with `EngineTest [benchmark]`. */
+
+/*!
+ * \brief Runs a function repeatedly and returns the mean time taken per run.
+ * \param runs The number of times to run the function.
+ * \param func The function to time.
+ * \return Mean time per run in microseconds.
+ */
+template <class Func>
+double benchmark(unsigned runs, Func func)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned i = 0; i < runs; i++) {
+		func();
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::micro>(end - start).count() / runs;
+}
+
+/*!
+ * \brief Prints a single benchmark result in a consistent format.
+ */
+inline void reportBenchmark(const char* name, unsigned count, double micros)
+{
+	printf("%-48s n=%-7u %12.2fus %10.2fns/item\n", name, count, micros, micros * 1000.0 / count);
+}
+
+/*! Results are accumulated here so the optimizer can't throw away the work being timed. */
+extern volatile unsigned long long benchmarkSink;
@@ -0,0 +1,202 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "Framework/World.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+TEST_CASE ( "Bitmask set and unset bits", "[bitmask]" )
+{
+	BasicComponentBitmask<200> mask;
+	mask.setBit(0, true);
+	mask.setBit(63, true);
+	mask.setBit(64, true);
+	mask.setBit(199, true);
+
+	REQUIRE ( mask.isBitSet(0) );
+	REQUIRE ( mask.isBitSet(63) );
+	REQUIRE ( mask.isBitSet(64) );
+	REQUIRE ( mask.isBitSet(199) );
+	REQUIRE ( !mask.isBitSet(1) );
+	REQUIRE ( !mask.isBitSet(128) );
+
+	mask.setBit(63, false);
+	REQUIRE ( !mask.isBitSet(63) );
+	REQUIRE ( mask.isBitSet(64) );
+
+	// Past the end is never set, rather than reading out of bounds
+	REQUIRE ( !mask.isBitSet(200) );
+	REQUIRE ( !mask.isBitSet(UINT32_MAX) );
+}
+
+TEST_CASE ( "Bitmask hasComponents checks every unit", "[bitmask]" )
+{
+	BasicComponentBitmask<256> entity, required;
+	REQUIRE ( entity.hasComponents(required) );
+
+	entity.setBit(3, true);
+	entity.setBit(130, true);
+	entity.setBit(250, true);
+
+	required.setBit(3, true);
+	REQUIRE ( entity.hasComponents(required) );
+	required.setBit(250, true);
+	REQUIRE ( entity.hasComponents(required) );
+	required.setBit(131, true);
+	REQUIRE ( !entity.hasComponents(required) );
+	REQUIRE ( required.hasComponents(BasicComponentBitmask<256>()) );
+
+	// Odd unit counts take the scalar tail
+	BasicComponentBitmask<130> small, smallRequired;
+	small.setBit(129, true);
+	smallRequired.setBit(129, true);
+	REQUIRE ( small.hasComponents(smallRequired) );
+	smallRequired.setBit(5, true);
+	REQUIRE ( !small.hasComponents(smallRequired) );
+}
+
+TEST_CASE ( "Bitmask visits each set bit", "[bitmask]" )
+{
+	BasicComponentBitmask<200> mask;
+	std::vector<msize_t> bits;
+	mask.forEachSetBit([&](msize_t bit) { bits.push_back(bit); });
+	REQUIRE ( bits.empty() );
+
+	mask.setBit(199, true);
+	mask.setBit(0, true);
+	mask.setBit(64, true);
+	mask.setBit(63, true);
+	mask.forEachSetBit([&](msize_t bit) { bits.push_back(bit); });
+	REQUIRE ( bits == std::vector<msize_t>({ 0, 63, 64, 199 }) );
+}
+
+namespace
+{
+	/*! The vector-backed bitmask World used before the fixed-width one, kept here for comparison. */
+	class VectorBitmask
+	{
+	public:
+		void setBit(msize_t bit, bool set)
+		{
+			while (mask.size() <= bit / 32) {
+				mask.push_back(0);
+			}
+			if (set) {
+				mask[bit / 32] |= (1u << (bit % 32));
+			} else {
+				mask[bit / 32] &= ~(1u << (bit % 32));
+			}
+		}
+
+		bool hasComponents(const VectorBitmask& other) const
+		{
+			if (other.mask.size() > mask.size()) {
+				return false;
+			}
+			for (unsigned i = 0; i < other.mask.size(); i++) {
+				if ((mask[i] & other.mask[i]) != other.mask[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+	private:
+		std::vector<uint32_t> mask;
+	};
+
+	struct VectorEntity
+	{
+		std::string name;
+		VectorBitmask components;
+	};
+
+	template <int I>
+	struct BitmaskComponent : public Component { };
+
+	template <int I>
+	void maybeAdd(World& world, eid_t entity, unsigned bits)
+	{
+		if (bits & (1 << I)) {
+			world.addComponent<BitmaskComponent<I>>(entity);
+		}
+	}
+
+	void benchmarkBitmaskMatching(unsigned entityCount)
+	{
+		std::default_random_engine random(1234);
+		std::uniform_int_distribution<unsigned> bitsDistribution(0, 255);
+
+		World world;
+		std::map<eid_t, VectorEntity> vectorEntities;
+		for (unsigned i = 0; i < entityCount; i++) {
+			unsigned bits = bitsDistribution(random);
+			eid_t entity = world.getNewEntity("e");
+			maybeAdd<0>(world, entity, bits); maybeAdd<1>(world, entity, bits);
+			maybeAdd<2>(world, entity, bits); maybeAdd<3>(world, entity, bits);
+			maybeAdd<4>(world, entity, bits); maybeAdd<5>(world, entity, bits);
+			maybeAdd<6>(world, entity, bits); maybeAdd<7>(world, entity, bits);
+
+			VectorEntity& vectorEntity = vectorEntities[entity];
+			vectorEntity.name = "e";
+			for (msize_t bit = 0; bit < 8; bit++) {
+				vectorEntity.components.setBit(world.getComponentId<BitmaskComponent<0>>() + bit, (bits & (1 << bit)) != 0);
+			}
+		}
+
+		ComponentBitmask match;
+		match.setBit(world.getComponentId<BitmaskComponent<2>>(), true);
+		match.setBit(world.getComponentId<BitmaskComponent<5>>(), true);
+		VectorBitmask vectorMatch;
+		vectorMatch.setBit(world.getComponentId<BitmaskComponent<2>>(), true);
+		vectorMatch.setBit(world.getComponentId<BitmaskComponent<5>>(), true);
+
+		const unsigned runs = std::max(1u, 1000000u / entityCount);
+		double vectorTime = benchmark(runs, [&]() {
+			unsigned long long sum = 0;
+			for (auto& pair : vectorEntities) {
+				if (pair.second.components.hasComponents(vectorMatch)) {
+					sum += pair.first;
+				}
+			}
+			benchmarkSink += sum;
+		});
+		double iteratorTime = benchmark(runs, [&]() {
+			unsigned long long sum = 0;
+			for (World::eid_iterator iter = world.getEidIterator(match); !iter.atEnd(); iter.next()) {
+				sum += iter.value();
+			}
+			benchmarkSink += sum;
+		});
+
+		// entityHasComponents copies the entity's bitmask, like orderEntities does for every collision
+		double vectorLookupTime = benchmark(runs, [&]() {
+			unsigned long long sum = 0;
+			for (eid_t i = 0; i < entityCount; i++) {
+				VectorBitmask components = vectorEntities.find(i)->second.components;
+				sum += components.hasComponents(vectorMatch);
+			}
+			benchmarkSink += sum;
+		});
+		double lookupTime = benchmark(runs, [&]() {
+			unsigned long long sum = 0;
+			for (eid_t i = 0; i < entityCount; i++) {
+				sum += world.entityHasComponents(i, match);
+			}
+			benchmarkSink += sum;
+		});
+
+		reportBenchmark("vector bitmask map walk", entityCount, vectorTime);
+		reportBenchmark("fixed bitmask eid_iterator", entityCount, iteratorTime);
+		reportBenchmark("vector bitmask copy and match", entityCount, vectorLookupTime);
+		reportBenchmark("fixed bitmask entityHasComponents", entityCount, lookupTime);
+	}
+}
+
+TEST_CASE ( "Bitmask matching: vector vs fixed-width", "[.][benchmark]" )
+{
+	benchmarkBitmaskMatching(1000);
+	benchmarkBitmaskMatching(10000);
+	benchmarkBitmaskMatching(100000);
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "Framework/ComponentPool.h"
+#include "Framework/World.h"
+
+#include <unordered_map>
+#include <random>
+#include <algorithm>
+
+namespace
+{
+	struct CountedComponent : public Component
+	{
+		CountedComponent() : CountedComponent(0) { }
+		CountedComponent(int value) : value(value) { ++alive; }
+		CountedComponent(CountedComponent&& other) : value(other.value) { ++alive; }
+		~CountedComponent() { --alive; }
+		int value;
+		static int alive;
+	};
+	int CountedComponent::alive = 0;
+
+	struct BenchComponent : public Component
+	{
+		BenchComponent() : x(0.0f), y(0.0f), z(0.0f), id(0) { }
+		float x, y, z;
+		unsigned id;
+	};
+}
+
+TEST_CASE ( "Component pool emplace and get", "[componentpool]" )
+{
+	ComponentPool<CountedComponent> pool;
+	pool.emplace(3, 30);
+	pool.emplace(10000, 100);
+
+	REQUIRE ( pool.size() == 2 );
+	REQUIRE ( pool.has(3) );
+	REQUIRE ( pool.has(10000) );
+	REQUIRE ( !pool.has(4) );
+	REQUIRE ( !pool.has(99999) );
+	REQUIRE ( pool.get(3)->value == 30 );
+	REQUIRE ( pool.get(10000)->value == 100 );
+	REQUIRE ( pool.get(4) == nullptr );
+}
+
+TEST_CASE ( "Component pool swap-and-pop removal", "[componentpool]" )
+{
+	CountedComponent::alive = 0;
+	{
+		ComponentPool<CountedComponent> pool;
+		for (eid_t i = 0; i < 5; i++) {
+			pool.emplace(i, (int)i);
+		}
+
+		pool.remove(1);
+		REQUIRE ( pool.size() == 4 );
+		REQUIRE ( !pool.has(1) );
+		REQUIRE ( CountedComponent::alive == 4 );
+
+		// The last component fills the hole
+		REQUIRE ( pool.getEntities()[1] == 4 );
+		REQUIRE ( pool.at(1).value == 4 );
+		REQUIRE ( pool.get(4)->value == 4 );
+
+		// Removing something that isn't there is fine
+		pool.remove(1);
+		REQUIRE ( pool.size() == 4 );
+
+		// Removing the last element doesn't move anything
+		pool.remove(4);
+		REQUIRE ( pool.size() == 3 );
+		REQUIRE ( pool.get(0)->value == 0 );
+		REQUIRE ( pool.get(2)->value == 2 );
+		REQUIRE ( pool.get(3)->value == 3 );
+	}
+	REQUIRE ( CountedComponent::alive == 0 );
+}
+
+TEST_CASE ( "Component pool keeps addresses stable while growing", "[componentpool]" )
+{
+	ComponentPool<CountedComponent> pool;
+	CountedComponent* first = pool.emplace(0, 7);
+	for (eid_t i = 1; i < 10000; i++) {
+		pool.emplace(i, (int)i);
+	}
+
+	REQUIRE ( pool.get(0) == first );
+	REQUIRE ( first->value == 7 );
+
+	pool.clear();
+	REQUIRE ( pool.size() == 0 );
+	REQUIRE ( !pool.has(0) );
+}
+
+TEST_CASE ( "World stores components in pools", "[componentpool][world]" )
+{
+	World world;
+	eid_t a = world.getNewEntity("a");
+	eid_t b = world.getNewEntity("b");
+
+	world.addComponent<CountedComponent>(a)->value = 1;
+	world.addComponent<CountedComponent>(b)->value = 2;
+	REQUIRE ( world.getComponent<CountedComponent>(a)->value == 1 );
+	REQUIRE ( world.getEntitiesWithComponent<CountedComponent>().size() == 2 );
+
+	world.removeComponent<CountedComponent>(a);
+	REQUIRE ( world.getComponent<CountedComponent>(a) == nullptr );
+	REQUIRE ( world.getComponent<CountedComponent>(b)->value == 2 );
+
+	world.removeEntity(b);
+	world.cleanupEntities();
+	REQUIRE ( world.getEntitiesWithComponent<CountedComponent>().size() == 0 );
+}
+
+namespace
+{
+	/*! The layout World used before component pools, kept here for comparison. */
+	typedef std::unordered_map<eid_t, std::unique_ptr<Component>> MapComponentPool;
+
+	void benchmarkComponentStorage(unsigned entityCount)
+	{
+		std::vector<eid_t> lookupOrder(entityCount);
+		for (unsigned i = 0; i < entityCount; i++) {
+			lookupOrder[i] = i;
+		}
+		std::shuffle(lookupOrder.begin(), lookupOrder.end(), std::default_random_engine(1234));
+
+		const unsigned runs = std::max(1u, 1000000u / entityCount);
+
+		MapComponentPool mapPool;
+		ComponentPool<BenchComponent> densePool;
+
+		double mapInsert = benchmark(1, [&]() {
+			for (eid_t i = 0; i < entityCount; i++) {
+				BenchComponent* component = new BenchComponent();
+				component->id = i;
+				mapPool.emplace(i, std::unique_ptr<Component>(component));
+			}
+		});
+		double denseInsert = benchmark(1, [&]() {
+			for (eid_t i = 0; i < entityCount; i++) {
+				densePool.emplace(i)->id = i;
+			}
+		});
+
+		double mapLookup = benchmark(runs, [&]() {
+			unsigned long long sum = 0;
+			for (eid_t eid : lookupOrder) {
+				sum += static_cast<BenchComponent*>(mapPool.find(eid)->second.get())->id;
+			}
+			benchmarkSink += sum;
+		});
+		double denseLookup = benchmark(runs, [&]() {
+			unsigned long long sum = 0;
+			for (eid_t eid : lookupOrder) {
+				sum += densePool.get(eid)->id;
+			}
+			benchmarkSink += sum;
+		});
+
+		double mapIterate = benchmark(runs, [&]() {
+			for (auto& pair : mapPool) {
+				BenchComponent* component = static_cast<BenchComponent*>(pair.second.get());
+				component->x += 1.0f;
+			}
+		});
+		double denseIterate = benchmark(runs, [&]() {
+			for (size_t i = 0; i < densePool.size(); i++) {
+				densePool.at(i).x += 1.0f;
+			}
+		});
+
+		double mapRemove = benchmark(1, [&]() {
+			for (eid_t eid : lookupOrder) {
+				mapPool.erase(eid);
+			}
+		});
+		double denseRemove = benchmark(1, [&]() {
+			for (eid_t eid : lookupOrder) {
+				densePool.remove(eid);
+			}
+		});
+
+		reportBenchmark("map insert", entityCount, mapInsert);
+		reportBenchmark("pool insert", entityCount, denseInsert);
+		reportBenchmark("map random lookup", entityCount, mapLookup);
+		reportBenchmark("pool random lookup", entityCount, denseLookup);
+		reportBenchmark("map iterate", entityCount, mapIterate);
+		reportBenchmark("pool iterate", entityCount, denseIterate);
+		reportBenchmark("map remove", entityCount, mapRemove);
+		reportBenchmark("pool remove", entityCount, denseRemove);
+	}
+}
+
+TEST_CASE ( "Component storage: map of unique_ptr vs component pool", "[.][benchmark]" )
+{
+	benchmarkComponentStorage(1000);
+	benchmarkComponentStorage(10000);
+	benchmarkComponentStorage(100000);
+}
@@ -0,0 +1,83 @@
+#include "catch.hpp"
+#include "AllocationCounter.h"
+#include "Framework/EventChannel.h"
+
+#include <memory>
+#include <vector>
+
+TEST_CASE ( "Channel capacity is rounded up to a power of two", "[eventchannel]" )
+{
+	EventChannel<int> channel(100);
+	REQUIRE ( channel.capacity() == 128 );
+
+	EventChannel<int> exact(64);
+	REQUIRE ( exact.capacity() == 64 );
+}
+
+TEST_CASE ( "Channels drain in posting order and wrap around the ring", "[eventchannel]" )
+{
+	EventChannel<int> channel(4);
+	std::vector<int> drained;
+	auto consumer = [&](int&& value) { drained.push_back(value); };
+
+	// Several laps of the ring, with the positions landing differently each time
+	int next = 0;
+	for (int lap = 0; lap < 10; lap++) {
+		int count = lap % 4 + 1;
+		for (int i = 0; i < count; i++) {
+			REQUIRE ( channel.post(next++) );
+		}
+		REQUIRE ( channel.drain(consumer) == (size_t)count );
+	}
+
+	REQUIRE ( drained.size() == (size_t)next );
+	for (int i = 0; i < next; i++) {
+		REQUIRE ( drained[i] == i );
+	}
+	REQUIRE ( channel.drain(consumer) == 0 );
+}
+
+TEST_CASE ( "Full channels drop posts and count them", "[eventchannel]" )
+{
+	EventChannel<int> channel(4);
+	for (int i = 0; i < 4; i++) {
+		REQUIRE ( channel.post(i) );
+	}
+	REQUIRE ( !channel.post(4) );
+	REQUIRE ( !channel.post(5) );
+
+	int sum = 0;
+	REQUIRE ( channel.drain([&](int&& value) { sum += value; }) == 4 );
+	REQUIRE ( sum == 0 + 1 + 2 + 3 );
+
+	EventChannel<int>::Stats stats = channel.getStats();
+	REQUIRE ( stats.drained == 4 );
+	REQUIRE ( stats.dropped == 2 );
+	REQUIRE ( stats.peak == 4 );
+
+	// There is room again once drained
+	REQUIRE ( channel.post(6) );
+	channel.resetStats();
+	stats = channel.getStats();
+	REQUIRE ( stats.drained == 0 );
+	REQUIRE ( stats.dropped == 0 );
+	REQUIRE ( stats.peak == 0 );
+}
+
+TEST_CASE ( "Posting and draining don't allocate", "[eventchannel]" )
+{
+	EventChannel<int> channel(256);
+	int sum = 0;
+
+	AllocationCounter counter;
+	for (int frame = 0; frame < 100; frame++) {
+		for (int i = 0; i < 200; i++) {
+			channel.post(i);
+		}
+		channel.drain([&](int&& value) { sum += value; });
+	}
+	size_t allocations = counter.getAllocations();
+
+	REQUIRE ( allocations == 0 );
+	REQUIRE ( sum == 100 * (199 * 200 / 2) );
+}
@@ -0,0 +1,492 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+#include "Framework/EventManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	class HitEvent : public Event
+	{
+	public:
+		HitEvent() : target(0), damage(0) { }
+		HitEvent(eid_t target, int damage) : target(target), damage(damage) { }
+		eid_t target;
+		int damage;
+	};
+
+	class DeathEvent : public Event
+	{
+	public:
+		eid_t target;
+	};
+
+	/*! Shaped like the game's responders, which pick out the events about their entities. */
+	struct HitResponder
+	{
+		HitResponder(eid_t watched) : watched(watched), total(0) { }
+
+		void handleHit(const HitEvent& event)
+		{
+			if (event.target == watched) {
+				total += event.damage;
+			}
+		}
+
+		void handleHits(Span<const HitEvent> events)
+		{
+			for (const HitEvent& event : events) {
+				handleHit(event);
+			}
+		}
+
+		eid_t watched;
+		unsigned long long total;
+	};
+}
+
+TEST_CASE ( "Queued events are delivered in batches on dispatch", "[events]" )
+{
+	World world;
+	EventManager eventManager(world);
+
+	std::vector<int> batchSizes;
+	std::vector<int> damages;
+	std::vector<int> singleDamages;
+	EventSubscription batchSubscription = eventManager.registerForEvents<HitEvent>([&](Span<const HitEvent> events) {
+		batchSizes.push_back((int)events.size());
+		for (const HitEvent& event : events) {
+			damages.push_back(event.damage);
+		}
+	});
+	EventSubscription singleSubscription = eventManager.registerForEvent<HitEvent>([&](const HitEvent& event) {
+		singleDamages.push_back(event.damage);
+	});
+
+	eventManager.queueEvent(HitEvent(1, 10));
+	eventManager.queueEvent(HitEvent(2, 20));
+	eventManager.queueEvent(HitEvent(3, 30));
+	REQUIRE ( damages.empty() );
+	REQUIRE ( singleDamages.empty() );
+
+	eventManager.dispatchEvents();
+	REQUIRE ( batchSizes == std::vector<int>({ 3 }) );
+	REQUIRE ( damages == std::vector<int>({ 10, 20, 30 }) );
+	REQUIRE ( singleDamages == std::vector<int>({ 10, 20, 30 }) );
+
+	// Nothing left over for the next dispatch
+	eventManager.dispatchEvents();
+	REQUIRE ( batchSizes.size() == 1 );
+
+	// Sent events skip the queue, and only reach the single-event listeners
+	eventManager.sendEvent(HitEvent(4, 40));
+	REQUIRE ( singleDamages.back() == 40 );
+	REQUIRE ( damages.size() == 3 );
+
+	// Events nobody listens for go nowhere
+	eventManager.queueEvent(DeathEvent());
+	eventManager.dispatchEvents();
+}
+
+TEST_CASE ( "Events queued by listeners are dispatched in the same pass", "[events]" )
+{
+	World world;
+	EventManager eventManager(world);
+
+	std::vector<eid_t> deaths;
+	EventSubscription hitSubscription = eventManager.registerForEvents<HitEvent>([&](Span<const HitEvent> events) {
+		for (const HitEvent& event : events) {
+			if (event.damage >= 100) {
+				DeathEvent death;
+				death.target = event.target;
+				eventManager.queueEvent(death);
+			}
+		}
+	});
+	EventSubscription deathSubscription = eventManager.registerForEvent<DeathEvent>([&](const DeathEvent& event) {
+		deaths.push_back(event.target);
+		// A follow-up hit, in the same type as the batch being delivered
+		eventManager.queueEvent(HitEvent(event.target + 10, 1));
+	});
+
+	eventManager.queueEvent(HitEvent(1, 100));
+	eventManager.queueEvent(HitEvent(2, 5));
+	eventManager.queueEvent(HitEvent(3, 150));
+	eventManager.dispatchEvents();
+	REQUIRE ( deaths == std::vector<eid_t>({ 1, 3 }) );
+}
+
+TEST_CASE ( "Events can be queued from several threads at once", "[events]" )
+{
+	const unsigned threadCount = 4;
+	const unsigned eventsPerThread = 2000;
+
+	World world;
+	EventManager eventManager(world);
+	std::vector<HitEvent> received;
+	EventSubscription subscription = eventManager.registerForEvents<HitEvent>([&](Span<const HitEvent> events) {
+		received.insert(received.end(), events.begin(), events.end());
+	});
+
+	std::vector<std::thread> threads;
+	for (unsigned i = 0; i < threadCount; i++) {
+		threads.emplace_back([&, i]() {
+			for (unsigned j = 0; j < eventsPerThread; j++) {
+				eventManager.queueEvent(HitEvent(i, (int)j));
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	eventManager.dispatchEvents();
+
+	REQUIRE ( received.size() == threadCount * eventsPerThread );
+	// Each thread's events stay in the order it queued them
+	std::vector<int> next(threadCount, 0);
+	for (const HitEvent& event : received) {
+		REQUIRE ( event.damage == next[event.target]++ );
+	}
+}
+
+TEST_CASE ( "Queueing events reaches a steady state without allocating", "[events]" )
+{
+	World world;
+	EventManager eventManager(world);
+	int total = 0;
+	EventSubscription subscription = eventManager.registerForEvents<HitEvent>([&](Span<const HitEvent> events) {
+		for (const HitEvent& event : events) {
+			total += event.damage;
+		}
+	});
+
+	auto frame = [&]() {
+		for (int i = 0; i < 64; i++) {
+			eventManager.queueEvent(HitEvent(i, 1));
+		}
+		eventManager.dispatchEvents();
+	};
+	// The buffers swap on each dispatch, so both have to grow
+	frame();
+	frame();
+
+	AllocationCounter counter;
+	for (int i = 0; i < 100; i++) {
+		frame();
+	}
+	size_t allocations = counter.getAllocations();
+
+	REQUIRE ( allocations == 0 );
+	REQUIRE ( total == 64 * 102 );
+}
+
+TEST_CASE ( "Subscriptions unregister their listeners when released", "[events]" )
+{
+	World world;
+	EventManager eventManager(world);
+	int first = 0, second = 0, batches = 0;
+
+	EventSubscription firstSubscription = eventManager.registerForEvent<HitEvent>([&](const HitEvent& event) { first++; });
+	{
+		EventSubscription secondSubscription = eventManager.registerForEvent<HitEvent>([&](const HitEvent& event) { second++; });
+		eventManager.sendEvent(HitEvent());
+		REQUIRE ( first == 1 );
+		REQUIRE ( second == 1 );
+	}
+	eventManager.sendEvent(HitEvent());
+	REQUIRE ( first == 2 );
+	REQUIRE ( second == 1 );
+
+	// Moving a subscription moves the registration with it
+	EventSubscription moved = std::move(firstSubscription);
+	REQUIRE ( !firstSubscription.isActive() );
+	REQUIRE ( moved.isActive() );
+	eventManager.sendEvent(HitEvent());
+	REQUIRE ( first == 3 );
+
+	moved.reset();
+	REQUIRE ( !moved.isActive() );
+	eventManager.sendEvent(HitEvent());
+	REQUIRE ( first == 3 );
+
+	EventSubscription batchSubscription = eventManager.registerForEvents<HitEvent>([&](Span<const HitEvent> events) { batches++; });
+	eventManager.queueEvent(HitEvent());
+	eventManager.dispatchEvents();
+	batchSubscription = EventSubscription();
+	eventManager.queueEvent(HitEvent());
+	eventManager.dispatchEvents();
+	REQUIRE ( batches == 1 );
+}
+
+TEST_CASE ( "Listeners are removed in any order without disturbing the rest", "[events]" )
+{
+	const int listenerCount = 200;
+
+	World world;
+	EventManager eventManager(world);
+	std::vector<int> calls(listenerCount, 0);
+	std::vector<EventSubscription> subscriptions;
+	for (int i = 0; i < listenerCount; i++) {
+		subscriptions.push_back(eventManager.registerForEvent<HitEvent>([&calls, i](const HitEvent& event) { calls[i]++; }));
+	}
+
+	// Remove every third listener, from the back and the middle, then add a few more into the freed IDs
+	std::vector<bool> removed(listenerCount, false);
+	for (int i = listenerCount - 1; i >= 0; i -= 3) {
+		subscriptions[i].reset();
+		removed[i] = true;
+	}
+	for (int i = 0; i < 10; i++) {
+		subscriptions.push_back(eventManager.registerForEvent<HitEvent>([&calls](const HitEvent& event) { calls[0] += 100; }));
+	}
+	eventManager.sendEvent(HitEvent());
+
+	for (int i = 1; i < listenerCount; i++) {
+		REQUIRE ( calls[i] == (removed[i] ? 0 : 1) );
+	}
+	REQUIRE ( calls[0] == (removed[0] ? 0 : 1) + 1000 );
+}
+
+TEST_CASE ( "Listeners can come and go while events are being delivered", "[events]" )
+{
+	World world;
+	EventManager eventManager(world);
+	std::vector<std::string> calls;
+
+	EventSubscription first, second, third, added;
+	first = eventManager.registerForEvent<HitEvent>([&](const HitEvent& event) {
+		calls.push_back("first");
+		// Unsubscribes a listener which hasn't been called yet, and itself
+		third.reset();
+		first.reset();
+		if (!added.isActive()) {
+			added = eventManager.registerForEvent<HitEvent>([&](const HitEvent& event) { calls.push_back("added"); });
+		}
+	});
+	second = eventManager.registerForEvent<HitEvent>([&](const HitEvent& event) {
+		calls.push_back("second");
+		// Nested delivery of the same type doesn't call removed listeners either
+		if (event.damage == 0) {
+			eventManager.sendEvent(HitEvent(0, 1));
+		}
+	});
+	third = eventManager.registerForEvent<HitEvent>([&](const HitEvent& event) { calls.push_back("third"); });
+
+	eventManager.sendEvent(HitEvent(0, 0));
+	REQUIRE ( calls == std::vector<std::string>({ "first", "second", "second" }) );
+
+	// The listener added during delivery hears about the next event
+	calls.clear();
+	eventManager.sendEvent(HitEvent(0, 1));
+	REQUIRE ( calls.size() == 2 );
+	REQUIRE ( std::count(calls.begin(), calls.end(), "second") == 1 );
+	REQUIRE ( std::count(calls.begin(), calls.end(), "added") == 1 );
+
+	// One added and removed within the same delivery is never called
+	calls.clear();
+	EventSubscription transient;
+	EventSubscription adder = eventManager.registerForEvent<DeathEvent>([&](const DeathEvent& event) {
+		transient = eventManager.registerForEvent<DeathEvent>([&](const DeathEvent& event) { calls.push_back("transient"); });
+		transient.reset();
+	});
+	eventManager.sendEvent(DeathEvent());
+	adder.reset();
+	eventManager.sendEvent(DeathEvent());
+	REQUIRE ( calls.empty() );
+}
+
+TEST_CASE ( "Posted events are delivered on dispatch with queued ones", "[events]" )
+{
+	World world;
+	EventManager eventManager(world);
+	std::vector<int> damages;
+	EventSubscription subscription = eventManager.registerForEvents<HitEvent>([&](Span<const HitEvent> events) {
+		for (const HitEvent& event : events) {
+			damages.push_back(event.damage);
+		}
+	});
+
+	// Posting needs a channel
+	REQUIRE ( !eventManager.post(HitEvent(0, 1)) );
+
+	eventManager.openChannel<HitEvent>(4);
+	eventManager.queueEvent(HitEvent(0, 10));
+	for (int i = 0; i < 4; i++) {
+		REQUIRE ( eventManager.post(HitEvent(0, 20 + i)) );
+	}
+	REQUIRE ( !eventManager.post(HitEvent(0, 30)) );
+	REQUIRE ( damages.empty() );
+
+	eventManager.dispatchEvents();
+	REQUIRE ( damages == std::vector<int>({ 10, 20, 21, 22, 23 }) );
+
+	EventChannel<HitEvent>::Stats stats = eventManager.getChannelStats<HitEvent>();
+	REQUIRE ( stats.drained == 4 );
+	REQUIRE ( stats.dropped == 1 );
+	REQUIRE ( stats.peak == 4 );
+
+	// Channels can be opened for types nobody listens to; their events go nowhere
+	eventManager.openChannel<DeathEvent>(16);
+	REQUIRE ( eventManager.post(DeathEvent()) );
+	eventManager.dispatchEvents();
+	REQUIRE ( eventManager.getChannelStats<DeathEvent>().drained == 1 );
+}
+
+TEST_CASE ( "Eight threads can post to a channel while it is drained", "[events]" )
+{
+	const unsigned threadCount = 8;
+	const unsigned eventsPerThread = 50000;
+
+	World world;
+	EventManager eventManager(world);
+	std::vector<HitEvent> received;
+	received.reserve(threadCount * eventsPerThread);
+	EventSubscription subscription = eventManager.registerForEvents<HitEvent>([&](Span<const HitEvent> events) {
+		received.insert(received.end(), events.begin(), events.end());
+	});
+	// Small enough that the producers keep filling it
+	eventManager.openChannel<HitEvent>(256);
+
+	std::atomic<uint64_t> retries(0);
+	std::vector<std::thread> threads;
+	for (unsigned i = 0; i < threadCount; i++) {
+		threads.emplace_back([&, i]() {
+			uint64_t failed = 0;
+			for (unsigned j = 0; j < eventsPerThread; j++) {
+				// Back off and try again when full, so that every event gets through
+				while (!eventManager.post(HitEvent(i, (int)j))) {
+					failed++;
+					std::this_thread::yield();
+				}
+			}
+			retries.fetch_add(failed);
+		});
+	}
+
+	while (received.size() < threadCount * eventsPerThread) {
+		eventManager.dispatchEvents();
+		std::this_thread::yield();
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	eventManager.dispatchEvents();
+
+	REQUIRE ( received.size() == threadCount * eventsPerThread );
+	// Each thread's events arrive once each, in the order it posted them
+	std::vector<int> next(threadCount, 0);
+	unsigned misplaced = 0;
+	for (const HitEvent& event : received) {
+		if (event.target >= threadCount || event.damage != next[event.target]++) {
+			misplaced++;
+		}
+	}
+	REQUIRE ( misplaced == 0 );
+
+	EventChannel<HitEvent>::Stats stats = eventManager.getChannelStats<HitEvent>();
+	REQUIRE ( stats.drained == threadCount * eventsPerThread );
+	REQUIRE ( stats.dropped == retries.load() );
+	REQUIRE ( stats.peak <= 256 );
+}
+
+TEST_CASE ( "Event delivery: sent vs queued", "[.][benchmark]" )
+{
+	const unsigned eventCount = 1000;
+	const unsigned runs = 2000;
+	const unsigned responderCount = 4;
+
+	World world;
+	std::vector<HitResponder> responders;
+	for (unsigned i = 0; i < responderCount; i++) {
+		responders.push_back(HitResponder(i));
+	}
+
+	// Registered the way the game's responders register, through a lambda calling a member function
+	EventManager eventManager(world);
+	std::vector<EventSubscription> subscriptions;
+	for (HitResponder& responder : responders) {
+		HitResponder* listener = &responder;
+		subscriptions.push_back(eventManager.registerForEvent<HitEvent>([listener](const HitEvent& event) { listener->handleHit(event); }));
+	}
+	double sentTime = benchmark(runs, [&]() {
+		for (unsigned i = 0; i < eventCount; i++) {
+			eventManager.sendEvent(HitEvent(i % 8, 1));
+		}
+	});
+	reportBenchmark("sendEvent, four listeners", eventCount, sentTime);
+
+	EventManager batchManager(world);
+	std::vector<EventSubscription> batchSubscriptions;
+	for (HitResponder& responder : responders) {
+		HitResponder* listener = &responder;
+		batchSubscriptions.push_back(batchManager.registerForEvents<HitEvent>([listener](Span<const HitEvent> events) { listener->handleHits(events); }));
+	}
+	double queuedTime = benchmark(runs, [&]() {
+		for (unsigned i = 0; i < eventCount; i++) {
+			batchManager.queueEvent(HitEvent(i % 8, 1));
+		}
+		batchManager.dispatchEvents();
+	});
+	reportBenchmark("queueEvent + dispatch, four batch listeners", eventCount, queuedTime);
+
+	for (HitResponder& responder : responders) {
+		benchmarkSink += responder.total;
+	}
+}
+
+TEST_CASE ( "Listener calls: std::function vs inline", "[.][benchmark]" )
+{
+	const unsigned eventCount = 1000000;
+	const unsigned runs = 10;
+	const unsigned responderCount = 4;
+
+	World world;
+	std::vector<HitResponder> responders;
+	for (unsigned i = 0; i < responderCount; i++) {
+		responders.push_back(HitResponder(i));
+	}
+
+	// How listeners used to be stored: the std::function a responder registered through
+	// std::bind, wrapped in another which casts the event back from its base class
+	std::vector<std::function<void(const Event*)>> wrappedListeners;
+	for (HitResponder& responder : responders) {
+		std::function<void(const HitEvent&)> listener = std::bind(&HitResponder::handleHit, &responder, std::placeholders::_1);
+		wrappedListeners.push_back([listener](const Event* event) {
+			listener(*static_cast<const HitEvent*>(event));
+		});
+	}
+	double wrappedTime = benchmark(runs, [&]() {
+		for (unsigned i = 0; i < eventCount; i++) {
+			HitEvent event(i % 8, 1);
+			for (std::function<void(const Event*)>& listener : wrappedListeners) {
+				listener(&event);
+			}
+		}
+	});
+	reportBenchmark("Nested std::function listeners, four listeners", eventCount, wrappedTime);
+
+	// The lambda is stored inline in the listener array, and the member function it calls
+	// is inlined into it
+	EventManager eventManager(world);
+	std::vector<EventSubscription> subscriptions;
+	for (HitResponder& responder : responders) {
+		HitResponder* listener = &responder;
+		subscriptions.push_back(eventManager.registerForEvent<HitEvent>([listener](const HitEvent& event) { listener->handleHit(event); }));
+	}
+	double inlineTime = benchmark(runs, [&]() {
+		for (unsigned i = 0; i < eventCount; i++) {
+			eventManager.sendEvent(HitEvent(i % 8, 1));
+		}
+	});
+	reportBenchmark("sendEvent with inline listeners, four listeners", eventCount, inlineTime);
+
+	for (HitResponder& responder : responders) {
+		benchmarkSink += responder.total;
+	}
+}
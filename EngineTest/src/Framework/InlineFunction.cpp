@@ -0,0 +1,84 @@
+#include "catch.hpp"
+#include "AllocationCounter.h"
+#include "Framework/InlineFunction.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+
+namespace
+{
+	/*! Counts how many copies of it are alive. */
+	struct Tracked
+	{
+		Tracked(int& alive) : alive(&alive) { (*this->alive)++; }
+		Tracked(const Tracked& other) : alive(other.alive) { (*alive)++; }
+		Tracked(Tracked&& other) noexcept : alive(other.alive) { (*alive)++; }
+		~Tracked() { (*alive)--; }
+		int* alive;
+	};
+
+	int triple(int value)
+	{
+		return value * 3;
+	}
+}
+
+TEST_CASE ( "Small callables are stored inline", "[inlinefunction]" )
+{
+	int base = 2;
+	auto lambda = [&base](int value) { return base + value; };
+	REQUIRE ( InlineFunction<int(int)>::fitsInline<decltype(lambda)>() );
+
+	AllocationCounter counter;
+	InlineFunction<int(int)> function(lambda);
+	InlineFunction<int(int)> pointer(&triple);
+	InlineFunction<int(int)> moved(std::move(function));
+	size_t allocations = counter.getAllocations();
+
+	REQUIRE ( allocations == 0 );
+	REQUIRE ( !function );
+	REQUIRE ( moved(5) == 7 );
+	REQUIRE ( pointer(5) == 15 );
+}
+
+TEST_CASE ( "Large callables are moved to the heap", "[inlinefunction]" )
+{
+	std::array<int, 32> values;
+	values.fill(1);
+	auto lambda = [values](int value) { return values[0] + values[31] + value; };
+	REQUIRE ( !InlineFunction<int(int)>::fitsInline<decltype(lambda)>() );
+
+	InlineFunction<int(int)> function(lambda);
+	InlineFunction<int(int)> moved;
+	moved = std::move(function);
+	REQUIRE ( !function );
+	REQUIRE ( moved(1) == 3 );
+}
+
+TEST_CASE ( "Callables are destroyed with the function", "[inlinefunction]" )
+{
+	int alive = 0;
+	{
+		Tracked tracked(alive);
+		InlineFunction<void()> small([tracked]() { });
+		std::array<char, 128> padding = {};
+		InlineFunction<void()> large([tracked, padding]() { });
+		REQUIRE ( alive == 3 );
+
+		InlineFunction<void()> moved(std::move(small));
+		REQUIRE ( alive == 3 );
+		moved.reset();
+		REQUIRE ( alive == 2 );
+
+		// Assigning over a function destroys what it held
+		large = InlineFunction<void()>([]() { });
+		REQUIRE ( alive == 1 );
+	}
+	REQUIRE ( alive == 0 );
+
+	// Move-only callables are fine too
+	std::unique_ptr<int> owned(new int(4));
+	InlineFunction<int()> function([owned = std::move(owned)]() { return *owned; });
+	REQUIRE ( function() == 4 );
+}
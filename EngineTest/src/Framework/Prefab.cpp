@@ -0,0 +1,338 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "Framework/World.h"
+#include "Framework/Prefab.h"
+#include "Framework/DefaultComponentConstructor.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct HealthComponent : public Component
+	{
+		struct Data {
+			Data() : health(100), maxHealth(100) { }
+			int health;
+			int maxHealth;
+		};
+		Data data;
+	};
+
+	struct VelocityComponent : public Component
+	{
+		struct Data {
+			Data() : velocity(), speed(0.0f) { }
+			float velocity[3];
+			float speed;
+		};
+		Data data;
+	};
+
+	struct NamedComponent : public Component
+	{
+		struct Data {
+			std::string label;
+			std::vector<int> waypoints;
+		};
+		Data data;
+	};
+
+	/*! Set from userinfo, so it can't be compiled into the template. */
+	struct OwnerComponent : public Component
+	{
+		OwnerComponent() : owner(World::NullEntity), parent(World::NullEntity), sawHealth(false) { }
+		eid_t owner;
+		eid_t parent;
+		bool sawHealth;
+	};
+
+	class OwnerConstructor : public ComponentConstructor
+	{
+	public:
+		OwnerConstructor() : finished(0) { }
+		virtual void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const
+		{
+			OwnerComponent* component = world.emplaceComponent<OwnerComponent>(entity);
+			component->owner = (userinfo == nullptr ? World::NullEntity : *(eid_t*)userinfo);
+			component->parent = parent;
+			component->sawHealth = (world.getComponent<HealthComponent>(entity) != nullptr);
+		}
+		virtual void finish(World& world, eid_t entity) { finished++; }
+		int finished;
+	};
+
+	/*! Builds its component the way every constructor did before prefabs were compiled. */
+	template <class ComponentClass>
+	class UncompiledConstructor : public DefaultComponentConstructor<ComponentClass>
+	{
+	public:
+		using DefaultComponentConstructor<ComponentClass>::DefaultComponentConstructor;
+		virtual bool compile(PrefabTemplate& prefabTemplate) const { return false; }
+	};
+
+	HealthComponent::Data healthData(int health)
+	{
+		HealthComponent::Data data;
+		data.health = health;
+		return data;
+	}
+}
+
+TEST_CASE ( "Prefabs copy their compiled components into new entities", "[world][prefab]" )
+{
+	NamedComponent::Data namedData;
+	namedData.label = "a label long enough to need its own allocation";
+	namedData.waypoints = { 1, 2, 3 };
+
+	Prefab prefab("spider");
+	prefab.addConstructor(new DefaultComponentConstructor<HealthComponent>(healthData(30)));
+	prefab.addConstructor(new DefaultComponentConstructor<NamedComponent>(namedData));
+	prefab.addConstructor(new DefaultComponentConstructor<VelocityComponent>(VelocityComponent::Data()));
+
+	const PrefabTemplate& prefabTemplate = prefab.getTemplate();
+	REQUIRE ( prefabTemplate.getEntries().size() == 3 );
+	REQUIRE ( &prefab.getTemplate() == &prefabTemplate );
+
+	World world;
+	eid_t a = world.constructPrefab(prefab);
+	eid_t b = world.constructPrefab(prefab);
+	REQUIRE ( world.getEntityName(a) == "spider" );
+	REQUIRE ( world.getEntityWithName("spider") == a );
+
+	REQUIRE ( world.getComponent<HealthComponent>(a)->data.health == 30 );
+	REQUIRE ( world.getComponent<NamedComponent>(b)->data.label == namedData.label );
+	REQUIRE ( world.getComponent<NamedComponent>(b)->data.waypoints == namedData.waypoints );
+
+	// Each entity gets a copy, not the prototype
+	world.getComponent<HealthComponent>(a)->data.health = 5;
+	world.getComponent<NamedComponent>(a)->data.waypoints.push_back(4);
+	REQUIRE ( world.getComponent<HealthComponent>(b)->data.health == 30 );
+	REQUIRE ( world.getComponent<NamedComponent>(b)->data.waypoints.size() == 3 );
+	REQUIRE ( world.getComponent<HealthComponent>(world.constructPrefab(prefab))->data.health == 30 );
+
+	ComponentBitmask signature;
+	signature.setBit(world.getComponentId<HealthComponent>(), true);
+	signature.setBit(world.getComponentId<VelocityComponent>(), true);
+	REQUIRE ( world.getEntitiesMatching(signature).size() == 3 );
+	REQUIRE ( world.entityHasComponents(a, signature) );
+
+	uint32_t tick = world.advanceChangeTick();
+	eid_t c = world.constructPrefab(prefab);
+	REQUIRE ( world.changedSince<HealthComponent>(c, tick) );
+	REQUIRE ( !world.changedSince<HealthComponent>(a, tick) );
+}
+
+TEST_CASE ( "A later constructor for the same component replaces an earlier one's data", "[world][prefab]" )
+{
+	Prefab prefab;
+	prefab.addConstructor(new DefaultComponentConstructor<HealthComponent>(healthData(10)));
+	prefab.addConstructor(new DefaultComponentConstructor<HealthComponent>(healthData(20)));
+	REQUIRE ( prefab.getTemplate().getEntries().size() == 1 );
+
+	World world;
+	eid_t entity = world.constructPrefab(prefab);
+	REQUIRE ( world.getComponent<HealthComponent>(entity)->data.health == 20 );
+	REQUIRE ( world.count<HealthComponent>() == 1 );
+}
+
+TEST_CASE ( "Prefab constructors which can't be compiled run for each entity", "[world][prefab]" )
+{
+	OwnerConstructor* ownerConstructor = new OwnerConstructor();
+	Prefab prefab;
+	prefab.addConstructor(ownerConstructor);
+	prefab.addConstructor(new DefaultComponentConstructor<HealthComponent>(healthData(10)));
+	REQUIRE ( prefab.getTemplate().getEntries().size() == 1 );
+
+	World world;
+	eid_t owner = world.getNewEntity("owner");
+
+	ComponentBitmask signature;
+	signature.setBit(world.getComponentId<OwnerComponent>(), true);
+	signature.setBit(world.getComponentId<HealthComponent>(), true);
+	REQUIRE ( world.getEntitiesMatching(signature).size() == 0 );
+
+	eid_t entity = world.constructPrefab(prefab, owner, &owner);
+
+	OwnerComponent* component = world.getComponent<OwnerComponent>(entity);
+	REQUIRE ( component != nullptr );
+	REQUIRE ( component->owner == owner );
+	REQUIRE ( component->parent == owner );
+	// Compiled components are in place before any constructor runs
+	REQUIRE ( component->sawHealth );
+	REQUIRE ( ownerConstructor->finished == 1 );
+
+	// The entity joins the query once, with all of its components
+	REQUIRE ( world.getEntitiesMatching(signature).size() == 1 );
+	REQUIRE ( world.getStats().queryUpdates == 1 );
+}
+
+TEST_CASE ( "Child prefabs are constructed along with their parent", "[world][prefab]" )
+{
+	std::shared_ptr<Prefab> grandchild = std::make_shared<Prefab>("grandchild");
+	grandchild->addConstructor(new OwnerConstructor());
+
+	std::shared_ptr<Prefab> child = std::make_shared<Prefab>("child");
+	child->addConstructor(new OwnerConstructor());
+	child->addConstructor(new DefaultComponentConstructor<HealthComponent>(healthData(1)));
+	child->addChild(grandchild);
+
+	Prefab parent("parent");
+	parent.addConstructor(new DefaultComponentConstructor<HealthComponent>(healthData(2)));
+	parent.addChild(child);
+	parent.addChild(child);
+
+	World world;
+	eid_t entity = world.constructPrefab(parent);
+	REQUIRE ( world.count<HealthComponent>() == 3 );
+
+	int children = 0;
+	int grandchildren = 0;
+	for (eid_t owned : world.getEntitiesWithComponent<OwnerComponent>()) {
+		eid_t ownerParent = world.getComponent<OwnerComponent>(owned)->parent;
+		if (world.getEntityName(owned) == "child") {
+			REQUIRE ( ownerParent == entity );
+			REQUIRE ( world.getComponent<HealthComponent>(owned)->data.health == 1 );
+			children++;
+		} else {
+			REQUIRE ( world.getEntityName(ownerParent) == "child" );
+			grandchildren++;
+		}
+	}
+	REQUIRE ( children == 2 );
+	REQUIRE ( grandchildren == 2 );
+}
+
+TEST_CASE ( "Prefabs are recompiled after they change", "[world][prefab]" )
+{
+	Prefab prefab("first");
+	prefab.addConstructor(new DefaultComponentConstructor<HealthComponent>(healthData(10)));
+
+	World world;
+	eid_t a = world.constructPrefab(prefab);
+
+	// Copies share the template until one of them changes
+	Prefab copy = prefab;
+	REQUIRE ( &copy.getTemplate() == &prefab.getTemplate() );
+	copy.addConstructor(new DefaultComponentConstructor<VelocityComponent>(VelocityComponent::Data()));
+	copy.setName("second");
+	REQUIRE ( &copy.getTemplate() != &prefab.getTemplate() );
+
+	eid_t b = world.constructPrefab(copy);
+	REQUIRE ( world.getComponent<VelocityComponent>(b) != nullptr );
+	REQUIRE ( world.getComponent<VelocityComponent>(a) == nullptr );
+	REQUIRE ( world.getEntityName(b) == "second" );
+	REQUIRE ( world.getEntityName(world.constructPrefab(prefab)) == "first" );
+
+	// Names are forgotten when a world is cleared and restored, and the layouts with them
+	std::vector<char> buffer;
+	World empty;
+	empty.snapshot(buffer);
+	REQUIRE ( world.restore(buffer) );
+	REQUIRE ( world.getEntityName(world.constructPrefab(copy)) == "second" );
+}
+
+namespace
+{
+	/*! Roughly the components of the game's spider prefab. */
+	struct SpiderTransformComponent : public Component
+	{
+		struct Data {
+			Data() : position(), rotation(), scale(1.0f) { rotation[3] = 1.0f; }
+			float position[3];
+			float rotation[4];
+			float scale;
+		};
+		Data data;
+	};
+
+	struct SpiderComponent : public Component
+	{
+		struct Data {
+			Data() : state(0), attackTime(1.0f), attackRange(2.0f), lastAttack(0.0f), target(World::NullEntity) { }
+			int state;
+			float attackTime;
+			float attackRange;
+			float lastAttack;
+			eid_t target;
+		};
+		Data data;
+	};
+
+	struct SpiderMotorComponent : public Component
+	{
+		struct Data {
+			Data() : speed(5.0f), jumpSpeed(3.0f), grounded(false), facing() { }
+			float speed;
+			float jumpSpeed;
+			bool grounded;
+			float facing[3];
+		};
+		Data data;
+	};
+
+	struct SpiderAudioComponent : public Component
+	{
+		struct Data {
+			Data() : volume(1.0f) { }
+			std::vector<int> clips;
+			float volume;
+		};
+		Data data;
+	};
+
+	struct SpiderModelComponent : public Component
+	{
+		struct Data {
+			Data() : model(0), animation(0), time(0.0f) { }
+			unsigned model;
+			unsigned animation;
+			float time;
+		};
+		Data data;
+	};
+
+	template <template <class> class Constructor>
+	Prefab makeSpiderPrefab()
+	{
+		SpiderAudioComponent::Data audio;
+		audio.clips = { 1, 2, 3, 4 };
+
+		Prefab prefab("Spider");
+		prefab.addConstructor(new Constructor<SpiderTransformComponent>(SpiderTransformComponent::Data()));
+		prefab.addConstructor(new Constructor<SpiderComponent>(SpiderComponent::Data()));
+		prefab.addConstructor(new Constructor<HealthComponent>(healthData(100)));
+		prefab.addConstructor(new Constructor<VelocityComponent>(VelocityComponent::Data()));
+		prefab.addConstructor(new Constructor<SpiderMotorComponent>(SpiderMotorComponent::Data()));
+		prefab.addConstructor(new Constructor<SpiderAudioComponent>(audio));
+		prefab.addConstructor(new Constructor<SpiderModelComponent>(SpiderModelComponent::Data()));
+		prefab.addConstructor(new OwnerConstructor());
+		return prefab;
+	}
+}
+
+TEST_CASE ( "Prefab construction: constructor calls vs compiled template", "[.][benchmark]" )
+{
+	const unsigned spiderCount = 10000;
+	const unsigned runs = 20;
+
+	Prefab uncompiled = makeSpiderPrefab<UncompiledConstructor>();
+	Prefab compiled = makeSpiderPrefab<DefaultComponentConstructor>();
+
+	World world;
+	auto spawnAll = [&world](const Prefab& prefab) {
+		world.clear();
+		for (unsigned i = 0; i < spiderCount; i++) {
+			benchmarkSink += world.constructPrefab(prefab);
+		}
+	};
+
+	// Grow the pools first, so neither run pays for it
+	spawnAll(compiled);
+
+	double uncompiledTime = benchmark(runs, [&]() { spawnAll(uncompiled); });
+	double compiledTime = benchmark(runs, [&]() { spawnAll(compiled); });
+
+	reportBenchmark("10k spiders, a constructor call per component", spiderCount, uncompiledTime);
+	reportBenchmark("10k spiders, copied from a compiled template", spiderCount, compiledTime);
+}
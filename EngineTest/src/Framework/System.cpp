@@ -0,0 +1,520 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "Framework/System.h"
+#include "Framework/SystemScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	struct PositionComponent : public Component
+	{
+		PositionComponent() : x(0.0f) { }
+		float x;
+	};
+
+	struct VelocityComponent : public Component
+	{
+		VelocityComponent() : dx(0.0f) { }
+		float dx;
+	};
+
+	struct TagComponent : public Component { };
+
+	class MoveSystem : public TypedSystem<PositionComponent, VelocityComponent>
+	{
+	public:
+		MoveSystem(World& world) : TypedSystem(world), updated(0) { }
+		void updateEntity(float dt, eid_t entity, PositionComponent& position, VelocityComponent& velocity)
+		{
+			position.x += velocity.dx * dt;
+			updated++;
+		}
+		unsigned updated;
+	};
+}
+
+TEST_CASE ( "View only visits entities with every component", "[view]" )
+{
+	World world;
+	eid_t both = world.getNewEntity("both");
+	eid_t positionOnly = world.getNewEntity("position");
+	eid_t velocityOnly = world.getNewEntity("velocity");
+
+	world.addComponent<PositionComponent>(both)->x = 1.0f;
+	world.addComponent<VelocityComponent>(both)->dx = 2.0f;
+	world.addComponent<PositionComponent>(positionOnly);
+	world.addComponent<VelocityComponent>(velocityOnly);
+
+	unsigned visited = 0;
+	for (auto tuple : world.view<PositionComponent, VelocityComponent>()) {
+		REQUIRE ( std::get<0>(tuple) == both );
+		REQUIRE ( std::get<1>(tuple).x == 1.0f );
+		REQUIRE ( std::get<2>(tuple).dx == 2.0f );
+		visited++;
+	}
+	REQUIRE ( visited == 1 );
+
+	visited = 0;
+	world.view<PositionComponent>().each([&](eid_t entity, PositionComponent& position) {
+		visited++;
+	});
+	REQUIRE ( visited == 2 );
+
+	View<PositionComponent, TagComponent> empty = world.view<PositionComponent, TagComponent>();
+	REQUIRE ( empty.begin() == empty.end() );
+}
+
+TEST_CASE ( "View tolerates removing components while iterating", "[view]" )
+{
+	World world;
+	for (int i = 0; i < 10; i++) {
+		eid_t entity = world.getNewEntity();
+		world.addComponent<PositionComponent>(entity);
+		world.addComponent<VelocityComponent>(entity);
+	}
+
+	unsigned visited = 0;
+	world.view<PositionComponent, VelocityComponent>().each([&](eid_t entity, PositionComponent& position, VelocityComponent& velocity) {
+		world.removeComponent<VelocityComponent>(entity);
+		visited++;
+	});
+	REQUIRE ( visited == 10 );
+	REQUIRE ( world.getEntitiesWithComponent<VelocityComponent>().size() == 0 );
+}
+
+TEST_CASE ( "TypedSystem hands components to updateEntity", "[system][view]" )
+{
+	World world;
+	MoveSystem system(world);
+
+	eid_t mover = world.getNewEntity("mover");
+	world.addComponent<PositionComponent>(mover);
+	world.addComponent<VelocityComponent>(mover)->dx = 3.0f;
+	eid_t still = world.getNewEntity("still");
+	world.addComponent<PositionComponent>(still);
+
+	system.update(0.5f);
+	REQUIRE ( system.updated == 1 );
+	REQUIRE ( world.getComponent<PositionComponent>(mover)->x == 1.5f );
+	REQUIRE ( world.getComponent<PositionComponent>(still)->x == 0.0f );
+
+	// The untyped entry point still works
+	static_cast<System&>(system).updateEntity(1.0f, mover);
+	REQUIRE ( world.getComponent<PositionComponent>(mover)->x == 4.5f );
+}
+
+namespace
+{
+	/*! Moves entities along, and tags and removes those which go below zero. */
+	class ParallelMoveSystem : public System
+	{
+	public:
+		ParallelMoveSystem(World& world) : System(world), updated(0), sawTag(false)
+		{
+			require<PositionComponent>();
+			require<VelocityComponent>();
+			writes<PositionComponent>();
+			reads<VelocityComponent>();
+			writes<TagComponent>();
+		}
+		void updateEntity(float dt, eid_t entity)
+		{
+			PositionComponent* position = world.getComponent<PositionComponent>(entity);
+			position->x += world.getComponent<VelocityComponent>(entity)->dx * dt;
+			if (position->x < 0.0f) {
+				getCommands().addComponent<TagComponent>(entity);
+				getCommands().removeEntity(entity);
+			}
+			if (world.getEntitiesWithComponent<TagComponent>().size() > 0) {
+				sawTag = true;
+			}
+			updated++;
+		}
+		std::atomic<unsigned> updated;
+		std::atomic<bool> sawTag;
+	};
+
+	class ParallelTypedMoveSystem : public TypedSystem<PositionComponent, VelocityComponent>
+	{
+	public:
+		ParallelTypedMoveSystem(World& world) : TypedSystem(world), updated(0) { }
+		void updateEntity(float dt, eid_t entity, PositionComponent& position, VelocityComponent& velocity)
+		{
+			position.x += velocity.dx * dt;
+			updated++;
+		}
+		std::atomic<unsigned> updated;
+	};
+}
+
+TEST_CASE ( "Parallel systems update every entity once and buffer structural changes", "[system]" )
+{
+	const unsigned entityCount = 1000;
+
+	World world;
+	WorkerPool workerPool(4);
+	ParallelMoveSystem system(world);
+	ParallelTypedMoveSystem typedSystem(world);
+	system.setParallel(&workerPool, 16);
+	typedSystem.setParallel(&workerPool, 16);
+	REQUIRE ( system.isParallel() );
+
+	std::vector<eid_t> entities;
+	for (unsigned i = 0; i < entityCount; i++) {
+		eid_t entity = world.getNewEntity();
+		world.addComponent<PositionComponent>(entity)->x = 1.0f;
+		world.addComponent<VelocityComponent>(entity)->dx = (i % 10 == 0 ? -4.0f : 2.0f);
+		entities.push_back(entity);
+	}
+
+	system.update(0.5f);
+	REQUIRE ( system.updated == entityCount );
+	REQUIRE ( !system.sawTag );
+	REQUIRE ( world.getEntitiesWithComponent<TagComponent>().size() == entityCount / 10 );
+
+	typedSystem.update(0.5f);
+	REQUIRE ( typedSystem.updated == entityCount );
+	for (unsigned i = 0; i < entityCount; i++) {
+		REQUIRE ( world.getComponent<PositionComponent>(entities[i])->x == (i % 10 == 0 ? -3.0f : 3.0f) );
+	}
+
+	world.cleanupEntities();
+	REQUIRE ( world.getEntitiesWithComponent<PositionComponent>().size() == entityCount - entityCount / 10 );
+	REQUIRE ( world.getEntitiesWithComponent<TagComponent>().size() == 0 );
+}
+
+TEST_CASE ( "Parallel systems can run inside the scheduler", "[system][scheduler]" )
+{
+	World world;
+	WorkerPool workerPool(4);
+	ParallelMoveSystem system(world);
+	ParallelTypedMoveSystem typedSystem(world);
+	system.setParallel(&workerPool, 8);
+	typedSystem.setParallel(&workerPool, 8);
+
+	for (unsigned i = 0; i < 200; i++) {
+		eid_t entity = world.getNewEntity();
+		world.addComponent<PositionComponent>(entity)->x = 1.0f;
+		world.addComponent<VelocityComponent>(entity)->dx = 1.0f;
+	}
+
+	SystemScheduler scheduler(workerPool);
+	scheduler.add(system);
+	scheduler.add(typedSystem);
+	for (int i = 0; i < 20; i++) {
+		scheduler.update(0.5f);
+	}
+	REQUIRE ( system.updated == 200 * 20 );
+	REQUIRE ( typedSystem.updated == 200 * 20 );
+}
+
+namespace
+{
+	/*! Moves entities and stamps their positions, like the game's VelocitySystem. */
+	class StampingMoveSystem : public TypedSystem<PositionComponent, VelocityComponent>
+	{
+	public:
+		StampingMoveSystem(World& world) : TypedSystem(world), sawChanged(0) { }
+		void updateEntity(float dt, eid_t entity, PositionComponent& position, VelocityComponent& velocity)
+		{
+			if (changedSinceLastUpdate<PositionComponent>(entity)) {
+				sawChanged++;
+			}
+			position.x += velocity.dx * dt;
+			markChanged<PositionComponent>(entity);
+		}
+		unsigned sawChanged;
+	};
+
+	/*! Copies positions somewhere else, like the game's ModelRenderSystem, but only when they changed. */
+	class MirrorSystem : public TypedSystem<PositionComponent>
+	{
+	public:
+		MirrorSystem(World& world) : TypedSystem(world), copied(0) { }
+		void updateEntity(float dt, eid_t entity, PositionComponent& position)
+		{
+			if (!changedSinceLastUpdate<PositionComponent>(entity)) {
+				skipEntity();
+				return;
+			}
+			copied++;
+		}
+		unsigned copied;
+	};
+}
+
+TEST_CASE ( "Systems can skip entities whose components haven't changed", "[system][changes]" )
+{
+	World world;
+	std::vector<eid_t> entities;
+	for (int i = 0; i < 4; i++) {
+		entities.push_back(world.getNewEntity());
+		world.addComponent<PositionComponent>(entities.back());
+	}
+	world.addComponent<VelocityComponent>(entities[1])->dx = 1.0f;
+
+	StampingMoveSystem moveSystem(world);
+	MirrorSystem mirrorSystem(world);
+
+	// Everything is new to a system's first update
+	mirrorSystem.update(1.0f);
+	REQUIRE ( mirrorSystem.copied == 4 );
+	REQUIRE ( mirrorSystem.getSkippedEntities() == 0 );
+
+	mirrorSystem.copied = 0;
+	mirrorSystem.update(1.0f);
+	REQUIRE ( mirrorSystem.copied == 0 );
+	REQUIRE ( mirrorSystem.getSkippedEntities() == 4 );
+
+	// Marked by another system, or from outside any system
+	moveSystem.update(1.0f);
+	world.markChanged<PositionComponent>(entities[3]);
+	mirrorSystem.copied = 0;
+	mirrorSystem.update(1.0f);
+	REQUIRE ( mirrorSystem.copied == 2 );
+	REQUIRE ( mirrorSystem.getSkippedEntities() == 2 );
+
+	// A system doesn't see its own changes on its next update
+	REQUIRE ( moveSystem.sawChanged == 1 );
+	moveSystem.update(1.0f);
+	REQUIRE ( moveSystem.sawChanged == 1 );
+
+	// Newly added components count as changed, and removing one keeps the others' ticks
+	mirrorSystem.update(1.0f);
+	eid_t added = world.getNewEntity();
+	world.addComponent<PositionComponent>(added);
+	world.removeComponent<PositionComponent>(entities[0]);
+	mirrorSystem.copied = 0;
+	mirrorSystem.update(1.0f);
+	REQUIRE ( mirrorSystem.copied == 1 );
+	REQUIRE ( mirrorSystem.getSkippedEntities() == 3 );
+	REQUIRE ( !world.changedSince<PositionComponent>(entities[0], 0) );
+}
+
+namespace
+{
+	struct FollowerComponent : public Component
+	{
+		FollowerComponent() : repathTimer(0.0f), pathNode(0) { }
+		float repathTimer;
+		unsigned pathNode;
+		std::vector<float> path;
+	};
+
+	struct SteeringComponent : public Component
+	{
+		SteeringComponent() : facing(0.0f), moving(false) { }
+		float facing;
+		bool moving;
+	};
+
+	/*! Does roughly what the game's FollowSystem does for each spider, minus the physics
+		query: steers towards a target, periodically rebuilding a short path to it. */
+	class StressFollowSystem : public TypedSystem<PositionComponent, FollowerComponent, SteeringComponent>
+	{
+	public:
+		StressFollowSystem(World& world) : TypedSystem(world) { }
+		void updateEntity(float dt, eid_t entity, PositionComponent& position, FollowerComponent& follower, SteeringComponent& steering)
+		{
+			const float target = 100.0f;
+			follower.repathTimer += dt;
+			if (follower.repathTimer >= 1.0f || follower.path.empty()) {
+				follower.path.clear();
+				for (float x = position.x; std::abs(target - x) > 1.0f; x += (target - x) * 0.5f) {
+					follower.path.push_back(x);
+				}
+				follower.path.push_back(target);
+				follower.pathNode = 0;
+				follower.repathTimer = 0.0f;
+			}
+
+			float next = follower.path[std::min<size_t>(follower.pathNode, follower.path.size() - 1)];
+			for (int i = 0; i < 16; i++) {
+				steering.facing = std::atan2(next - position.x, 1.0f + steering.facing * 0.01f);
+			}
+			steering.moving = std::abs(next - position.x) > 0.5f;
+			if (!steering.moving) {
+				follower.pathNode++;
+			}
+			position.x += (next > position.x ? 1.0f : -1.0f) * dt;
+		}
+	};
+}
+
+TEST_CASE ( "Parallel system: 5000 followers", "[.][benchmark]" )
+{
+	const unsigned followerCount = 5000;
+
+	World world;
+	for (unsigned i = 0; i < followerCount; i++) {
+		eid_t entity = world.getNewEntity();
+		world.addComponent<PositionComponent>(entity)->x = (float)(i % 200);
+		world.addComponent<FollowerComponent>(entity)->repathTimer = (i % 60) / 60.0f;
+		world.addComponent<SteeringComponent>(entity);
+	}
+
+	StressFollowSystem system(world);
+	const unsigned runs = 60;
+	double serialTime = benchmark(runs, [&]() { system.update(0.016f); });
+	reportBenchmark("5000 followers, serial", followerCount, serialTime);
+
+	printf("  hardware threads: %u\n", std::thread::hardware_concurrency());
+	for (unsigned threadCount : { 2u, 4u, 8u }) {
+		for (size_t grainSize : { 32u, 256u }) {
+			WorkerPool workerPool(threadCount);
+			system.setParallel(&workerPool, grainSize);
+			double parallelTime = benchmark(runs, [&]() { system.update(0.016f); });
+			system.setParallel(nullptr);
+
+			char name[64];
+			snprintf(name, sizeof(name), "5000 followers, %u threads, grain %u", threadCount, (unsigned)grainSize);
+			reportBenchmark(name, followerCount, parallelTime);
+			printf("  speedup %.2fx\n", serialTime / parallelTime);
+		}
+	}
+}
+
+namespace
+{
+	/*! Stand-ins for the game's components, shaped like the real ones (shared transform
+		data, collision objects and renderer handles living outside the component). */
+	struct BenchTransform
+	{
+		BenchTransform() : position{ 0.0f, 0.0f, 0.0f }, rotation{ 0.0f, 0.0f, 0.0f, 1.0f } { }
+		float position[3];
+		float rotation[4];
+	};
+
+	struct BenchTransformComponent : public Component
+	{
+		BenchTransformComponent() : data(new BenchTransform()) { }
+		std::shared_ptr<BenchTransform> data;
+	};
+
+	struct BenchCollisionComponent : public Component
+	{
+		BenchCollisionComponent() : controlsMovement(false), collisionObject(nullptr) { }
+		bool controlsMovement;
+		BenchTransform* collisionObject;
+	};
+
+	struct BenchModelComponent : public Component
+	{
+		BenchModelComponent() : rendererHandle(0) { }
+		unsigned rendererHandle;
+	};
+
+	void updateCollision(BenchCollisionComponent& collision, BenchTransformComponent& transform)
+	{
+		if (collision.controlsMovement) {
+			*transform.data = *collision.collisionObject;
+		} else {
+			*collision.collisionObject = *transform.data;
+		}
+	}
+
+	void updateModel(std::vector<float>& renderables, BenchModelComponent& model, BenchTransformComponent& transform)
+	{
+		renderables[model.rendererHandle] = transform.data->position[0] + transform.data->rotation[3];
+	}
+
+	class OldCollisionSystem : public System
+	{
+	public:
+		OldCollisionSystem(World& world) : System(world)
+		{
+			require<BenchCollisionComponent>();
+			require<BenchTransformComponent>();
+		}
+		void updateEntity(float dt, eid_t entity)
+		{
+			updateCollision(*world.getComponent<BenchCollisionComponent>(entity), *world.getComponent<BenchTransformComponent>(entity));
+		}
+	};
+
+	class TypedCollisionSystem : public TypedSystem<BenchCollisionComponent, BenchTransformComponent>
+	{
+	public:
+		TypedCollisionSystem(World& world) : TypedSystem(world) { }
+		void updateEntity(float dt, eid_t entity, BenchCollisionComponent& collision, BenchTransformComponent& transform)
+		{
+			updateCollision(collision, transform);
+		}
+	};
+
+	class OldModelSystem : public System
+	{
+	public:
+		OldModelSystem(World& world, std::vector<float>& renderables) : System(world), renderables(renderables)
+		{
+			require<BenchModelComponent>();
+			require<BenchTransformComponent>();
+		}
+		void updateEntity(float dt, eid_t entity)
+		{
+			updateModel(renderables, *world.getComponent<BenchModelComponent>(entity), *world.getComponent<BenchTransformComponent>(entity));
+		}
+		std::vector<float>& renderables;
+	};
+
+	class TypedModelSystem : public TypedSystem<BenchModelComponent, BenchTransformComponent>
+	{
+	public:
+		TypedModelSystem(World& world, std::vector<float>& renderables) : TypedSystem(world), renderables(renderables) { }
+		void updateEntity(float dt, eid_t entity, BenchModelComponent& model, BenchTransformComponent& transform)
+		{
+			updateModel(renderables, model, transform);
+		}
+		std::vector<float>& renderables;
+	};
+
+	void benchmarkSystems(unsigned entityCount)
+	{
+		World world;
+		std::vector<BenchTransform> collisionObjects(entityCount);
+		std::vector<float> renderables(entityCount);
+
+		// A third of the entities collide, a third are rendered and the rest only have a transform
+		unsigned collisionCount = 0, modelCount = 0;
+		for (unsigned i = 0; i < entityCount; i++) {
+			eid_t entity = world.getNewEntity();
+			world.addComponent<BenchTransformComponent>(entity);
+			if (i % 3 == 0) {
+				BenchCollisionComponent* collision = world.addComponent<BenchCollisionComponent>(entity);
+				collision->collisionObject = &collisionObjects[collisionCount++];
+				collision->controlsMovement = (i % 2 == 0);
+			} else if (i % 3 == 1) {
+				world.addComponent<BenchModelComponent>(entity)->rendererHandle = modelCount++;
+			}
+		}
+
+		OldCollisionSystem oldCollision(world);
+		TypedCollisionSystem typedCollision(world);
+		OldModelSystem oldModel(world, renderables);
+		TypedModelSystem typedModel(world, renderables);
+
+		const unsigned runs = std::max(1u, 1000000u / entityCount);
+		double oldCollisionTime = benchmark(runs, [&]() { oldCollision.update(0.016f); });
+		double typedCollisionTime = benchmark(runs, [&]() { typedCollision.update(0.016f); });
+		double oldModelTime = benchmark(runs, [&]() { oldModel.update(0.016f); });
+		double typedModelTime = benchmark(runs, [&]() { typedModel.update(0.016f); });
+		benchmarkSink += (unsigned long long)renderables[0];
+
+		reportBenchmark("System collision-shaped update", collisionCount, oldCollisionTime);
+		reportBenchmark("TypedSystem collision-shaped update", collisionCount, typedCollisionTime);
+		reportBenchmark("System model-render-shaped update", modelCount, oldModelTime);
+		reportBenchmark("TypedSystem model-render-shaped update", modelCount, typedModelTime);
+	}
+}
+
+TEST_CASE ( "System updates: query cache vs TypedSystem", "[.][benchmark]" )
+{
+	benchmarkSystems(1000);
+	benchmarkSystems(10000);
+	benchmarkSystems(100000);
+}
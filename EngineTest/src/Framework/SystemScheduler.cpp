@@ -0,0 +1,251 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "Framework/SystemScheduler.h"
+
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	template <int I>
+	struct ScheduledComponent : public Component
+	{
+		ScheduledComponent() : value(1.0f) { }
+		float value;
+	};
+
+	/*! Records the order in which systems finish updating. */
+	struct UpdateLog
+	{
+		void record(int id)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			order.push_back(id);
+		}
+		std::vector<int> order;
+		std::mutex mutex;
+	};
+
+	class LoggedSystem : public System
+	{
+	public:
+		LoggedSystem(World& world, UpdateLog& log, int id) : System(world), log(log), id(id)
+		{
+			require<ScheduledComponent<0>>();
+		}
+		void update(float dt) { log.record(id); }
+		void updateEntity(float dt, eid_t entity) { }
+
+		using System::reads;
+		using System::writes;
+		using System::readsResource;
+		using System::writesResource;
+	private:
+		UpdateLog& log;
+		int id;
+	};
+
+	/*! Tags every entity with ScheduledComponent<1>, through its command buffer. */
+	class TaggingSystem : public System
+	{
+	public:
+		TaggingSystem(World& world) : System(world)
+		{
+			require<ScheduledComponent<0>>();
+			reads<ScheduledComponent<0>>();
+			writes<ScheduledComponent<1>>();
+		}
+		void updateEntity(float dt, eid_t entity) { getCommands().addComponent<ScheduledComponent<1>>(entity); }
+	};
+
+	/*! Counts the tagged entities as it updates. */
+	class TagCountingSystem : public System
+	{
+	public:
+		TagCountingSystem(World& world) : System(world), seen(0)
+		{
+			reads<ScheduledComponent<2>>();
+		}
+		void update(float dt) { seen = world.count<ScheduledComponent<1>>(); }
+		void updateEntity(float dt, eid_t entity) { }
+		size_t seen;
+	};
+}
+
+TEST_CASE ( "Systems conflict according to their declared access", "[scheduler]" )
+{
+	World world;
+	UpdateLog log;
+	LoggedSystem undeclared(world, log, 0);
+	LoggedSystem readerA(world, log, 1);
+	LoggedSystem readerB(world, log, 2);
+	LoggedSystem writer(world, log, 3);
+	LoggedSystem other(world, log, 4);
+
+	readerA.reads<ScheduledComponent<0>>();
+	readerB.reads<ScheduledComponent<0>>();
+	writer.writes<ScheduledComponent<0>>();
+	other.writes<ScheduledComponent<1>>();
+
+	REQUIRE ( undeclared.conflictsWith(readerA) );
+	REQUIRE ( readerA.conflictsWith(undeclared) );
+	REQUIRE ( !readerA.conflictsWith(readerB) );
+	REQUIRE ( readerA.conflictsWith(writer) );
+	REQUIRE ( writer.conflictsWith(readerB) );
+	REQUIRE ( !writer.conflictsWith(other) );
+
+	int renderer;
+	readerA.readsResource(&renderer);
+	readerB.readsResource(&renderer);
+	REQUIRE ( !readerA.conflictsWith(readerB) );
+	other.writesResource(&renderer);
+	REQUIRE ( other.conflictsWith(readerA) );
+	REQUIRE ( readerB.conflictsWith(other) );
+}
+
+TEST_CASE ( "Scheduler keeps conflicting systems in order", "[scheduler]" )
+{
+	World world;
+	UpdateLog log;
+	LoggedSystem first(world, log, 0);
+	LoggedSystem second(world, log, 1);
+	LoggedSystem third(world, log, 2);
+	LoggedSystem fourth(world, log, 3);
+
+	first.writes<ScheduledComponent<0>>();
+	second.writes<ScheduledComponent<1>>();
+	third.reads<ScheduledComponent<0>>();
+	third.reads<ScheduledComponent<1>>();
+	fourth.writes<ScheduledComponent<2>>();
+
+	WorkerPool workerPool(4);
+	SystemScheduler scheduler(workerPool);
+	scheduler.add(first);
+	scheduler.add(second);
+	scheduler.add(third);
+	scheduler.add(fourth);
+
+	REQUIRE ( scheduler.getDependencies(0).size() == 0 );
+	REQUIRE ( scheduler.getDependencies(2) == std::vector<size_t>({ 0, 1 }) );
+	REQUIRE ( scheduler.getDependencies(3).size() == 0 );
+
+	for (int i = 0; i < 50; i++) {
+		log.order.clear();
+		scheduler.update(0.016f);
+		REQUIRE ( log.order.size() == 4 );
+		REQUIRE ( log.order[0] != 2 );
+		REQUIRE ( log.order[1] != 2 );
+	}
+
+	scheduler.setDeterministic(true);
+	log.order.clear();
+	scheduler.update(0.016f);
+	REQUIRE ( log.order == std::vector<int>({ 0, 1, 2, 3 }) );
+}
+
+namespace
+{
+	/*! A system which does a fixed amount of arithmetic on its own component. */
+	template <int I>
+	class BusySystem : public System
+	{
+	public:
+		BusySystem(World& world) : System(world)
+		{
+			require<ScheduledComponent<I>>();
+			writes<ScheduledComponent<I>>();
+		}
+		void updateEntity(float dt, eid_t entity)
+		{
+			ScheduledComponent<I>* component = world.getComponent<ScheduledComponent<I>>(entity);
+			float value = component->value;
+			for (int i = 0; i < 32; i++) {
+				value = std::sqrt(value * value + dt) * 0.999f;
+			}
+			component->value = value;
+		}
+	};
+
+	template <int I>
+	void addScheduledComponent(World& world, eid_t entity)
+	{
+		world.addComponent<ScheduledComponent<I>>(entity);
+	}
+}
+
+TEST_CASE ( "Scheduler plays back commands once every system has finished", "[scheduler]" )
+{
+	World world;
+	eid_t entity = world.getNewEntity();
+	world.addComponent<ScheduledComponent<0>>(entity);
+
+	TaggingSystem tagging(world);
+	TagCountingSystem counting(world);
+	REQUIRE ( !tagging.conflictsWith(counting) );
+
+	WorkerPool workerPool(4);
+	SystemScheduler scheduler(workerPool);
+	scheduler.add(tagging);
+	scheduler.add(counting);
+
+	for (bool deterministic : { false, true }) {
+		scheduler.setDeterministic(deterministic);
+		world.removeComponent<ScheduledComponent<1>>(entity);
+		scheduler.update(0.016f);
+		REQUIRE ( counting.seen == 0 );
+		REQUIRE ( world.count<ScheduledComponent<1>>() == 1 );
+	}
+}
+
+TEST_CASE ( "System scheduling: serial vs parallel", "[.][benchmark]" )
+{
+	const unsigned entityCount = 5000;
+
+	World world;
+	for (unsigned i = 0; i < entityCount; i++) {
+		eid_t entity = world.getNewEntity();
+		addScheduledComponent<0>(world, entity); addScheduledComponent<1>(world, entity);
+		addScheduledComponent<2>(world, entity); addScheduledComponent<3>(world, entity);
+		addScheduledComponent<4>(world, entity); addScheduledComponent<5>(world, entity);
+		addScheduledComponent<6>(world, entity); addScheduledComponent<7>(world, entity);
+		addScheduledComponent<8>(world, entity); addScheduledComponent<9>(world, entity);
+		addScheduledComponent<10>(world, entity); addScheduledComponent<11>(world, entity);
+		addScheduledComponent<12>(world, entity); addScheduledComponent<13>(world, entity);
+		addScheduledComponent<14>(world, entity); addScheduledComponent<15>(world, entity);
+	}
+
+	std::vector<std::unique_ptr<System>> systems;
+	systems.emplace_back(new BusySystem<0>(world)); systems.emplace_back(new BusySystem<1>(world));
+	systems.emplace_back(new BusySystem<2>(world)); systems.emplace_back(new BusySystem<3>(world));
+	systems.emplace_back(new BusySystem<4>(world)); systems.emplace_back(new BusySystem<5>(world));
+	systems.emplace_back(new BusySystem<6>(world)); systems.emplace_back(new BusySystem<7>(world));
+	systems.emplace_back(new BusySystem<8>(world)); systems.emplace_back(new BusySystem<9>(world));
+	systems.emplace_back(new BusySystem<10>(world)); systems.emplace_back(new BusySystem<11>(world));
+	systems.emplace_back(new BusySystem<12>(world)); systems.emplace_back(new BusySystem<13>(world));
+	systems.emplace_back(new BusySystem<14>(world)); systems.emplace_back(new BusySystem<15>(world));
+
+	const unsigned runs = 20;
+	double serialTime = benchmark(runs, [&]() {
+		for (auto& system : systems) {
+			system->update(0.016f);
+		}
+	});
+	reportBenchmark("16 systems, serial", entityCount * 16, serialTime);
+
+	printf("  hardware threads: %u\n", std::thread::hardware_concurrency());
+	for (unsigned threadCount : { 2u, 4u, 8u, 16u }) {
+		WorkerPool workerPool(threadCount);
+		SystemScheduler scheduler(workerPool);
+		for (auto& system : systems) {
+			scheduler.add(*system);
+		}
+
+		double parallelTime = benchmark(runs, [&]() { scheduler.update(0.016f); });
+		char name[64];
+		snprintf(name, sizeof(name), "16 systems, scheduler with %u threads", threadCount);
+		reportBenchmark(name, entityCount * 16, parallelTime);
+		printf("  speedup %.2fx\n", serialTime / parallelTime);
+	}
+}
\ No newline at end of file
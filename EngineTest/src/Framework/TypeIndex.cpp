@@ -0,0 +1,31 @@
+#include "catch.hpp"
+#include "Framework/TypeIndex.h"
+
+#include <set>
+
+namespace
+{
+	struct FamilyA { };
+	struct FamilyB { };
+	struct First { };
+	struct Second { };
+	struct Third { };
+}
+
+TEST_CASE ( "Type indices are dense and stable within a family", "[typeindex]" )
+{
+	uint32_t first = TypeIndex<FamilyA>::get<First>();
+	uint32_t second = TypeIndex<FamilyA>::get<Second>();
+	uint32_t third = TypeIndex<FamilyA>::get<Third>();
+
+	REQUIRE ( std::set<uint32_t>({ first, second, third }).size() == 3 );
+	REQUIRE ( TypeIndex<FamilyA>::count() == 3 );
+	REQUIRE ( first < 3 );
+	REQUIRE ( second < 3 );
+	REQUIRE ( third < 3 );
+	REQUIRE ( TypeIndex<FamilyA>::get<Second>() == second );
+
+	// Each family counts from zero on its own
+	REQUIRE ( TypeIndex<FamilyB>::get<Third>() == 0 );
+	REQUIRE ( TypeIndex<FamilyB>::count() == 1 );
+}
@@ -0,0 +1,603 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+#include "Framework/World.h"
+#include "Framework/System.h"
+#include "Framework/Prefab.h"
+#include "Framework/DefaultComponentConstructor.h"
+
+#include <algorithm>
+
+namespace
+{
+	struct HealthComponent : public Component
+	{
+		struct Data {
+			Data() : health(0) { }
+			int health;
+		};
+		Data data;
+	};
+
+	struct ArmorComponent : public Component
+	{
+		struct Data { };
+		Data data;
+	};
+
+	/*! Has snapshot hooks, unlike the components above. */
+	struct TargetComponent : public Component
+	{
+		struct Data {
+			Data() : target(World::NullEntity), range(0.0f) { }
+			eid_t target;
+			float range;
+		};
+		Data data;
+
+		void serialize(SnapshotWriter& writer) const { writer.write(data); }
+		void deserialize(SnapshotReader& reader) { reader.read(data); }
+	};
+
+	ComponentBitmask healthAndArmor(World& world)
+	{
+		ComponentBitmask signature;
+		signature.setBit(world.getComponentId<HealthComponent>(), true);
+		signature.setBit(world.getComponentId<ArmorComponent>(), true);
+		return signature;
+	}
+
+	bool contains(const std::vector<eid_t>& entities, eid_t entity)
+	{
+		return std::find(entities.begin(), entities.end(), entity) != entities.end();
+	}
+}
+
+TEST_CASE ( "Query cache follows component changes", "[world][query]" )
+{
+	World world;
+	eid_t a = world.getNewEntity("a");
+	eid_t b = world.getNewEntity("b");
+	world.addComponent<HealthComponent>(a);
+	world.addComponent<ArmorComponent>(a);
+	world.addComponent<HealthComponent>(b);
+
+	ComponentBitmask signature = healthAndArmor(world);
+	const std::vector<eid_t>& matching = world.getEntitiesMatching(signature);
+	REQUIRE ( matching.size() == 1 );
+	REQUIRE ( contains(matching, a) );
+	REQUIRE ( world.getStats().queryRebuilds == 1 );
+
+	world.addComponent<ArmorComponent>(b);
+	REQUIRE ( world.getEntitiesMatching(signature).size() == 2 );
+	REQUIRE ( world.getStats().queryHits == 1 );
+
+	world.removeComponent<HealthComponent>(a);
+	REQUIRE ( !contains(world.getEntitiesMatching(signature), a) );
+
+	world.removeEntity(b);
+	REQUIRE ( contains(world.getEntitiesMatching(signature), b) );
+	world.cleanupEntities();
+	REQUIRE ( world.getEntitiesMatching(signature).size() == 0 );
+
+	// Prefabs are added to the cache once all their components are attached
+	Prefab prefab("prefab");
+	prefab.addConstructor(new DefaultComponentConstructor<HealthComponent>(HealthComponent::Data()));
+	prefab.addConstructor(new DefaultComponentConstructor<ArmorComponent>(ArmorComponent::Data()));
+	eid_t c = world.constructPrefab(prefab);
+	REQUIRE ( world.getEntitiesMatching(signature).size() == 1 );
+	REQUIRE ( contains(world.getEntitiesMatching(signature), c) );
+
+	REQUIRE ( world.getStats().queryRebuilds == 1 );
+	REQUIRE ( world.getStats().queryUpdates == 4 );
+
+	// An empty signature matches every entity, including empty ones
+	world.getNewEntity("empty");
+	REQUIRE ( world.getEntitiesMatching(ComponentBitmask()).size() == 3 );
+
+	world.clear();
+	REQUIRE ( world.getEntitiesMatching(signature).size() == 0 );
+}
+
+TEST_CASE ( "Deleted entity IDs stay dead after their slot is reused", "[world]" )
+{
+	World world;
+	eid_t first = world.getNewEntity("first");
+	world.addComponent<HealthComponent>(first)->data.health = 10;
+	REQUIRE ( world.isAlive(first) );
+	REQUIRE ( !world.isAlive(World::NullEntity) );
+
+	world.removeEntity(first);
+	REQUIRE ( world.isAlive(first) );
+	world.cleanupEntities();
+	REQUIRE ( !world.isAlive(first) );
+
+	// Churn through enough entities that the first slot gets handed out again
+	bool reused = false;
+	for (int i = 0; i < 5000 && !reused; i++) {
+		eid_t entity = world.getNewEntity();
+		world.addComponent<HealthComponent>(entity);
+		if (entityIndex(entity) == entityIndex(first)) {
+			reused = true;
+			REQUIRE ( entity != first );
+			REQUIRE ( world.isAlive(entity) );
+			REQUIRE ( !world.isAlive(first) );
+			REQUIRE ( world.getComponent<HealthComponent>(first) == nullptr );
+			REQUIRE ( world.getComponent<HealthComponent>(entity)->data.health == 0 );
+			REQUIRE ( world.getEntityName(first) == "" );
+		}
+		world.removeEntity(entity);
+		world.cleanupEntities();
+	}
+	REQUIRE ( reused );
+
+	// Removing a stale ID does nothing
+	eid_t live = world.getNewEntity("live");
+	world.removeEntity(first);
+	world.cleanupEntities();
+	REQUIRE ( world.isAlive(live) );
+}
+
+TEST_CASE ( "Cleanup only destroys removed entities", "[world]" )
+{
+	World world;
+	eid_t kept = world.getNewEntity("kept");
+	world.addComponent<HealthComponent>(kept)->data.health = 5;
+	world.addComponent<ArmorComponent>(kept);
+	eid_t healthOnly = world.getNewEntity("healthOnly");
+	world.addComponent<HealthComponent>(healthOnly);
+	eid_t both = world.getNewEntity("both");
+	world.addComponent<HealthComponent>(both);
+	world.addComponent<ArmorComponent>(both);
+
+	world.cleanupEntities();
+	REQUIRE ( world.getStats().lastCleanupDeletions == 0 );
+	REQUIRE ( world.getStats().lastCleanupMicros == 0.0 );
+
+	// Removing twice only deletes once
+	world.removeEntity(healthOnly);
+	world.removeEntity(both);
+	world.removeEntity(both);
+	world.cleanupEntities();
+	REQUIRE ( world.getStats().lastCleanupDeletions == 2 );
+	REQUIRE ( world.getStats().entitiesDeleted == 2 );
+	REQUIRE ( !world.isAlive(healthOnly) );
+	REQUIRE ( !world.isAlive(both) );
+	REQUIRE ( world.getEntitiesWithComponent<HealthComponent>() == std::vector<eid_t>({ kept }) );
+	REQUIRE ( world.getEntitiesWithComponent<ArmorComponent>() == std::vector<eid_t>({ kept }) );
+	REQUIRE ( world.getComponent<HealthComponent>(kept)->data.health == 5 );
+
+	world.cleanupEntities();
+	REQUIRE ( world.getStats().lastCleanupDeletions == 0 );
+	REQUIRE ( world.getStats().entitiesDeleted == 2 );
+
+	// Entities cleared out of the world are no longer waiting to be deleted
+	world.removeEntity(kept);
+	world.clear();
+	world.cleanupEntities();
+	REQUIRE ( world.getStats().lastCleanupDeletions == 0 );
+}
+
+TEST_CASE ( "Entities can be found by name", "[world]" )
+{
+	World world;
+	eid_t player = world.getNewEntity("Player");
+	eid_t first = world.getNewEntity("Spider");
+	eid_t second = world.getNewEntity("Spider");
+	eid_t third = world.getNewEntity("Spider");
+	eid_t unnamed = world.getNewEntity();
+
+	REQUIRE ( world.getEntityWithName("Player") == player );
+	REQUIRE ( world.getEntityWithName("Nobody") == World::NullEntity );
+	REQUIRE ( world.getEntityName(second) == "Spider" );
+	REQUIRE ( world.getEntityName(unnamed) == "Entity " + std::to_string(entityIndex(unnamed)) );
+
+	// The oldest entity with a name is found, whichever of them are deleted
+	REQUIRE ( world.getEntityWithName("Spider") == first );
+	world.removeEntity(second);
+	world.cleanupEntities();
+	REQUIRE ( world.getEntityWithName("Spider") == first );
+	world.removeEntity(first);
+	world.cleanupEntities();
+	REQUIRE ( world.getEntityWithName("Spider") == third );
+	eid_t fourth = world.getNewEntity("Spider");
+	world.removeEntity(third);
+	world.cleanupEntities();
+	REQUIRE ( world.getEntityWithName("Spider") == fourth );
+	REQUIRE ( world.getEntityName(third) == "" );
+
+	world.removeEntity(fourth);
+	world.cleanupEntities();
+	REQUIRE ( world.getEntityWithName("Spider") == World::NullEntity );
+	REQUIRE ( world.getEntityWithName("Player") == player );
+}
+
+TEST_CASE ( "Entities with a component can be listed without copying", "[world]" )
+{
+	World world;
+	REQUIRE ( world.first<HealthComponent>() == World::NullEntity );
+	REQUIRE ( world.count<HealthComponent>() == 0 );
+	REQUIRE ( world.each<HealthComponent>().empty() );
+
+	eid_t a = world.getNewEntity("a");
+	eid_t b = world.getNewEntity("b");
+	eid_t c = world.getNewEntity("c");
+	world.addComponent<HealthComponent>(a);
+	world.addComponent<HealthComponent>(b);
+	world.addComponent<HealthComponent>(c);
+	world.addComponent<ArmorComponent>(b);
+
+	std::vector<eid_t> visited;
+	visited.reserve(3);
+
+	AllocationCounter counter;
+	eid_t armored = world.first<ArmorComponent>();
+	size_t healthy = world.count<HealthComponent>();
+	for (eid_t entity : world.each<HealthComponent>()) {
+		visited.push_back(entity);
+	}
+	size_t allocations = counter.getAllocations();
+
+	REQUIRE ( allocations == 0 );
+	REQUIRE ( armored == b );
+	REQUIRE ( healthy == 3 );
+	REQUIRE ( visited == world.getEntitiesWithComponent<HealthComponent>() );
+	REQUIRE ( std::is_permutation(visited.begin(), visited.end(), std::vector<eid_t>({ a, b, c }).begin()) );
+
+	world.removeComponent<HealthComponent>(a);
+	REQUIRE ( world.count<HealthComponent>() == 2 );
+	REQUIRE ( !contains(std::vector<eid_t>(world.each<HealthComponent>().begin(), world.each<HealthComponent>().end()), a) );
+}
+
+TEST_CASE ( "Resources are stored once per type and track changes", "[world][resource]" )
+{
+	struct Level {
+		Level(int size) : size(size) { }
+		int size;
+	};
+
+	World world;
+	REQUIRE ( world.resource<Level>() == nullptr );
+	REQUIRE ( world.getResourceVersion<Level>() == 0 );
+
+	world.setResource<Level>(4);
+	REQUIRE ( world.resource<Level>()->size == 4 );
+	unsigned long long version = world.getResourceVersion<Level>();
+	REQUIRE ( version != 0 );
+
+	// Reading doesn't count as a change; marking or replacing does
+	world.resource<Level>()->size = 5;
+	REQUIRE ( world.getResourceVersion<Level>() == version );
+	world.markResourceChanged<Level>();
+	REQUIRE ( world.getResourceVersion<Level>() != version );
+	version = world.getResourceVersion<Level>();
+
+	Level& replaced = world.setResource<Level>(8);
+	REQUIRE ( &replaced == world.resource<Level>() );
+	REQUIRE ( world.resource<Level>()->size == 8 );
+	REQUIRE ( world.getResourceVersion<Level>() != version );
+
+	// Resources belong to the world, not its entities
+	world.setResource<eid_t>(world.getNewEntity("player"));
+	world.clear();
+	REQUIRE ( world.resource<Level>() != nullptr );
+	REQUIRE ( !world.isAlive(*world.resource<eid_t>()) );
+
+	version = world.getResourceVersion<Level>();
+	world.removeResource<Level>();
+	REQUIRE ( world.resource<Level>() == nullptr );
+	REQUIRE ( world.getResourceVersion<Level>() != version );
+	REQUIRE ( world.getResourceVersion<Level>() != 0 );
+
+	World other;
+	REQUIRE ( other.resource<eid_t>() == nullptr );
+}
+
+TEST_CASE ( "Snapshots restore entities and their serializable components", "[world][snapshot]" )
+{
+	REQUIRE ( IsSnapshotSerializable<TargetComponent>::value );
+	REQUIRE ( !IsSnapshotSerializable<HealthComponent>::value );
+
+	World world;
+	eid_t hunter = world.getNewEntity("hunter");
+	eid_t prey = world.getNewEntity("prey");
+	eid_t doomed = world.getNewEntity("doomed");
+	world.addComponent<TargetComponent>(hunter)->data.target = prey;
+	world.getComponent<TargetComponent>(hunter)->data.range = 2.5f;
+	world.addComponent<HealthComponent>(prey)->data.health = 10;
+	world.addComponent<TargetComponent>(prey);
+	world.removeEntity(doomed);
+	ComponentBitmask targetSignature;
+	targetSignature.setBit(world.getComponentId<TargetComponent>(), true);
+	const std::vector<eid_t>& targeting = world.getEntitiesMatching(targetSignature);
+
+	std::vector<char> snapshot;
+	world.snapshot(snapshot);
+
+	// Change everything the snapshot covers
+	world.getComponent<TargetComponent>(hunter)->data.range = 9.0f;
+	world.removeComponent<TargetComponent>(prey);
+	world.cleanupEntities();
+	eid_t later = world.getNewEntity("later");
+	world.addComponent<TargetComponent>(later);
+
+	REQUIRE ( world.restore(snapshot) );
+	REQUIRE ( world.getComponent<TargetComponent>(hunter)->data.target == prey );
+	REQUIRE ( world.getComponent<TargetComponent>(hunter)->data.range == 2.5f );
+	REQUIRE ( world.getComponent<TargetComponent>(prey) != nullptr );
+	REQUIRE ( !world.isAlive(later) );
+	REQUIRE ( world.getEntityWithName("hunter") == hunter );
+	REQUIRE ( world.getEntityWithName("later") == World::NullEntity );
+	REQUIRE ( targeting.size() == 2 );
+
+	// Components without hooks aren't stored, and pending deletions still happen
+	REQUIRE ( world.getComponent<HealthComponent>(prey) == nullptr );
+	REQUIRE ( world.isAlive(doomed) );
+	world.cleanupEntities();
+	REQUIRE ( !world.isAlive(doomed) );
+	REQUIRE ( world.getNewEntity() != doomed );
+
+	// Another world can take the snapshot, whatever order it registered its components in
+	World other;
+	other.getComponentId<HealthComponent>();
+	other.getComponentId<TargetComponent>();
+	REQUIRE ( other.restore(snapshot) );
+	REQUIRE ( other.getComponent<TargetComponent>(hunter)->data.target == prey );
+	REQUIRE ( other.getEntityName(prey) == "prey" );
+	REQUIRE ( other.count<TargetComponent>() == 2 );
+
+	// Data which isn't a snapshot leaves the world alone
+	std::vector<char> garbage(snapshot.begin(), snapshot.begin() + 4);
+	garbage[0] = 'X';
+	REQUIRE ( !other.restore(garbage) );
+	REQUIRE ( other.count<TargetComponent>() == 2 );
+	std::vector<char> truncated(snapshot.begin(), snapshot.end() - 1);
+	REQUIRE ( !other.restore(truncated) );
+	REQUIRE ( other.count<TargetComponent>() == 0 );
+}
+
+TEST_CASE ( "Equal worlds give identical snapshots", "[world][snapshot]" )
+{
+	auto build = [](World& world) {
+		eid_t hunter = world.getNewEntity("hunter");
+		eid_t prey = world.getNewEntity();
+		world.addComponent<TargetComponent>(hunter)->data.target = prey;
+		world.addComponent<TargetComponent>(prey)->data.range = 4.0f;
+		world.removeEntity(world.getNewEntity("doomed"));
+	};
+
+	World world;
+	build(world);
+	std::vector<char> first, second;
+	world.snapshot(first);
+	world.snapshot(second);
+	REQUIRE ( first == second );
+
+	// Entity slots are written without their padding, so a world built the same way
+	// elsewhere, or restored from the snapshot, gives the same bytes
+	World twin;
+	build(twin);
+	twin.snapshot(second);
+	REQUIRE ( first == second );
+
+	World restored;
+	restored.getComponentId<TargetComponent>();
+	REQUIRE ( restored.restore(first) );
+	restored.snapshot(second);
+	REQUIRE ( first == second );
+}
+
+TEST_CASE ( "Entity slots are recycled under churn", "[world]" )
+{
+	World world;
+	uint32_t highestIndex = 0;
+	for (int i = 0; i < 100000; i++) {
+		eid_t entity = world.getNewEntity("churn");
+		highestIndex = std::max(highestIndex, entityIndex(entity));
+		world.removeEntity(entity);
+		world.cleanupEntities();
+	}
+	REQUIRE ( highestIndex < 2048 );
+
+	world.clear();
+	REQUIRE ( world.getEntityWithName("churn") == World::NullEntity );
+}
+
+namespace
+{
+	template <int I>
+	struct QueryComponent : public Component { };
+
+	template <int I>
+	class QuerySystem : public System
+	{
+	public:
+		QuerySystem(World& world) : System(world)
+		{
+			require<QueryComponent<I>>();
+			require<QueryComponent<(I + 1) % 8>>();
+		}
+		void updateEntity(float dt, eid_t entity) { benchmarkSink += entity; }
+	};
+
+	/*! Matches entities the way System did before the query cache. */
+	template <int I>
+	class ScanSystem : public QuerySystem<I>
+	{
+	public:
+		ScanSystem(World& world) : QuerySystem<I>(world) { }
+		void update(float dt)
+		{
+			World::eid_iterator iter = this->world.getEidIterator(this->requiredComponents);
+			for (; !iter.atEnd(); iter.next()) {
+				this->updateEntity(dt, iter.value());
+			}
+		}
+	};
+
+	template <int I>
+	void addIfSet(World& world, eid_t entity, unsigned bits)
+	{
+		if (bits & (1 << I)) {
+			world.addComponent<QueryComponent<I>>(entity);
+		}
+	}
+
+	void benchmarkQueries(unsigned entityCount)
+	{
+		World world;
+		for (unsigned i = 0; i < entityCount; i++) {
+			// A sparse mix of components, so most systems match few entities
+			unsigned bits = (i * 2654435761u) >> 24;
+			bits &= bits >> 1 | bits << 7;
+			eid_t entity = world.getNewEntity("e");
+			addIfSet<0>(world, entity, bits); addIfSet<1>(world, entity, bits);
+			addIfSet<2>(world, entity, bits); addIfSet<3>(world, entity, bits);
+			addIfSet<4>(world, entity, bits); addIfSet<5>(world, entity, bits);
+			addIfSet<6>(world, entity, bits); addIfSet<7>(world, entity, bits);
+		}
+
+		std::vector<std::unique_ptr<System>> scanSystems;
+		scanSystems.emplace_back(new ScanSystem<0>(world)); scanSystems.emplace_back(new ScanSystem<1>(world));
+		scanSystems.emplace_back(new ScanSystem<2>(world)); scanSystems.emplace_back(new ScanSystem<3>(world));
+		scanSystems.emplace_back(new ScanSystem<4>(world)); scanSystems.emplace_back(new ScanSystem<5>(world));
+		scanSystems.emplace_back(new ScanSystem<6>(world)); scanSystems.emplace_back(new ScanSystem<7>(world));
+
+		std::vector<std::unique_ptr<System>> systems;
+		systems.emplace_back(new QuerySystem<0>(world)); systems.emplace_back(new QuerySystem<1>(world));
+		systems.emplace_back(new QuerySystem<2>(world)); systems.emplace_back(new QuerySystem<3>(world));
+		systems.emplace_back(new QuerySystem<4>(world)); systems.emplace_back(new QuerySystem<5>(world));
+		systems.emplace_back(new QuerySystem<6>(world)); systems.emplace_back(new QuerySystem<7>(world));
+
+		const unsigned runs = std::max(1u, 1000000u / entityCount);
+		double scanTime = benchmark(runs, [&]() {
+			for (auto& system : scanSystems) {
+				system->update(0.016f);
+			}
+		});
+
+		world.resetStats();
+		double cachedTime = benchmark(runs, [&]() {
+			for (auto& system : systems) {
+				system->update(0.016f);
+			}
+		});
+
+		reportBenchmark("8 systems, eid_iterator scan", entityCount, scanTime);
+		reportBenchmark("8 systems, query cache", entityCount, cachedTime);
+		printf("  query hits %llu, rebuilds %llu\n", world.getStats().queryHits, world.getStats().queryRebuilds);
+	}
+}
+
+TEST_CASE ( "System matching: entity scan vs query cache", "[.][benchmark]" )
+{
+	benchmarkQueries(1000);
+	benchmarkQueries(10000);
+	benchmarkQueries(100000);
+}
+
+TEST_CASE ( "Entity cleanup: per-frame cost", "[.][benchmark]" )
+{
+	const unsigned entityCount = 100000;
+	const unsigned runs = 200;
+
+	World world;
+	auto spawn = [&world](unsigned i) {
+		eid_t entity = world.getNewEntity("e");
+		unsigned bits = (i * 2654435761u) >> 24;
+		addIfSet<0>(world, entity, bits); addIfSet<1>(world, entity, bits);
+		addIfSet<2>(world, entity, bits); addIfSet<3>(world, entity, bits);
+		addIfSet<4>(world, entity, bits); addIfSet<5>(world, entity, bits);
+		addIfSet<6>(world, entity, bits); addIfSet<7>(world, entity, bits);
+		return entity;
+	};
+
+	std::vector<eid_t> entities;
+	for (unsigned i = 0; i < entityCount; i++) {
+		entities.push_back(spawn(i));
+	}
+
+	double idleTime = benchmark(runs, [&]() { world.cleanupEntities(); });
+	reportBenchmark("cleanupEntities, nothing deleted", entityCount, idleTime);
+
+	for (unsigned deletions : { 10u, 100u, 1000u }) {
+		unsigned next = 0;
+		double cleanupMicros = 0.0;
+		benchmark(runs, [&]() {
+			for (unsigned i = 0; i < deletions; i++) {
+				size_t index = (next * 7919u) % entities.size();
+				world.removeEntity(entities[index]);
+				entities[index] = spawn(next++);
+			}
+			world.cleanupEntities();
+			cleanupMicros += world.getStats().lastCleanupMicros;
+		});
+
+		char name[64];
+		snprintf(name, sizeof(name), "cleanupEntities, %u deleted per frame", deletions);
+		reportBenchmark(name, deletions, cleanupMicros / runs);
+	}
+}
+
+TEST_CASE ( "Component lookup: getComponent hot path", "[.][benchmark]" )
+{
+	const unsigned entityCount = 10000;
+	const unsigned runs = 200;
+
+	World world;
+	std::vector<eid_t> entities;
+	for (unsigned i = 0; i < entityCount; i++) {
+		eid_t entity = world.getNewEntity("e");
+		world.addComponent<HealthComponent>(entity)->data.health = (int)i;
+		world.addComponent<ArmorComponent>(entity);
+		entities.push_back(entity);
+	}
+
+	// What a system does for each of its entities: fetch a couple of components and use them
+	double lookupTime = benchmark(runs, [&]() {
+		for (eid_t entity : entities) {
+			benchmarkSink += world.getComponent<HealthComponent>(entity)->data.health;
+			benchmarkSink += (world.getComponent<ArmorComponent>(entity) != nullptr);
+		}
+	});
+	reportBenchmark("getComponent x2 per entity", entityCount, lookupTime);
+}
+
+TEST_CASE ( "World snapshot: snapshot and restore vs rebuilding", "[.][benchmark]" )
+{
+	const unsigned entityCount = 10000;
+	const unsigned runs = 100;
+
+	Prefab prefab("e");
+	prefab.addConstructor(new DefaultComponentConstructor<TargetComponent>(TargetComponent::Data()));
+	World world;
+	auto build = [&]() {
+		for (unsigned i = 0; i < entityCount; i++) {
+			eid_t entity = world.constructPrefab(prefab);
+			world.getComponent<TargetComponent>(entity)->data.range = (float)i;
+		}
+	};
+	build();
+
+	std::vector<char> snapshot;
+	double snapshotTime = benchmark(runs, [&]() {
+		world.snapshot(snapshot);
+		benchmarkSink += snapshot.size();
+	});
+	reportBenchmark("World::snapshot", entityCount, snapshotTime);
+
+	double restoreTime = benchmark(runs, [&]() {
+		world.restore(snapshot);
+		benchmarkSink += world.count<TargetComponent>();
+	});
+	reportBenchmark("World::restore", entityCount, restoreTime);
+
+	// What restarting does today: throw the world away and construct it all again
+	double rebuildTime = benchmark(runs, [&]() {
+		world.clear();
+		build();
+		benchmarkSink += world.count<TargetComponent>();
+	});
+	reportBenchmark("World::clear + constructPrefab", entityCount, rebuildTime);
+	printf("Snapshot size: %zu bytes\n", snapshot.size());
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "AllocationCounter.h"
+#include "Framework/WorldCommandBuffer.h"
+#include "Framework/Prefab.h"
+#include "Framework/DefaultComponentConstructor.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct NameTagComponent : public Component
+	{
+		struct Data {
+			Data() : tag(0) { }
+			int tag;
+		};
+		Data data;
+	};
+
+	struct OwnerComponent : public Component
+	{
+		OwnerComponent() : owner(World::NullEntity) { }
+		eid_t owner;
+	};
+
+	struct MarkerComponent : public Component { };
+
+	template <class T>
+	ComponentBitmask signatureOf(World& world)
+	{
+		ComponentBitmask signature;
+		signature.setBit(world.getComponentId<T>(), true);
+		return signature;
+	}
+}
+
+TEST_CASE ( "Command buffers apply changes on playback", "[world][commands]" )
+{
+	World world;
+	eid_t existing = world.getNewEntity("existing");
+	world.addComponent<NameTagComponent>(existing)->data.tag = 1;
+	const std::vector<eid_t>& tagged = world.getEntitiesMatching(signatureOf<NameTagComponent>(world));
+	const std::vector<eid_t>& owned = world.getEntitiesMatching(signatureOf<OwnerComponent>(world));
+
+	WorldCommandBuffer commands(world);
+	eid_t created = commands.createEntity("created");
+	commands.addComponent<NameTagComponent>(created).data.tag = 2;
+	commands.addComponent<OwnerComponent>(created).owner = existing;
+	commands.addComponent<OwnerComponent>(existing).owner = created;
+	commands.removeComponent<NameTagComponent>(existing);
+
+	// Nothing happens until playback, but the new entity already has its ID
+	REQUIRE ( !commands.empty() );
+	REQUIRE ( created != existing );
+	REQUIRE ( !world.isAlive(created) );
+	REQUIRE ( world.getComponent<OwnerComponent>(existing) == nullptr );
+	REQUIRE ( world.getComponent<NameTagComponent>(existing) != nullptr );
+
+	world.resetStats();
+	commands.playback();
+	REQUIRE ( commands.empty() );
+	REQUIRE ( world.isAlive(created) );
+	REQUIRE ( world.getEntityName(created) == "created" );
+	REQUIRE ( world.getComponent<NameTagComponent>(created)->data.tag == 2 );
+	REQUIRE ( world.getComponent<OwnerComponent>(created)->owner == existing );
+	REQUIRE ( world.getComponent<OwnerComponent>(existing)->owner == created );
+	REQUIRE ( world.getComponent<NameTagComponent>(existing) == nullptr );
+
+	REQUIRE ( tagged == std::vector<eid_t>({ created }) );
+	REQUIRE ( owned.size() == 2 );
+	// Each entity moves between queries once, however many of its components changed
+	REQUIRE ( world.getStats().queryUpdates == 4 );
+
+	// Commands on entities which are gone by playback are dropped
+	commands.addComponent<MarkerComponent>(existing);
+	commands.removeEntity(created);
+	world.removeEntity(existing);
+	world.cleanupEntities();
+	commands.playback();
+	REQUIRE ( world.getEntitiesWithComponent<MarkerComponent>().size() == 0 );
+	REQUIRE ( world.isAlive(created) );
+	world.cleanupEntities();
+	REQUIRE ( !world.isAlive(created) );
+}
+
+TEST_CASE ( "Command buffers construct prefabs as reserved entities", "[world][commands]" )
+{
+	World world;
+	Prefab prefab("prefab");
+	NameTagComponent::Data data;
+	data.tag = 7;
+	prefab.addConstructor(new DefaultComponentConstructor<NameTagComponent>(data));
+
+	WorldCommandBuffer commands(world);
+	eid_t entity = commands.constructPrefab(prefab);
+	commands.addComponent<MarkerComponent>(entity);
+	REQUIRE ( !world.isAlive(entity) );
+
+	commands.playback();
+	REQUIRE ( world.getEntityName(entity) == "prefab" );
+	REQUIRE ( world.getComponent<NameTagComponent>(entity)->data.tag == 7 );
+	REQUIRE ( world.getComponent<MarkerComponent>(entity) != nullptr );
+}
+
+TEST_CASE ( "Command buffers can record on several threads at once", "[world][commands]" )
+{
+	const unsigned threadCount = 4;
+	const unsigned entitiesPerThread = 500;
+
+	World world;
+	world.getComponentId<NameTagComponent>();
+
+	std::vector<std::unique_ptr<WorldCommandBuffer>> buffers;
+	std::vector<std::vector<eid_t>> created(threadCount);
+	std::vector<std::thread> threads;
+	for (unsigned i = 0; i < threadCount; i++) {
+		buffers.emplace_back(new WorldCommandBuffer(world));
+	}
+	for (unsigned i = 0; i < threadCount; i++) {
+		threads.emplace_back([&, i]() {
+			for (unsigned j = 0; j < entitiesPerThread; j++) {
+				eid_t entity = buffers[i]->createEntity();
+				buffers[i]->addComponent<NameTagComponent>(entity).data.tag = (int)i;
+				created[i].push_back(entity);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	std::vector<eid_t> all;
+	for (unsigned i = 0; i < threadCount; i++) {
+		buffers[i]->playback();
+		all.insert(all.end(), created[i].begin(), created[i].end());
+	}
+	std::sort(all.begin(), all.end());
+	REQUIRE ( std::unique(all.begin(), all.end()) == all.end() );
+
+	for (unsigned i = 0; i < threadCount; i++) {
+		for (eid_t entity : created[i]) {
+			REQUIRE ( world.getComponent<NameTagComponent>(entity)->data.tag == (int)i );
+		}
+	}
+
+	// Normal creation carries on after the reserved slots
+	eid_t next = world.getNewEntity();
+	REQUIRE ( std::find(all.begin(), all.end(), next) == all.end() );
+}
+
+TEST_CASE ( "Spawning and despawning reaches a steady state without allocating", "[world][commands]" )
+{
+	World world;
+	Prefab flashPrefab("flash");
+	flashPrefab.addConstructor(new DefaultComponentConstructor<NameTagComponent>(NameTagComponent::Data()));
+	Prefab tracerPrefab("tracer");
+	tracerPrefab.addConstructor(new DefaultComponentConstructor<NameTagComponent>(NameTagComponent::Data()));
+	const std::vector<eid_t>& owned = world.getEntitiesMatching(signatureOf<OwnerComponent>(world));
+
+	// Each frame fires a few shots, each of which leaves a muzzle flash and a tracer
+	// owned by it, and clears away the previous frame's shots
+	WorldCommandBuffer commands(world);
+	std::vector<eid_t> live;
+	live.reserve(64);
+	auto frame = [&]() {
+		for (eid_t entity : live) {
+			world.removeEntity(entity);
+		}
+		live.clear();
+		world.cleanupEntities();
+
+		for (int i = 0; i < 8; i++) {
+			eid_t flash = world.constructPrefab(flashPrefab);
+			eid_t tracer = commands.constructPrefab(tracerPrefab);
+			commands.addComponent<OwnerComponent>(tracer).owner = flash;
+			world.addComponent<MarkerComponent>(flash);
+			live.push_back(flash);
+			live.push_back(tracer);
+		}
+		commands.playback();
+	};
+
+	// Let the pools, queries and free lists grow to fit
+	for (int i = 0; i < 100; i++) {
+		frame();
+	}
+
+	AllocationCounter counter;
+	for (int i = 0; i < 1000; i++) {
+		frame();
+	}
+	size_t allocations = counter.getAllocations();
+
+	REQUIRE ( allocations == 0 );
+	REQUIRE ( owned.size() == 8 );
+	REQUIRE ( world.getEntitiesWithComponent<MarkerComponent>().size() == 8 );
+}
+
+TEST_CASE ( "Structural changes: immediate vs command buffer", "[.][benchmark]" )
+{
+	const unsigned entityCount = 20000;
+	const unsigned runs = 20;
+
+	// A long-running world with a few cached queries, which spawns a wave of entities
+	// and then clears them out again, as a game would between frames
+	World world;
+	world.getEntitiesMatching(signatureOf<NameTagComponent>(world));
+	world.getEntitiesMatching(signatureOf<OwnerComponent>(world));
+	world.getEntitiesMatching(signatureOf<NameTagComponent>(world) | signatureOf<OwnerComponent>(world));
+	auto despawn = [&world]() {
+		for (eid_t entity : world.getEntitiesWithComponent<MarkerComponent>()) {
+			world.removeEntity(entity);
+		}
+		world.cleanupEntities();
+	};
+
+	double immediateTime = benchmark(runs, [&]() {
+		for (unsigned i = 0; i < entityCount; i++) {
+			eid_t entity = world.getNewEntity("spawned");
+			world.addComponent<NameTagComponent>(entity)->data.tag = (int)i;
+			world.addComponent<OwnerComponent>(entity);
+			world.addComponent<MarkerComponent>(entity);
+		}
+		benchmarkSink += world.getEntitiesWithComponent<MarkerComponent>().size();
+		despawn();
+	});
+	reportBenchmark("Spawn + despawn wave, immediate", entityCount, immediateTime);
+
+	WorldCommandBuffer commands(world);
+	double bufferedTime = benchmark(runs, [&]() {
+		for (unsigned i = 0; i < entityCount; i++) {
+			eid_t entity = commands.createEntity("spawned");
+			commands.addComponent<NameTagComponent>(entity).data.tag = (int)i;
+			commands.addComponent<OwnerComponent>(entity);
+			commands.addComponent<MarkerComponent>(entity);
+		}
+		commands.playback();
+		benchmarkSink += world.getEntitiesWithComponent<MarkerComponent>().size();
+		despawn();
+	});
+	reportBenchmark("Spawn + despawn wave, command buffer", entityCount, bufferedTime);
+}
\ No newline at end of file
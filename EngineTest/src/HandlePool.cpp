@@ -0,0 +1,329 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "HandlePool.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	struct Counted
+	{
+		Counted(int value) : value(value) { ++alive; }
+		Counted(const Counted& other) : value(other.value) { ++alive; }
+		Counted(Counted&& other) : value(other.value) { ++alive; }
+		Counted& operator=(const Counted& other) = default;
+		Counted& operator=(Counted&& other) = default;
+		~Counted() { --alive; }
+		int value;
+		static int alive;
+	};
+	int Counted::alive = 0;
+
+	/*! Like the renderer's entities, which hold handles to their models. */
+	struct Holder
+	{
+		HandlePool<int>::Handle inner;
+	};
+
+	int valueOf(HandlePool<Counted>& pool, const HandlePool<Counted>::Handle& handle)
+	{
+		std::experimental::optional<std::reference_wrapper<Counted>> counted = pool.get(handle);
+		return counted ? counted->get().value : -1;
+	}
+
+	/*! How HandlePool used to store objects: a hash map keyed by the ID in a shared_ptr,
+		whose deleter erased the object. */
+	template <class T>
+	class MapHandlePool
+	{
+	public:
+		struct HandleData {
+			HandleData(uint32_t handle) : handle(handle) { }
+			uint32_t handle;
+		};
+		using Pool = std::unordered_map<uint32_t, T>;
+		using Handle = std::shared_ptr<HandleData>;
+
+		MapHandlePool() : nextHandle(0), pool(new Pool) { }
+
+		Handle getNewHandle(const T& obj)
+		{
+			pool->emplace(nextHandle, obj);
+			std::weak_ptr<Pool> weakPool(pool);
+			Handle handle(new HandleData(nextHandle), [weakPool](HandleData* data) {
+				if (!weakPool.expired()) {
+					weakPool.lock()->erase(data->handle);
+				}
+				delete data;
+			});
+			nextHandle++;
+			return handle;
+		}
+
+		T* get(const Handle& handle)
+		{
+			auto iter = pool->find(handle->handle);
+			return iter == pool->end() ? nullptr : &iter->second;
+		}
+
+		typename Pool::iterator begin() { return pool->begin(); }
+		typename Pool::iterator end() { return pool->end(); }
+	private:
+		uint32_t nextHandle;
+		std::shared_ptr<Pool> pool;
+	};
+
+	/*! About the size of a renderable: a transform and some state. */
+	struct BenchObject
+	{
+		BenchObject() : transform(), time(0.0f) { }
+		float transform[16];
+		float time;
+	};
+}
+
+TEST_CASE ( "Handle pool objects live as long as their handles", "[handlepool]" )
+{
+	Counted::alive = 0;
+	{
+		HandlePool<Counted> pool;
+		HandlePool<Counted>::Handle first = pool.getNewHandle(Counted(1));
+		HandlePool<Counted>::Handle second = pool.getNewHandle(Counted(2));
+		REQUIRE ( pool.size() == 2 );
+		REQUIRE ( Counted::alive == 2 );
+		REQUIRE ( valueOf(pool, first) == 1 );
+		REQUIRE ( valueOf(pool, second) == 2 );
+
+		// Copies keep the object alive
+		HandlePool<Counted>::Handle copy = first;
+		first = nullptr;
+		REQUIRE ( !first );
+		REQUIRE ( valueOf(pool, copy) == 1 );
+		copy.reset();
+		REQUIRE ( pool.size() == 1 );
+		REQUIRE ( Counted::alive == 1 );
+
+		// The last object was moved into the hole, and is still found
+		REQUIRE ( valueOf(pool, second) == 2 );
+
+		// Null handles find nothing
+		REQUIRE ( valueOf(pool, HandlePool<Counted>::Handle()) == -1 );
+		REQUIRE ( valueOf(pool, pool.invalidHandle) == -1 );
+	}
+	REQUIRE ( Counted::alive == 0 );
+}
+
+TEST_CASE ( "Stale handles don't find objects in reused slots", "[handlepool]" )
+{
+	HandlePool<Counted> pool;
+	HandlePool<Counted>::WeakHandle weak = pool.insert(Counted(1));
+	pool.erase(weak);
+	REQUIRE ( !pool.get(weak) );
+	REQUIRE ( pool.size() == 0 );
+
+	// The slot is reused, on the next generation
+	HandlePool<Counted>::WeakHandle reused = pool.insert(Counted(2));
+	REQUIRE ( reused.index == weak.index );
+	REQUIRE ( reused.generation != weak.generation );
+	REQUIRE ( !pool.get(weak) );
+	REQUIRE ( pool.get(reused)->get().value == 2 );
+
+	// Erasing under ref-counted handles invalidates every copy
+	HandlePool<Counted>::Handle handle = pool.getNewHandle(Counted(3));
+	HandlePool<Counted>::Handle copy = handle;
+	pool.erase(handle);
+	REQUIRE ( valueOf(pool, handle) == -1 );
+	REQUIRE ( valueOf(pool, copy) == -1 );
+	REQUIRE ( pool.size() == 1 );
+
+	// The slot isn't reused while they still refer to it
+	HandlePool<Counted>::WeakHandle other = pool.insert(Counted(4));
+	REQUIRE ( other.index != handle.getWeakHandle().index );
+	handle.reset();
+	copy.reset();
+	REQUIRE ( pool.get(other)->get().value == 4 );
+	REQUIRE ( pool.get(reused)->get().value == 2 );
+}
+
+TEST_CASE ( "Handle pools iterate over every object densely", "[handlepool]" )
+{
+	HandlePool<int> pool;
+	std::vector<HandlePool<int>::Handle> handles;
+	for (int i = 0; i < 100; i++) {
+		handles.push_back(pool.getNewHandle(i));
+	}
+	for (int i = 0; i < 100; i += 3) {
+		handles[i].reset();
+	}
+
+	std::vector<int> values(pool.begin(), pool.end());
+	std::sort(values.begin(), values.end());
+	REQUIRE ( values.size() == pool.size() );
+	for (int value : values) {
+		REQUIRE ( value % 3 != 0 );
+	}
+	for (int i = 0; i < 100; i++) {
+		REQUIRE ( (bool)pool.get(handles[i]) == (i % 3 != 0) );
+		if (i % 3 != 0) {
+			REQUIRE ( pool.get(handles[i])->get() == i );
+		}
+	}
+}
+
+TEST_CASE ( "Handles can outlive their pool", "[handlepool]" )
+{
+	Counted::alive = 0;
+	HandlePool<Counted>::Handle survivor;
+	HandlePool<int>::Handle inner;
+	{
+		HandlePool<Counted> pool;
+		survivor = pool.getNewHandle(Counted(1));
+
+		// Objects holding handles into another pool release them as they go
+		HandlePool<int> innerPool;
+		HandlePool<Holder> holders;
+		Holder holder;
+		holder.inner = innerPool.getNewHandle(5);
+		HandlePool<Holder>::Handle holderHandle = holders.getNewHandle(holder);
+		holder.inner.reset();
+		inner = holders.get(holderHandle)->get().inner;
+		REQUIRE ( innerPool.size() == 1 );
+		holderHandle.reset();
+		REQUIRE ( holders.size() == 0 );
+		REQUIRE ( innerPool.get(inner)->get() == 5 );
+	}
+	// The objects went with their pools
+	REQUIRE ( Counted::alive == 0 );
+	HandlePool<Counted>::Handle copy = survivor;
+	survivor.reset();
+	copy.reset();
+	inner.reset();
+}
+
+TEST_CASE ( "Sorting a handle pool keeps handles pointing at their objects", "[handlepool]" )
+{
+	std::vector<int> values(500);
+	for (unsigned i = 0; i < values.size(); i++) {
+		values[i] = (int)i;
+	}
+	std::shuffle(values.begin(), values.end(), std::mt19937(99));
+
+	HandlePool<Counted> pool;
+	std::vector<HandlePool<Counted>::Handle> handles;
+	for (int value : values) {
+		handles.push_back(pool.getNewHandle(Counted(value)));
+	}
+	REQUIRE ( !pool.isSorted() );
+
+	pool.sort([](const Counted& c1, const Counted& c2) { return c1.value < c2.value; });
+	REQUIRE ( pool.isSorted() );
+	int expected = 0;
+	for (auto iter = pool.begin(); iter != pool.end(); ++iter) {
+		REQUIRE ( iter->value == expected++ );
+	}
+	for (unsigned i = 0; i < values.size(); i++) {
+		REQUIRE ( valueOf(pool, handles[i]) == values[i] );
+	}
+
+	// Removing from an unordered pool, or adding to any, breaks the order
+	handles[0].reset();
+	REQUIRE ( !pool.isSorted() );
+	pool.sort([](const Counted& c1, const Counted& c2) { return c1.value > c2.value; });
+	REQUIRE ( pool.begin()->value == 499 - (values[0] == 499 ? 1 : 0) );
+	handles.push_back(pool.getNewHandle(Counted(1000)));
+	REQUIRE ( !pool.isSorted() );
+}
+
+TEST_CASE ( "Stable handle pools keep their order through removals", "[handlepool]" )
+{
+	HandlePool<Counted> pool(HandlePoolOrder_Stable);
+	std::vector<HandlePool<Counted>::Handle> handles;
+	for (int i = 0; i < 10; i++) {
+		handles.push_back(pool.getNewHandle(Counted(i % 3)));
+	}
+
+	// Equal keys stay in the order they were added
+	pool.sort([](const Counted& c1, const Counted& c2) { return c1.value < c2.value; });
+	handles[3].reset();
+	handles[4].reset();
+	REQUIRE ( pool.isSorted() );
+
+	std::vector<int> indices;
+	for (auto iter = pool.begin(); iter != pool.end(); ++iter) {
+		for (int i = 0; i < 10; i++) {
+			if (handles[i] && &pool.get(handles[i])->get() == &*iter) {
+				indices.push_back(i);
+			}
+		}
+	}
+	REQUIRE ( indices == std::vector<int>({ 0, 6, 9, 1, 7, 2, 5, 8 }) );
+}
+
+TEST_CASE ( "Handle pool lookup: hash map vs dense", "[.][benchmark]" )
+{
+	const unsigned objectCount = 2000;
+	const unsigned runs = 2000;
+
+	// Released in a random order first, so that neither pool is laid out in handle order
+	std::vector<unsigned> order(objectCount * 2);
+	for (unsigned i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	std::shuffle(order.begin(), order.end(), std::mt19937(1234));
+
+	MapHandlePool<BenchObject> mapPool;
+	HandlePool<BenchObject> densePool;
+	std::vector<MapHandlePool<BenchObject>::Handle> mapHandles;
+	std::vector<HandlePool<BenchObject>::Handle> denseHandles;
+	for (unsigned i = 0; i < order.size(); i++) {
+		mapHandles.push_back(mapPool.getNewHandle(BenchObject()));
+		denseHandles.push_back(densePool.getNewHandle(BenchObject()));
+	}
+	for (unsigned i = 0; i < objectCount; i++) {
+		mapHandles[order[i]].reset();
+		denseHandles[order[i]].reset();
+	}
+	mapHandles.erase(std::remove(mapHandles.begin(), mapHandles.end(), nullptr), mapHandles.end());
+	denseHandles.erase(std::remove(denseHandles.begin(), denseHandles.end(), nullptr), denseHandles.end());
+
+	// Like setRenderableTransform, once per renderable per frame
+	double mapTime = benchmark(runs, [&]() {
+		for (const MapHandlePool<BenchObject>::Handle& handle : mapHandles) {
+			mapPool.get(handle)->time += 1.0f;
+		}
+	});
+	reportBenchmark("unordered_map lookup", objectCount, mapTime);
+
+	double denseTime = benchmark(runs, [&]() {
+		for (const HandlePool<BenchObject>::Handle& handle : denseHandles) {
+			densePool.get(handle)->get().time += 1.0f;
+		}
+	});
+	reportBenchmark("Generational dense lookup", objectCount, denseTime);
+
+	// Like Renderer::update, over every renderable
+	double mapIterTime = benchmark(runs, [&]() {
+		for (auto iter = mapPool.begin(); iter != mapPool.end(); ++iter) {
+			iter->second.time += iter->second.transform[12];
+		}
+	});
+	reportBenchmark("unordered_map iteration", objectCount, mapIterTime);
+
+	double denseIterTime = benchmark(runs, [&]() {
+		for (auto iter = densePool.begin(); iter != densePool.end(); ++iter) {
+			iter->time += iter->transform[12];
+		}
+	});
+	reportBenchmark("Dense iteration", objectCount, denseIterTime);
+
+	for (auto iter = densePool.begin(); iter != densePool.end(); ++iter) {
+		benchmarkSink += (unsigned long long)iter->time;
+	}
+	for (auto iter = mapPool.begin(); iter != mapPool.end(); ++iter) {
+		benchmarkSink += (unsigned long long)iter->second.time;
+	}
+}
@@ -0,0 +1,118 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "Math/ComposeTRS.h"
+
+#include <glm/gtx/quaternion.hpp>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+	/*! How Transform::toMat4 built its matrix before composeTRS. */
+	glm::mat4 referenceTRS(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		glm::mat4 posMatrix = glm::mat4(
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			position.x, position.y, position.z, 1.0f
+			);
+		glm::mat4 rotMatrix(glm::toMat4(rotation));
+		glm::mat4 scaleMatrix = glm::mat4(
+			scale.x, 0.0f, 0.0f, 0.0f,
+			0.0f, scale.y, 0.0f, 0.0f,
+			0.0f, 0.0f, scale.z, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f
+			);
+		return posMatrix * rotMatrix * scaleMatrix;
+	}
+
+	struct TRSInputs
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<glm::quat> rotations;
+		std::vector<glm::vec3> scales;
+	};
+
+	TRSInputs randomInputs(size_t count)
+	{
+		std::default_random_engine random(1234);
+		std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> unitDistribution(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> scaleDistribution(0.1f, 10.0f);
+
+		TRSInputs inputs;
+		for (size_t i = 0; i < count; i++) {
+			inputs.positions.push_back(glm::vec3(positionDistribution(random), positionDistribution(random), positionDistribution(random)));
+			inputs.rotations.push_back(glm::normalize(glm::quat(unitDistribution(random), unitDistribution(random), unitDistribution(random), unitDistribution(random))));
+			inputs.scales.push_back(glm::vec3(scaleDistribution(random), scaleDistribution(random), scaleDistribution(random)));
+		}
+		return inputs;
+	}
+}
+
+TEST_CASE ( "composeTRS matches translate * rotate * scale", "[math]" )
+{
+	// Enough for several SSE batches plus a remainder handled one at a time
+	const size_t count = 39;
+	TRSInputs inputs = randomInputs(count);
+	std::vector<glm::mat4> composed(count);
+	composeTRS(inputs.positions.data(), inputs.rotations.data(), inputs.scales.data(), composed.data(), count);
+
+	for (size_t i = 0; i < count; i++) {
+		glm::mat4 expected = referenceTRS(inputs.positions[i], inputs.rotations[i], inputs.scales[i]);
+		for (int column = 0; column < 4; column++) {
+			for (int row = 0; row < 4; row++) {
+				REQUIRE ( composed[i][column][row] == Approx(expected[column][row]).epsilon(1e-6) );
+			}
+		}
+	}
+
+	SECTION ( "A single transform" )
+	{
+		glm::mat4 single;
+		composeTRS(&inputs.positions[5], &inputs.rotations[5], &inputs.scales[5], &single, 1);
+		for (int column = 0; column < 4; column++) {
+			for (int row = 0; row < 4; row++) {
+				REQUIRE ( single[column][row] == composed[5][column][row] );
+			}
+		}
+	}
+
+	SECTION ( "Identity" )
+	{
+		glm::vec3 position(0.0f, 0.0f, 0.0f);
+		glm::quat rotation;
+		glm::vec3 scale(1.0f, 1.0f, 1.0f);
+		glm::mat4 identity;
+		composeTRS(&position, &rotation, &scale, &identity, 1);
+		for (int column = 0; column < 4; column++) {
+			for (int row = 0; row < 4; row++) {
+				REQUIRE ( identity[column][row] == (column == row ? 1.0f : 0.0f) );
+			}
+		}
+	}
+}
+
+TEST_CASE ( "Transform composition: composeTRS vs T * R * S", "[.][benchmark]" )
+{
+	const size_t count = 10000;
+	const unsigned runs = 200;
+	TRSInputs inputs = randomInputs(count);
+	std::vector<glm::mat4> out(count);
+
+	double multiplyTime = benchmark(runs, [&]() {
+		for (size_t i = 0; i < count; i++) {
+			out[i] = referenceTRS(inputs.positions[i], inputs.rotations[i], inputs.scales[i]);
+		}
+		benchmarkSink += (unsigned long long)out[count / 2][3][0];
+	});
+	reportBenchmark("T * R * S matrix products", count, multiplyTime);
+
+	double composeTime = benchmark(runs, [&]() {
+		composeTRS(inputs.positions.data(), inputs.rotations.data(), inputs.scales.data(), out.data(), count);
+		benchmarkSink += (unsigned long long)out[count / 2][3][0];
+	});
+	reportBenchmark("composeTRS batch", count, composeTime);
+}
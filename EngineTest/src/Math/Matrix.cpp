@@ -0,0 +1,266 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+#include "Math/Matrix.h"
+#include "Math/ComposeTRS.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/*! The scalar wrapper the engine used before Math/Matrix.h, kept to benchmark against. */
+	struct LegacyMat4
+	{
+		float m11, m21, m31, m41;
+		float m12, m22, m32, m42;
+		float m13, m23, m33, m43;
+		float m14, m24, m34, m44;
+
+		LegacyMat4(const glm::mat4& matrix)
+		{
+			memcpy(this, &matrix[0][0], sizeof(float)*16);
+		}
+
+		glm::mat4 toGlm()
+		{
+			glm::mat4 matrix = glm::mat4();
+			memcpy(&matrix[0][0], this, sizeof(float)*16);
+			return matrix;
+		}
+
+		LegacyMat4 operator*(const LegacyMat4 other)
+		{
+			LegacyMat4 retval(glm::mat4{});
+			retval.m11 = m11 * other.m11 + m12 * other.m21 + m13 * other.m31 + m14 * other.m41;
+			retval.m12 = m11 * other.m12 + m12 * other.m22 + m13 * other.m32 + m14 * other.m42;
+			retval.m13 = m11 * other.m13 + m12 * other.m23 + m13 * other.m33 + m14 * other.m43;
+			retval.m14 = m11 * other.m14 + m12 * other.m24 + m13 * other.m34 + m14 * other.m44;
+
+			retval.m21 = m21 * other.m11 + m22 * other.m21 + m23 * other.m31 + m24 * other.m41;
+			retval.m22 = m21 * other.m12 + m22 * other.m22 + m23 * other.m32 + m24 * other.m42;
+			retval.m23 = m21 * other.m13 + m22 * other.m23 + m23 * other.m33 + m24 * other.m43;
+			retval.m24 = m21 * other.m14 + m22 * other.m24 + m23 * other.m34 + m24 * other.m44;
+
+			retval.m31 = m31 * other.m11 + m32 * other.m21 + m33 * other.m31 + m34 * other.m41;
+			retval.m32 = m31 * other.m12 + m32 * other.m22 + m33 * other.m32 + m34 * other.m42;
+			retval.m33 = m31 * other.m13 + m32 * other.m23 + m33 * other.m33 + m34 * other.m43;
+			retval.m34 = m31 * other.m14 + m32 * other.m24 + m33 * other.m34 + m34 * other.m44;
+
+			retval.m41 = m41 * other.m11 + m42 * other.m21 + m43 * other.m31 + m44 * other.m41;
+			retval.m42 = m41 * other.m12 + m42 * other.m22 + m43 * other.m32 + m44 * other.m42;
+			retval.m43 = m41 * other.m13 + m42 * other.m23 + m43 * other.m33 + m44 * other.m43;
+			retval.m44 = m41 * other.m14 + m42 * other.m24 + m43 * other.m34 + m44 * other.m44;
+			return retval;
+		}
+	};
+
+	glm::mat4 randomMatrix(std::default_random_engine& random)
+	{
+		std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+		glm::mat4 matrix;
+		for (int column = 0; column < 4; column++) {
+			for (int row = 0; row < 4; row++) {
+				matrix[column][row] = distribution(random);
+			}
+		}
+		return matrix;
+	}
+
+	/*! A translation, rotation and non-uniform scale, as animation produces. */
+	glm::mat4 randomAffineMatrix(std::default_random_engine& random)
+	{
+		std::uniform_real_distribution<float> unitDistribution(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> scaleDistribution(0.5f, 2.0f);
+		glm::vec3 position(unitDistribution(random) * 10.0f, unitDistribution(random) * 10.0f, unitDistribution(random) * 10.0f);
+		glm::quat rotation = glm::normalize(glm::quat(unitDistribution(random), unitDistribution(random), unitDistribution(random), unitDistribution(random)));
+		glm::vec3 scale(scaleDistribution(random), scaleDistribution(random), scaleDistribution(random));
+
+		glm::mat4 matrix;
+		composeTRS(&position, &rotation, &scale, &matrix, 1);
+		return matrix;
+	}
+
+	void requireClose(const glm::mat4& actual, const glm::mat4& expected, double epsilon = 1e-5)
+	{
+		for (int column = 0; column < 4; column++) {
+			for (int row = 0; row < 4; row++) {
+				REQUIRE ( actual[column][row] == Approx(expected[column][row]).epsilon(epsilon) );
+			}
+		}
+	}
+}
+
+TEST_CASE ( "Matrix kernels match glm", "[math]" )
+{
+	std::default_random_engine random(1234);
+
+	SECTION ( "Multiply" )
+	{
+		for (int i = 0; i < 20; i++) {
+			glm::mat4 a = randomMatrix(random);
+			glm::mat4 b = randomMatrix(random);
+			requireClose(mat4Multiply(a, b), a * b);
+
+			glm::mat4 out;
+			mat4Multiply(a, b, out);
+			requireClose(out, a * b);
+		}
+	}
+
+	SECTION ( "Multiply into one of its inputs" )
+	{
+		glm::mat4 a = randomMatrix(random);
+		glm::mat4 b = randomMatrix(random);
+		glm::mat4 expected = a * b;
+
+		glm::mat4 left = a;
+		mat4Multiply(left, b, left);
+		requireClose(left, expected);
+
+		glm::mat4 right = b;
+		mat4Multiply(a, right, right);
+		requireClose(right, expected);
+	}
+
+	SECTION ( "Multiply-accumulate" )
+	{
+		glm::mat4 accumulator = randomMatrix(random);
+		glm::mat4 expected = accumulator;
+		for (int i = 0; i < 4; i++) {
+			glm::mat4 a = randomMatrix(random);
+			glm::mat4 b = randomMatrix(random);
+			mat4MultiplyAdd(a, b, accumulator);
+			glm::mat4 product = a * b;
+			for (int column = 0; column < 4; column++) {
+				expected[column] += product[column];
+			}
+		}
+		requireClose(accumulator, expected);
+	}
+
+	SECTION ( "Batches" )
+	{
+		glm::mat4 a = randomMatrix(random);
+		std::vector<glm::mat4> b;
+		for (int i = 0; i < 7; i++) {
+			b.push_back(randomMatrix(random));
+		}
+		std::vector<glm::mat4> out(b.size());
+		mat4MultiplyBatch(a, b.data(), out.data(), b.size());
+		for (size_t i = 0; i < b.size(); i++) {
+			requireClose(out[i], a * b[i]);
+		}
+
+		mat4MultiplyBatch(a, b.data(), b.data(), b.size());
+		for (size_t i = 0; i < b.size(); i++) {
+			requireClose(b[i], out[i]);
+		}
+	}
+
+	SECTION ( "Affine inverse" )
+	{
+		for (int i = 0; i < 20; i++) {
+			glm::mat4 matrix = randomAffineMatrix(random);
+			// A little shear too, which a plain transpose-and-rescale wouldn't handle
+			matrix[1][0] += 0.25f;
+
+			glm::mat4 inverse = mat4AffineInverse(matrix);
+			requireClose(inverse, glm::inverse(matrix), 1e-4);
+
+			glm::mat4 identity = mat4Multiply(matrix, inverse);
+			for (int column = 0; column < 4; column++) {
+				for (int row = 0; row < 4; row++) {
+					REQUIRE ( identity[column][row] == Approx(column == row ? 1.0f : 0.0f).epsilon(1e-5) );
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE ( "Matrix kernels: vectorized vs legacy mat4 vs glm", "[.][benchmark]" )
+{
+	std::default_random_engine random(1234);
+
+	// Chains, as when walking down a hierarchy of transforms
+	const unsigned chainLength = 10000;
+	const unsigned runs = 100;
+	std::vector<glm::mat4> chain;
+	for (unsigned i = 0; i < chainLength; i++) {
+		chain.push_back(randomAffineMatrix(random));
+	}
+
+	double legacyChainTime = benchmark(runs, [&]() {
+		LegacyMat4 product(chain[0]);
+		for (unsigned i = 1; i < chainLength; i++) {
+			product = product * LegacyMat4(chain[i]);
+		}
+		benchmarkSink += (unsigned long long)product.toGlm()[3][3];
+	});
+	reportBenchmark("Chain multiply, legacy mat4", chainLength, legacyChainTime);
+
+	double glmChainTime = benchmark(runs, [&]() {
+		glm::mat4 product = chain[0];
+		for (unsigned i = 1; i < chainLength; i++) {
+			product = product * chain[i];
+		}
+		benchmarkSink += (unsigned long long)product[3][3];
+	});
+	reportBenchmark("Chain multiply, glm", chainLength, glmChainTime);
+
+	double kernelChainTime = benchmark(runs, [&]() {
+		glm::mat4 product = chain[0];
+		for (unsigned i = 1; i < chainLength; i++) {
+			mat4Multiply(product, chain[i], product);
+		}
+		benchmarkSink += (unsigned long long)product[3][3];
+	});
+	reportBenchmark("Chain multiply, mat4Multiply", chainLength, kernelChainTime);
+
+	// Bone palettes, as Mesh::getBoneTransforms builds for each animated model each frame
+	const unsigned models = 200;
+	const unsigned bones = 64;
+	std::vector<glm::mat4> nodeTransforms;
+	std::vector<glm::mat4> boneOffsets;
+	for (unsigned i = 0; i < bones; i++) {
+		nodeTransforms.push_back(randomAffineMatrix(random));
+		boneOffsets.push_back(randomAffineMatrix(random));
+	}
+	std::vector<glm::mat4> palette(bones);
+
+	double legacyPaletteTime = benchmark(runs, [&]() {
+		for (unsigned model = 0; model < models; model++) {
+			LegacyMat4 globalInverse = glm::inverse(nodeTransforms[0]);
+			for (unsigned i = 0; i < bones; i++) {
+				LegacyMat4 boneTransform = globalInverse * LegacyMat4(nodeTransforms[i]) * LegacyMat4(boneOffsets[i]);
+				palette[i] = boneTransform.toGlm();
+			}
+		}
+		benchmarkSink += (unsigned long long)palette[bones - 1][3][3];
+	});
+	reportBenchmark("Bone palette, legacy mat4", models * bones, legacyPaletteTime);
+
+	double glmPaletteTime = benchmark(runs, [&]() {
+		for (unsigned model = 0; model < models; model++) {
+			glm::mat4 globalInverse = glm::inverse(nodeTransforms[0]);
+			for (unsigned i = 0; i < bones; i++) {
+				palette[i] = globalInverse * nodeTransforms[i] * boneOffsets[i];
+			}
+		}
+		benchmarkSink += (unsigned long long)palette[bones - 1][3][3];
+	});
+	reportBenchmark("Bone palette, glm", models * bones, glmPaletteTime);
+
+	double kernelPaletteTime = benchmark(runs, [&]() {
+		for (unsigned model = 0; model < models; model++) {
+			glm::mat4 globalInverse = mat4AffineInverse(nodeTransforms[0]);
+			for (unsigned i = 0; i < bones; i++) {
+				mat4Multiply(mat4Multiply(globalInverse, nodeTransforms[i]), boneOffsets[i], palette[i]);
+			}
+		}
+		benchmarkSink += (unsigned long long)palette[bones - 1][3][3];
+	});
+	reportBenchmark("Bone palette, matrix kernels", models * bones, kernelPaletteTime);
+}
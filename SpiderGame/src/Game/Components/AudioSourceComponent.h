@@ -14,11 +14,10 @@ class AudioSourceConstructor : public ComponentConstructor
 {
 public:
 	AudioSourceConstructor(SoundManager& soundManager) : soundManager(soundManager) { }
-	virtual ComponentConstructorInfo construct(World& world, eid_t parent, void* userinfo) const
+	virtual void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const
 	{
-		AudioSourceComponent* component = new AudioSourceComponent();
+		AudioSourceComponent* component = world.emplaceComponent<AudioSourceComponent>(entity);
 		component->sourceHandle = soundManager.getSourceHandle();
-		return ComponentConstructorInfo(component, typeid(AudioSourceComponent).hash_code());
 	}
 private:
 	SoundManager& soundManager;
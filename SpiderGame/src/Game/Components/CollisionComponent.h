@@ -28,8 +28,23 @@ struct CollisionConstructorInfo
 struct CollisionComponent : public Component
 {
 	CollisionComponent() : world(nullptr), collisionObject(nullptr), controlsMovement(true) { }
+
+	// Components are moved around inside their pool, so ownership of the collision object moves with them
+	CollisionComponent(CollisionComponent&& other)
+		: world(other.world), collisionObject(other.collisionObject), controlsMovement(other.controlsMovement)
+	{
+		other.world = nullptr;
+		other.collisionObject = nullptr;
+	}
+	CollisionComponent(const CollisionComponent&) = delete;
+	CollisionComponent& operator=(const CollisionComponent&) = delete;
+
 	~CollisionComponent()
 	{
+		if (collisionObject == nullptr) {
+			return;
+		}
+
 		if (world != nullptr) {
 			world->removeCollisionObject(this->collisionObject);
 		}
@@ -55,7 +70,7 @@ public:
 		: world(world), info(info) { }
 
 
-	virtual ComponentConstructorInfo construct(World& world, eid_t parent, void* userinfo) const
+	virtual void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const
 	{
 		PrefabConstructionInfo* constructionInfo = (PrefabConstructionInfo*)userinfo;
 
@@ -79,7 +94,7 @@ public:
 		info.m_startWorldTransform = Util::gameToBt(initialTransform);
 		info.m_motionState = NULL;
 
-		CollisionComponent* component = new CollisionComponent();
+		CollisionComponent* component = world.emplaceComponent<CollisionComponent>(entity);
 		btRigidBody* body = new btRigidBody(info);
 		body->setCollisionFlags(this->info.collisionFlags);
 
@@ -88,7 +103,6 @@ public:
 		component->controlsMovement = this->info.controlsMovement;
 
 		this->world->addRigidBody(body, this->info.group, this->info.mask);
-		return ComponentConstructorInfo(component, typeid(CollisionComponent).hash_code());
 	}
 
 	virtual void finish(World& world, eid_t entity) {
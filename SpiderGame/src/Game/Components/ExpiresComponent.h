@@ -16,6 +16,9 @@ public:
 
 	Data data;
 	float timer;
+
+	void serialize(SnapshotWriter& writer) const { writer.write(data); writer.write(timer); }
+	void deserialize(SnapshotReader& reader) { reader.read(data); reader.read(timer); }
 };
 
 class ExpiresConstructor : public DefaultComponentConstructor<ExpiresComponent> {
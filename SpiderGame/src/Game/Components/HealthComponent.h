@@ -13,6 +13,9 @@ public:
 		unsigned maxHealth;
 	};
 	Data data;
+
+	void serialize(SnapshotWriter& writer) const { writer.write(data); }
+	void deserialize(SnapshotReader& reader) { reader.read(data); }
 };
 
 class HealthConstructor : public DefaultComponentConstructor<HealthComponent> {
@@ -17,17 +17,15 @@ public:
 	ModelRenderConstructor(Renderer& renderer, const Renderer::ModelHandle& modelHandle, const Shader& shader, const std::string& defaultAnimation = "")
 		: renderer(renderer), modelHandle(modelHandle), shader(shader), defaultAnimation(defaultAnimation) { }
 
-	virtual ComponentConstructorInfo construct(World& world, eid_t parent, void* userinfo) const
+	virtual void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const
 	{
-		ModelRenderComponent* component = new ModelRenderComponent();
+		ModelRenderComponent* component = world.emplaceComponent<ModelRenderComponent>(entity);
 		component->rendererHandle = renderer.getRenderableHandle(modelHandle, shader);
 
 		if (userinfo != nullptr) {
 			PrefabConstructionInfo* info = (PrefabConstructionInfo*)userinfo;
 			renderer.setRenderableTransform(component->rendererHandle, info->initialTransform.matrix());
 		}
-
-		return ComponentConstructorInfo(component, typeid(ModelRenderComponent).hash_code());
 	}
 
 	virtual void finish(World& world, eid_t entity)
@@ -17,11 +17,9 @@ public:
 	PointLightConstructor(Renderer& renderer, const PointLight& pointLight)
 		: renderer(renderer), pointLightParams(pointLight) { }
 
-	virtual ComponentConstructorInfo construct(World& world, eid_t parent, void* userinfo) const
+	virtual void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const
 	{
-		PointLightComponent* component = new PointLightComponent();
-		component->handle = renderer.getPointLightHandle(pointLightParams);
-		return ComponentConstructorInfo(component, typeid(PointLightComponent).hash_code());
+		world.emplaceComponent<PointLightComponent>(entity, renderer.getPointLightHandle(pointLightParams));
 	}
 private:
 	Renderer& renderer;
@@ -8,9 +8,32 @@
 
 struct TransformComponent : public Component
 {
-	TransformComponent(const Transform& transform) : data(new Transform(transform)) { }
-	TransformComponent() : data(new Transform()) { }
+	TransformComponent(const Transform& transform) : data(new Transform(transform)), parent(World::NullEntity) { resetWorldTransform(); }
+	TransformComponent() : data(new Transform()), parent(World::NullEntity) { resetWorldTransform(); }
 	std::shared_ptr<Transform> data;
+
+	/*! The entity whose transform data is parented to. TransformSystem re-sorts its
+		hierarchy when this changes, as long as the component is marked as changed. */
+	eid_t parent;
+
+	/*! The transform in world space, as of TransformSystem's last update. Reading these
+		is much cheaper than Transform's getWorld functions, which walk the parent chain.
+		Until TransformSystem first sees the component, they hold the transform it was
+		constructed with. */
+	glm::mat4 worldMatrix;
+	glm::vec3 worldPosition;
+	glm::quat worldRotation;
+	glm::vec3 worldScale;
+
+	/*! Sets the world fields from data, walking its parents. For transforms which are
+		read before TransformSystem's next update, such as those of new entities. */
+	void resetWorldTransform()
+	{
+		worldMatrix = data->matrix();
+		worldPosition = data->getWorldPosition();
+		worldRotation = data->getWorldRotation();
+		worldScale = data->getWorldScale();
+	}
 };
 
 class TransformConstructor : public ComponentConstructor {
@@ -18,12 +41,12 @@ public:
 	TransformConstructor() { }
 	TransformConstructor(const Transform& transform) : transform(transform) { }
 
-	virtual ComponentConstructorInfo construct(World& world, eid_t parent, void* userinfo) const
+	virtual void construct(World& world, eid_t entity, eid_t parent, void* userinfo) const
 	{
 		PrefabConstructionInfo* constructionInfo = (PrefabConstructionInfo*)userinfo;
 
-		TransformComponent* component = new TransformComponent(transform);
 		TransformComponent* parentComponent = world.getComponent<TransformComponent>(parent);
+		TransformComponent* component = world.emplaceComponent<TransformComponent>(entity, transform);
 
 		if (constructionInfo != nullptr) {
 			*component->data = constructionInfo->initialTransform;
@@ -31,9 +54,9 @@ public:
 
 		if (parent != World::NullEntity) {
 			component->data->setParent(parentComponent->data);
+			component->parent = parent;
 		}
-
-		return ComponentConstructorInfo(component, typeid(TransformComponent).hash_code());
+		component->resetWorldTransform();
 	}
 private:
 	Transform transform;
@@ -19,6 +19,9 @@ struct VelocityComponent : public Component
 	};
 
 	Data data;
+
+	void serialize(SnapshotWriter& writer) const { writer.write(data); }
+	void deserialize(SnapshotReader& reader) { reader.read(data); }
 };
 
 class VelocityConstructor : public DefaultComponentConstructor<VelocityComponent> {
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Framework/World.h"
+#include "Environment/Room.h"
+
+/*! World resource holding the player's entity. Set by Scene::setup. Check that the
+	entity is still alive before using it, since the player can be deleted. */
+struct PlayerResource
+{
+	PlayerResource(eid_t player) : player(player) { }
+	eid_t player;
+};
+
+/*! World resource holding the layout of the current level, for pathfinding. Set by Scene::setup. */
+struct LevelResource
+{
+	LevelResource(const Room& room) : room(room) { }
+	Room room;
+};
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include "Game/Components/CameraComponent.h"
 #include "Game/Events/GameEvents.h"
 #include "Game/Extra/Config.h"
+#include "Game/Extra/SceneResources.h"
 
 #include "Renderer/UI/Label.h"
 #include "Renderer/UI/UIQuad.h"
@@ -62,12 +63,12 @@ void Game::setWireframe(bool on)
 
 void Game::setNoclip(bool on)
 {
-	eid_t player = world.getEntityWithName("Player");
-	if (player == World::NullEntity) {
+	PlayerResource* playerResource = world.resource<PlayerResource>();
+	if (playerResource == nullptr) {
 		return;
 	}
 
-	CollisionComponent* collisionComponent = world.getComponent<CollisionComponent>(player);
+	CollisionComponent* collisionComponent = world.getComponent<CollisionComponent>(playerResource->player);
 	if (collisionComponent == nullptr) {
 		return;
 	}
@@ -90,6 +91,27 @@ void Game::setBulletDebugDraw(bool on)
 	}
 }
 
+void Game::setDeterministicSystems(bool on)
+{
+	displayScheduler->setDeterministic(on);
+	collisionUpdateSystem->setParallel(on ? nullptr : workerPool.get(), 256);
+	kinematicBodySystem->setParallel(on ? nullptr : workerPool.get(), 256);
+}
+
+void Game::setStats(bool on)
+{
+	statsLabel->isVisible = on;
+}
+
+void Game::updateStats()
+{
+	std::stringstream sstream;
+	sstream << "Unchanged: " << modelRenderSystem->getSkippedEntities() << " models, "
+		<< pointLightSystem->getSkippedEntities() << " lights, "
+		<< collisionUpdateSystem->getSkippedEntities() + kinematicBodySystem->getSkippedEntities() << " bodies";
+	statsLabel->setText(sstream.str());
+}
+
 void Game::refreshBulletDebugDraw()
 {
 	debugDrawer.reset();
@@ -101,11 +123,11 @@ void Game::restartGame()
 	world.clear();
 
 	scene->setup();
-	std::vector<eid_t> cameraEntities = world.getEntitiesWithComponent<CameraComponent>();
-	if (cameraEntities.size() < 0) {
+	eid_t camera = world.first<CameraComponent>();
+	if (camera == World::NullEntity) {
 		printf("WARNING: No camera in scene");
 	} else {
-		CameraComponent* cameraComponent = world.getComponent<CameraComponent>(cameraEntities[0]);
+		CameraComponent* cameraComponent = world.getComponent<CameraComponent>(camera);
 		debugDrawer.setCamera(&cameraComponent->data);
 	}
 }
@@ -212,9 +234,18 @@ int Game::setup()
 	console->addCallback("noclip", CallbackMap::defineCallback<bool>(std::bind(&Game::setNoclip, this, std::placeholders::_1)));
 	console->addCallback("enableBulletDebugDraw", CallbackMap::defineCallback<bool>(std::bind(&Game::setBulletDebugDraw, this, std::placeholders::_1)));
 	console->addCallback("refreshBulletDebugDraw", CallbackMap::defineCallback(std::bind(&Game::refreshBulletDebugDraw, this)));
+	console->addCallback("deterministicSystems", CallbackMap::defineCallback<bool>(std::bind(&Game::setDeterministicSystems, this, std::placeholders::_1)));
 	console->addCallback("restart", CallbackMap::defineCallback(std::bind(&Game::restartGame, this)));
+	console->addCallback("stats", CallbackMap::defineCallback<bool>(std::bind(&Game::setStats, this, std::placeholders::_1)));
 	console->addToRenderer(uiRenderer, backShader, textShader);
 
+	/* Stats */
+	statsLabel = std::make_shared<Label>(font);
+	statsLabel->material.setProperty("textColor", MaterialProperty(glm::vec4(1.0f, 1.0f, 0.0f, 1.0f)));
+	statsLabel->transform = Transform(glm::vec3(10.0f, 28.0f, 0.0f)).matrix();
+	statsLabel->isVisible = false;
+	statsLabelHandle = uiRenderer.getEntityHandle(statsLabel, textShader);
+
 	/* Renderer */
 	renderer.setDebugLogCallback(std::bind(&Console::print, this->console.get(), std::placeholders::_1));
 	uiRenderer.setProjection(glm::ortho(0.0f, (float)windowWidth, (float)windowHeight, 0.0f, 1000.0f, -1000.0f));
@@ -255,6 +286,28 @@ int Game::setup()
 	gemSystem = std::make_unique<GemSystem>(world, renderer, *eventManager);
 	gameEndingSystem = std::make_unique<GameEndingSystem>(world, *eventManager, soundManager);
 	shakeSystem = std::make_unique<ShakeSystem>(world, generator);
+	transformSystem = std::make_unique<TransformSystem>(world);
+	kinematicBodySystem = std::make_unique<KinematicBodySystem>(world);
+
+	// Display systems only touch the components and resources they declare, so they can share threads
+	workerPool = std::make_unique<WorkerPool>();
+	displayScheduler = std::make_unique<SystemScheduler>(*workerPool);
+	displayScheduler->add(*playerFacingSystem);
+	displayScheduler->add(*collisionUpdateSystem);
+	// After anything which moves transforms, before anything which reads world transforms
+	displayScheduler->add(*transformSystem);
+	// Kinematic bodies need this frame's world transforms
+	displayScheduler->add(*kinematicBodySystem);
+	displayScheduler->add(*shakeSystem);
+	displayScheduler->add(*cameraSystem);
+	displayScheduler->add(*modelRenderSystem);
+	displayScheduler->add(*pointLightSystem);
+	displayScheduler->add(*audioSourceSystem);
+	displayScheduler->add(*audioListenerSystem);
+
+	// FollowSystem stays serial: its sweep tests share scratch space inside Bullet's broadphase,
+	// which isn't safe from several threads without BT_THREADSAFE
+	setDeterministicSystems(false);
 
 	SceneInfo sceneInfo;
 	sceneInfo.dynamicsWorld = dynamicsWorld;
@@ -276,12 +329,11 @@ int Game::setup()
 	launchScreen->transform = Transform(glm::vec3(0.0f, 0.0f, 1.0f)).matrix();
 	launchScreenHandle = uiRenderer.getEntityHandle(launchScreen, shaderLoader.compileAndLink("shaders/basic2d.vert", "shaders/texture2d.frag"));
 
-	std::function<void(const RestartEvent& event)> restartCallback =
-		[game = this, world = &world](const RestartEvent& event) {
+	restartSubscription = eventManager->registerForEvent<RestartEvent>(
+		[game = this](const RestartEvent& event) {
 			// Defer the restart so we avoid invalidating any entity iterators
 			game->restart = true;
-		};
-	eventManager->registerForEvent<RestartEvent>(restartCallback);
+		});
 
 	return 0;
 }
@@ -356,16 +408,13 @@ void Game::update()
 		gemSystem->update(timeDelta);
 
 		dynamicsWorld->stepSimulation(timeDelta);
+		eventManager->dispatchEvents();
 
 		/* Display */
-		playerFacingSystem->update(timeDelta);
-		collisionUpdateSystem->update(timeDelta);
-		shakeSystem->update(timeDelta);
-		cameraSystem->update(timeDelta);
-		modelRenderSystem->update(timeDelta);
-		pointLightSystem->update(timeDelta);
-		audioSourceSystem->update(timeDelta);
-		audioListenerSystem->update(timeDelta);
+		displayScheduler->update(timeDelta);
+		if (statsLabel->isVisible) {
+			updateStats();
+		}
 
 		renderer.update(timeDelta);
 		soundManager.update();
@@ -375,6 +424,7 @@ void Game::update()
 		playerDeathSystem->update(timeDelta);
 		gameEndingSystem->update(timeDelta);
 
+		eventManager->dispatchEvents();
 		world.cleanupEntities();
 	}
 
@@ -16,6 +16,7 @@
 
 #include "Renderer/UI/UIRenderer.h"
 #include "Renderer/UI/UIQuad.h"
+#include "Renderer/UI/Label.h"
 
 #include "Sound/SoundManager.h"
 
@@ -25,6 +26,9 @@
 #include "Environment/MeshBuilder.h"
 
 #include "Framework/World.h"
+#include "Framework/WorkerPool.h"
+#include "Framework/SystemScheduler.h"
+#include "Framework/EventManager.h"
 #include "Game/Systems/ShootingSystem.h"
 #include "Game/Systems/ModelRenderSystem.h"
 #include "Game/Systems/CollisionUpdateSystem.h"
@@ -44,6 +48,8 @@
 #include "Game/Systems/GemSystem.h"
 #include "Game/Systems/GameEndingSystem.h"
 #include "Game/Systems/ShakeSystem.h"
+#include "Game/Systems/TransformSystem.h"
+#include "Game/Systems/KinematicBodySystem.h"
 
 #include "Framework/Physics.h"
 #include "Framework/EventManager.h"
@@ -77,6 +83,10 @@ private:
 	SDL_Window* window;
 	SDL_GLContext context;
 
+	/*! Declared before the systems, which hold subscriptions to it and so must be destroyed first. */
+	std::unique_ptr<EventManager> eventManager;
+	EventSubscription restartSubscription;
+
 	std::unique_ptr<ShootingSystem> shootingSystem;
 	std::unique_ptr<ModelRenderSystem> modelRenderSystem;
 	std::unique_ptr<CollisionUpdateSystem> collisionUpdateSystem;
@@ -96,8 +106,11 @@ private:
 	std::unique_ptr<GemSystem> gemSystem;
 	std::unique_ptr<GameEndingSystem> gameEndingSystem;
 	std::unique_ptr<ShakeSystem> shakeSystem;
+	std::unique_ptr<TransformSystem> transformSystem;
+	std::unique_ptr<KinematicBodySystem> kinematicBodySystem;
 
-	std::unique_ptr<EventManager> eventManager;
+	std::unique_ptr<WorkerPool> workerPool;
+	std::unique_ptr<SystemScheduler> displayScheduler;
 
 	BulletDebugDrawer debugDrawer;
 	std::unique_ptr<Console> console;
@@ -116,10 +129,17 @@ private:
 	std::shared_ptr<UIQuad> launchScreen;
 	UIRenderer::UIElementHandle launchScreenHandle;
 
+	/*! How many entities the display systems found unchanged and skipped, toggled with the "stats" command. */
+	std::shared_ptr<Label> statsLabel;
+	UIRenderer::UIElementHandle statsLabelHandle;
+
 	void exit();
 	void setWireframe(bool on);
 	void setNoclip(bool on);
 	void setBulletDebugDraw(bool on);
+	void setDeterministicSystems(bool on);
+	void setStats(bool on);
+	void updateStats();
 	void refreshBulletDebugDraw();
 	void restartGame();
 };
@@ -13,7 +13,7 @@ DamageEventResponder::DamageEventResponder(World& world, EventManager& eventMana
 {
 	requiredComponents.setBit(world.getComponentId<HealthComponent>(), true);
 
-	eventManager.registerForEvent<DamageEvent>(std::bind(&DamageEventResponder::damageReceived, this, std::placeholders::_1));
+	damageSubscription = eventManager.registerForEvent<DamageEvent>([this](const DamageEvent& event) { damageReceived(event); });
 }
 
 void DamageEventResponder::damageReceived(const DamageEvent& event)
@@ -1,8 +1,8 @@
 
 #include "Framework/ComponentBitmask.h"
+#include "Framework/EventManager.h"
 
 class World;
-class EventManager;
 class DamageEvent;
 
 class DamageEventResponder
@@ -14,4 +14,5 @@ private:
 	World& world;
 	EventManager& eventManager;
 	ComponentBitmask requiredComponents;
+	EventSubscription damageSubscription;
 };
\ No newline at end of file
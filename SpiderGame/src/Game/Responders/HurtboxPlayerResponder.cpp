@@ -17,7 +17,14 @@ HurtboxPlayerResponder::HurtboxPlayerResponder(World& world, EventManager& event
 {
 	requiredComponents1.setBit(world.getComponentId<PlayerComponent>(), true);
 	requiredComponents2.setBit(world.getComponentId<HurtboxComponent>(), true);
-	this->eventManager.registerForEvent<CollisionEvent>(std::bind(&HurtboxPlayerResponder::handleCollisionEvent, this, std::placeholders::_1));
+	collisionSubscription = this->eventManager.registerForEvents<CollisionEvent>([this](Span<const CollisionEvent> events) { handleCollisionEvents(events); });
+}
+
+void HurtboxPlayerResponder::handleCollisionEvents(Span<const CollisionEvent> events)
+{
+	for (const CollisionEvent& event : events) {
+		handleCollisionEvent(event);
+	}
 }
 
 void HurtboxPlayerResponder::handleCollisionEvent(const CollisionEvent& collisionEvent)
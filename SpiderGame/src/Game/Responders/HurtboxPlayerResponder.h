@@ -1,19 +1,22 @@
 #pragma once
 
 #include "Framework/ComponentBitmask.h"
+#include "Framework/Span.h"
+#include "Framework/EventManager.h"
 
 class World;
-class EventManager;
 class CollisionEvent;
 
 class HurtboxPlayerResponder
 {
 public:
 	HurtboxPlayerResponder(World& world, EventManager& eventManager);
+	void handleCollisionEvents(Span<const CollisionEvent> events);
 	void handleCollisionEvent(const CollisionEvent& event);
 private:
 	World& world;
 	EventManager& eventManager;
 	ComponentBitmask requiredComponents1;
 	ComponentBitmask requiredComponents2;
+	EventSubscription collisionSubscription;
 };
\ No newline at end of file
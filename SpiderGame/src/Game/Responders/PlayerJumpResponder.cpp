@@ -14,7 +14,14 @@ PlayerJumpResponder::PlayerJumpResponder(World& world, EventManager& eventManage
 {
 	requiredComponents.setBit(world.getComponentId<PlayerComponent>(), true);
 	requiredComponents.setBit(world.getComponentId<RigidbodyMotorComponent>(), true);
-	this->eventManager.registerForEvent<CollisionEvent>(std::bind(&PlayerJumpResponder::handleCollisionEvent, this, std::placeholders::_1));
+	collisionSubscription = this->eventManager.registerForEvents<CollisionEvent>([this](Span<const CollisionEvent> events) { handleCollisionEvents(events); });
+}
+
+void PlayerJumpResponder::handleCollisionEvents(Span<const CollisionEvent> collisionEvents)
+{
+	for (const CollisionEvent& collisionEvent : collisionEvents) {
+		handleCollisionEvent(collisionEvent);
+	}
 }
 
 void PlayerJumpResponder::handleCollisionEvent(const CollisionEvent& collisionEvent)
@@ -25,17 +32,9 @@ void PlayerJumpResponder::handleCollisionEvent(const CollisionEvent& collisionEv
 		return;
 	}
 
-	btCollisionObject* playerBody = nullptr;
-	btCollisionObject* otherBody = nullptr;
-	if (*((eid_t*)collisionEvent.collisionManifold->getBody0()->getUserPointer()) == player) {
-		playerBody = (btCollisionObject*)collisionEvent.collisionManifold->getBody0();
-		otherBody = (btCollisionObject*)collisionEvent.collisionManifold->getBody1();
-	} else {
-		otherBody = (btCollisionObject*)collisionEvent.collisionManifold->getBody0();
-		playerBody = (btCollisionObject*)collisionEvent.collisionManifold->getBody1();
-	}
+	int otherFlags = (collisionEvent.e1 == player ? collisionEvent.flags2 : collisionEvent.flags1);
 
-	if ((otherBody->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE) != 0) {
+	if ((otherFlags & btCollisionObject::CF_NO_CONTACT_RESPONSE) != 0) {
 		// Don't collide with things like hurtboxes
 		return;
 	}
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "Framework/ComponentBitmask.h"
+#include "Framework/Span.h"
+#include "Framework/EventManager.h"
 
 class CollisionEvent;
 class World;
-class EventManager;
 
 class PlayerJumpResponder
 {
@@ -14,6 +15,8 @@ private:
 	World& world;
 	EventManager& eventManager;
 	ComponentBitmask requiredComponents;
+	EventSubscription collisionSubscription;
 
+	void handleCollisionEvents(Span<const CollisionEvent> collisionEvents);
 	void handleCollisionEvent(const CollisionEvent& collisionEvent);
 };
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include "Game/Components/AudioListenerComponent.h"
 #include "Game/Components/AudioSourceComponent.h"
 #include "Game/Components/PointLightComponent.h"
+#include "Game/Extra/SceneResources.h"
 #include "Game/Components/SpawnerComponent.h"
 #include "Game/Components/LevelComponent.h"
 #include "Game/Components/GemComponent.h"
@@ -474,7 +475,7 @@ void Scene::setupPrefabs()
 
 	skybox = renderer.getRenderableHandle(renderer.getModelHandle(skyboxModel), skyboxShader);
 
-	std::function<void(const ShotEvent& event)> shotCallback =
+	auto shotCallback =
 		[world = &world, soundManager = &soundManager](const ShotEvent& event) {
 			PlayerComponent* playerComponent = world->getComponent<PlayerComponent>(event.source);
 			AudioSourceComponent* audioSourceComponent = world->getComponent<AudioSourceComponent>(event.source);
@@ -486,9 +487,9 @@ void Scene::setupPrefabs()
 			}
 			soundManager->playClipAtSource(clip, audioSourceComponent->sourceHandle);
 		};
-	eventManager.registerForEvent<ShotEvent>(shotCallback);
+	eventSubscriptions.push_back(eventManager.registerForEvent<ShotEvent>(shotCallback));
 
-	std::function<void(const HealthChangedEvent& event)> healthChangedCallback =
+	auto healthChangedCallback =
 		[world = &world, soundManager = &soundManager, healthLabel = gui.healthLabel](const HealthChangedEvent& event) {
 			PlayerComponent* playerComponent = world->getComponent<PlayerComponent>(event.entity);
 
@@ -514,9 +515,9 @@ void Scene::setupPrefabs()
 				motorComponent->canMove = false;
 			}
 		};
-	eventManager.registerForEvent<HealthChangedEvent>(healthChangedCallback);
+	eventSubscriptions.push_back(eventManager.registerForEvent<HealthChangedEvent>(healthChangedCallback));
 
-	std::function<void(const GemCountChangedEvent& event)> gemCountChangedCallback =
+	auto gemCountChangedCallback =
 		[world = &world, soundManager = &soundManager, gui = &gui](const GemCountChangedEvent& event) {
 			PlayerComponent* playerComponent = world->getComponent<PlayerComponent>(event.source);
 			AudioSourceComponent* audioSourceComponent = world->getComponent<AudioSourceComponent>(event.source);
@@ -538,9 +539,9 @@ void Scene::setupPrefabs()
 
 			soundManager->playClipAtSource(playerComponent->data.gemPickupClip, audioSourceComponent->sourceHandle);
 		};
-	eventManager.registerForEvent<GemCountChangedEvent>(gemCountChangedCallback);
+	eventSubscriptions.push_back(eventManager.registerForEvent<GemCountChangedEvent>(gemCountChangedCallback));
 
-	std::function<void(const BulletCountChangedEvent& event)> bulletCountChangedCallback =
+	auto bulletCountChangedCallback =
 		[world = &world, soundManager = &soundManager, bulletLabel = gui.bulletLabel](const BulletCountChangedEvent& event) {
 			PlayerComponent* playerComponent = world->getComponent<PlayerComponent>(event.source);
 			AudioSourceComponent* audioSourceComponent = world->getComponent<AudioSourceComponent>(event.source);
@@ -549,18 +550,18 @@ void Scene::setupPrefabs()
 			sstream << event.newBulletsInGun << "/" << event.newBulletCount;
 			bulletLabel->setText(sstream.str());
 		};
-	eventManager.registerForEvent<BulletCountChangedEvent>(bulletCountChangedCallback);
+	eventSubscriptions.push_back(eventManager.registerForEvent<BulletCountChangedEvent>(bulletCountChangedCallback));
 
-	std::function<void(const ReloadStartEvent& event)> reloadStartCallback =
+	auto reloadStartCallback =
 		[world = &world, soundManager = &soundManager](const ReloadStartEvent& event) {
 			PlayerComponent* playerComponent = world->getComponent<PlayerComponent>(event.source);
 			AudioSourceComponent* audioSourceComponent = world->getComponent<AudioSourceComponent>(event.source);
 
 			soundManager->playClipAtSource(playerComponent->data.reloadClip, audioSourceComponent->sourceHandle);
 		};
-	eventManager.registerForEvent<ReloadStartEvent>(reloadStartCallback);
+	eventSubscriptions.push_back(eventManager.registerForEvent<ReloadStartEvent>(reloadStartCallback));
 
-	std::function<void(const VictorySequenceStartedEvent& event)> victorySequenceStartedCallback =
+	auto victorySequenceStartedCallback =
 		[gui = &gui](const VictorySequenceStartedEvent& event) {
 			// Free all UI handles
 			gui->blueGemImageHandle = nullptr;
@@ -571,14 +572,14 @@ void Scene::setupPrefabs()
 			gui->healthImageHandle = nullptr;
 			gui->healthLabelHandle = nullptr;
 		};
-	eventManager.registerForEvent<VictorySequenceStartedEvent>(victorySequenceStartedCallback);
+	eventSubscriptions.push_back(eventManager.registerForEvent<VictorySequenceStartedEvent>(victorySequenceStartedCallback));
 
-	std::function<void(const VictorySequenceEndedEvent& event)> victorySequenceEndedCallback =
+	auto victorySequenceEndedCallback =
 		[gui = &gui](const VictorySequenceEndedEvent& event) {
 			// Throw some text on screen
 			gui->victoryLabel->isVisible = true;
 		};
-	eventManager.registerForEvent<VictorySequenceEndedEvent>(victorySequenceEndedCallback);
+	eventSubscriptions.push_back(eventManager.registerForEvent<VictorySequenceEndedEvent>(victorySequenceEndedCallback));
 
 	prefabsSetup = true;
 }
@@ -622,6 +623,7 @@ void Scene::setup()
 	roomPrefab.addConstructor(new ModelRenderConstructor(renderer, roomModelHandle, shader));
 	roomPrefab.addConstructor(new LevelConstructor(LevelComponent::Data(roomData.room)));
 	eid_t roomEntity = world.constructPrefab(roomPrefab);
+	world.setResource<LevelResource>(roomData.room);
 
 	const RoomBox& centerRoomBox = room.boxes[0];
 	const RoomBox& topmostRoomBox = room.boxes[room.topmostBox];
@@ -736,6 +738,7 @@ void Scene::setup()
 
 	PrefabConstructionInfo playerInfo = PrefabConstructionInfo(Transform(playerSpawn));
 	eid_t player = world.constructPrefab(playerPrefab, World::NullEntity, &playerInfo);
+	world.setResource<PlayerResource>(player);
 	eid_t camera = world.constructPrefab(cameraPrefab, player);
 	eid_t playerLight = world.constructPrefab(playerLightPrefab, player);
 	eid_t gun = world.constructPrefab(playerGunPrefab, camera);
@@ -110,6 +110,9 @@ private:
 	std::shared_ptr<PlayerJumpResponder> playerJumpResponder;
 	std::shared_ptr<HurtboxPlayerResponder> hurtboxPlayerResponder;
 
+	/*! Keeps the GUI and sound callbacks registered for as long as the scene lives. */
+	std::vector<EventSubscription> eventSubscriptions;
+
 	bool prefabsSetup;
 	Prefab pedestalPrefab;
 	Prefab barrelPrefab;
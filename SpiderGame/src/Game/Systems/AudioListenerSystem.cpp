@@ -10,6 +10,10 @@ AudioListenerSystem::AudioListenerSystem(World& world, SoundManager& soundManage
 {
 	require<AudioListenerComponent>();
 	require<TransformComponent>();
+
+	reads<AudioListenerComponent>();
+	reads<TransformComponent>();
+	writesResource(&soundManager);
 }
 
 void AudioListenerSystem::updateEntity(float dt, eid_t entity)
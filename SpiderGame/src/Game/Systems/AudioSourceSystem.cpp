@@ -10,6 +10,10 @@ AudioSourceSystem::AudioSourceSystem(World& world, SoundManager& soundManager)
 {
 	require<AudioSourceComponent>();
 	require<TransformComponent>();
+
+	reads<AudioSourceComponent>();
+	reads<TransformComponent>();
+	writesResource(&soundManager);
 }
 
 void AudioSourceSystem::updateEntity(float dt, eid_t entity)
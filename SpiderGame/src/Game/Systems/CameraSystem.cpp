@@ -10,6 +10,11 @@ CameraSystem::CameraSystem(World& world, Renderer& renderer)
 {
 	require<TransformComponent>();
 	require<CameraComponent>();
+
+	reads<TransformComponent>();
+	writes<CameraComponent>();
+	reads<ShakeComponent>();
+	writesResource(&renderer);
 }
 
 void CameraSystem::updateEntity(float dt, eid_t entity)
@@ -18,7 +23,7 @@ void CameraSystem::updateEntity(float dt, eid_t entity)
 	 TransformComponent* transformComponent = world.getComponent<TransformComponent>(entity);
 	 ShakeComponent* shakeComponent = world.getComponent<ShakeComponent>(entity);
 
-	 glm::mat4 matrix = transformComponent->data->matrix();
+	 glm::mat4 matrix = transformComponent->worldMatrix;
 	 if (shakeComponent != nullptr) {
 		 matrix = glm::translate(matrix, shakeComponent->currentOffset);
 	 }
@@ -1,29 +1,34 @@
 
 #include "CollisionUpdateSystem.h"
 
-#include "Game/Components/CollisionComponent.h"
-#include "Game/Components/TransformComponent.h"
-
 #include "Util.h"
 
 CollisionUpdateSystem::CollisionUpdateSystem(World& world)
-	: System(world)
+	: TypedSystem(world)
 {
-	this->require<CollisionComponent>();
-	this->require<TransformComponent>();
+	writes<CollisionComponent>();
+	writes<TransformComponent>();
 }
 
-void CollisionUpdateSystem::updateEntity(float dt, eid_t entity)
+void CollisionUpdateSystem::updateEntity(float dt, eid_t entity, CollisionComponent& collisionComponent, TransformComponent& transformComponent)
 {
-	CollisionComponent* collisionComponent(world.getComponent<CollisionComponent>(entity));
-	TransformComponent* transformComponent(world.getComponent<TransformComponent>(entity));
+	// Kinematic bodies follow their world transform instead, once TransformSystem has
+	// worked it out; see KinematicBodySystem
+	if (!collisionComponent.controlsMovement) {
+		return;
+	}
 
-	std::shared_ptr<Transform>& transform = transformComponent->data;
-	if (collisionComponent->controlsMovement) {
-		btTransform colTransform = collisionComponent->collisionObject->getWorldTransform();
-		transform->setPosition(Util::btToGlm(colTransform.getOrigin()));
-		transform->setRotation(Util::btToGlm(colTransform.getRotation()));
-	} else {
-		collisionComponent->collisionObject->setWorldTransform(btTransform(Util::glmToBt(transform->getWorldRotation()), Util::glmToBt(transform->getWorldPosition())));
+	// Bodies at rest are left alone, so that the systems drawing them can skip them too
+	std::shared_ptr<Transform>& transform = transformComponent.data;
+	btTransform colTransform = collisionComponent.collisionObject->getWorldTransform();
+	glm::vec3 position = Util::btToGlm(colTransform.getOrigin());
+	glm::quat rotation = Util::btToGlm(colTransform.getRotation());
+	if (position == transform->getPosition() && rotation == transform->getRotation()) {
+		skipEntity();
+		return;
 	}
+
+	transform->setPosition(position);
+	transform->setRotation(rotation);
+	markChanged<TransformComponent>(entity);
 }
\ No newline at end of file
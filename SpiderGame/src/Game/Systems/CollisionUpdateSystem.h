@@ -2,9 +2,13 @@
 
 #include "Framework/System.h"
 
-class CollisionUpdateSystem : public System
+#include "Game/Components/CollisionComponent.h"
+#include "Game/Components/TransformComponent.h"
+
+/*! Moves entities whose body controls their movement to where the physics step left the body. */
+class CollisionUpdateSystem : public TypedSystem<CollisionComponent, TransformComponent>
 {
 public:
 	CollisionUpdateSystem(World& world);
-	void updateEntity(float dt, eid_t entity);
+	void updateEntity(float dt, eid_t entity, CollisionComponent& collisionComponent, TransformComponent& transformComponent);
 };
\ No newline at end of file
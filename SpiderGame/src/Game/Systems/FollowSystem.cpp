@@ -8,8 +8,7 @@
 #include "Game/Components/RigidbodyMotorComponent.h"
 #include "Game/Components/CollisionComponent.h"
 
-#include "Game/Components/PlayerComponent.h"
-#include "Game/Components/LevelComponent.h"
+#include "Game/Extra/SceneResources.h"
 
 #include <cmath>
 #include <algorithm>
@@ -19,7 +18,8 @@ bool findPath(const Room& room, const glm::vec3& start, const glm::vec3& finalTa
 
 FollowSystem::FollowSystem(World& world, btDynamicsWorld* dynamicsWorld)
 	: System(world),
-	dynamicsWorld(dynamicsWorld)
+	dynamicsWorld(dynamicsWorld),
+	sweepShape(new btBoxShape(btVector3(0.5f, 0.1f, 0.5f)))
 {
 	require<TransformComponent>();
 	require<FollowComponent>();
@@ -34,13 +34,13 @@ void FollowSystem::updateEntity(float dt, eid_t entity)
 	RigidbodyMotorComponent* rigidbodyMotorComponent = world.getComponent<RigidbodyMotorComponent>(entity);
 	CollisionComponent* collisionComponent = world.getComponent<CollisionComponent>(entity);
 
-	std::vector<eid_t> players = world.getEntitiesWithComponent<PlayerComponent>();
+	PlayerResource* playerResource = world.resource<PlayerResource>();
 
-	if (players.size() <= 0 || !followComponent->enabled) {
+	if (playerResource == nullptr || !world.isAlive(playerResource->player) || !followComponent->enabled) {
 		return;
 	}
 
-	eid_t target = players[0];
+	eid_t target = playerResource->player;
 	followComponent->repathTimer += dt;
 
 	std::shared_ptr<Transform> finalTarget = world.getComponent<TransformComponent>(target)->data;
@@ -55,14 +55,12 @@ void FollowSystem::updateEntity(float dt, eid_t entity)
 	float distanceToTarget = (btEnd - btStart).length();
 	float distanceToHit = FLT_MAX;
 
-	btConvexShape* convexShape = new btBoxShape(btVector3(0.5f, 0.1f, 0.5f));
-
 	btQuaternion rotation = Util::glmToBt(transformComponent->data->getWorldRotation()); 
 	btTransform btTStart(rotation, btStart);
 	btTransform btTEnd(rotation, btEnd);
 	btCollisionWorld::ClosestConvexResultCallback sweepTestCallback(btStart, btEnd);
 	sweepTestCallback.m_collisionFilterMask = CollisionGroupAll ^ (CollisionGroupPlayer | CollisionGroupEnemy);
-	this->dynamicsWorld->convexSweepTest(convexShape, btTStart, btTEnd, sweepTestCallback);
+	this->dynamicsWorld->convexSweepTest(sweepShape.get(), btTStart, btTEnd, sweepTestCallback);
 	distanceToHit = (sweepTestCallback.m_hitPointWorld - btStart).length();
 
 	// Bullet reports the hit point as very far away if no contact is found
@@ -72,13 +70,12 @@ void FollowSystem::updateEntity(float dt, eid_t entity)
 	} else {
 		if (followComponent->repathTimer >= followComponent->data.repathTime) {
 			// Try pathfinding again
-			std::vector<eid_t> levelEntities = world.getEntitiesWithComponent<LevelComponent>();
-			if (levelEntities.size() <= 0) {
+			LevelResource* level = world.resource<LevelResource>();
+			if (level == nullptr) {
 				throw "%s tried to repath, but no level found" + world.getEntityName(entity);
 			}
-			LevelComponent* levelComponent = world.getComponent<LevelComponent>(levelEntities[0]);
 
-			findPath(levelComponent->data.room, from, to, followComponent->path);
+			findPath(level->room, from, to, followComponent->path);
 			followComponent->pathNode = 0;
 			followComponent->repathTimer -= followComponent->data.repathTime;
 		}
@@ -5,6 +5,8 @@
 #include <btBulletCollisionCommon.h>
 #include <btBulletDynamicsCommon.h>
 
+#include <memory>
+
 class FollowSystem : public System
 {
 public:
@@ -12,4 +14,7 @@ public:
 	void updateEntity(float dt, eid_t entity);
 private:
 	btDynamicsWorld* dynamicsWorld;
+
+	/*! Swept towards the target to check line of sight. */
+	std::unique_ptr<btBoxShape> sweepShape;
 };
\ No newline at end of file
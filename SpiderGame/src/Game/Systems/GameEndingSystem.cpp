@@ -21,9 +21,9 @@ GameEndingSystem::GameEndingSystem(World& world, EventManager& eventManager, Sou
 	require<TransformComponent>();
 	require<PlayerComponent>();
 
-	eventManager.registerForEvent<GemCountChangedEvent>(std::bind(&GameEndingSystem::onGemCountChanged, this, std::placeholders::_1));
-	eventManager.registerForEvent<GemLightOnEvent>(std::bind(&GameEndingSystem::onGemLightOn, this, std::placeholders::_1));
-	eventManager.registerForEvent<CollisionEvent>(std::bind(&GameEndingSystem::onCollision, this, std::placeholders::_1));
+	gemCountChangedSubscription = eventManager.registerForEvent<GemCountChangedEvent>([this](const GemCountChangedEvent& event) { onGemCountChanged(event); });
+	gemLightOnSubscription = eventManager.registerForEvent<GemLightOnEvent>([this](const GemLightOnEvent& event) { onGemLightOn(event); });
+	collisionSubscription = eventManager.registerForEvent<CollisionEvent>([this](const CollisionEvent& event) { onCollision(event); });
 }
 
 void GameEndingSystem::updateEntity(float dt, eid_t entity)
@@ -54,9 +54,8 @@ void GameEndingSystem::updateEntity(float dt, eid_t entity)
 		material.setProperty("color", MaterialProperty(glm::vec4(1.0f, 1.0f, 1.0f, alpha)));
 		playerComponent->data.blackoutQuad->isVisible = true;
 
-		std::vector<eid_t> gems = world.getEntitiesWithComponent<GemComponent>();
-		for (unsigned i = 0; i < gems.size(); i++) {
-			GemComponent* gemComponent = world.getComponent<GemComponent>(gems[i]);
+		for (eid_t gem : world.each<GemComponent>()) {
+			GemComponent* gemComponent = world.getComponent<GemComponent>(gem);
 			gemComponent->data.state = GemState_ShouldFree;
 		}
 	} else if (playerComponent->gameEndState == GameEndState_Blackout) {
@@ -65,9 +64,9 @@ void GameEndingSystem::updateEntity(float dt, eid_t entity)
 			playerComponent->gameEndTimer -= playerData.blackoutTime;
 
 			// Setup the camera
-			std::vector<eid_t> cameras = world.getEntitiesWithComponent<CameraComponent>();
-			assert (cameras.size() > 0);
-			CameraComponent* oldCameraComponent = world.getComponent<CameraComponent>(cameras[0]);
+			eid_t oldCamera = world.first<CameraComponent>();
+			assert (oldCamera != World::NullEntity);
+			CameraComponent* oldCameraComponent = world.getComponent<CameraComponent>(oldCamera);
 
 			eid_t endGameCamera = world.getNewEntity();
 			TransformComponent* transformComponent = world.addComponent<TransformComponent>(endGameCamera);
@@ -136,11 +135,11 @@ void GameEndingSystem::onGemCountChanged(const GemCountChangedEvent& gemCountCha
 }
 
 void GameEndingSystem::onGemLightOn(const GemLightOnEvent& gemLightOnEvent) {
-	std::vector<eid_t> gems = world.getEntitiesWithComponent<GemComponent>();
 	int lightsOn = 0;
+	size_t gemCount = world.count<GemComponent>();
 
-	for (unsigned i = 0; i < gems.size(); i++) {
-		GemComponent* gemComponent = world.getComponent<GemComponent>(gems[i]);
+	for (eid_t gem : world.each<GemComponent>()) {
+		GemComponent* gemComponent = world.getComponent<GemComponent>(gem);
 		if (gemComponent->data.lightState == GemLightState_Max) {
 			++lightsOn;
 		}
@@ -150,7 +149,7 @@ void GameEndingSystem::onGemLightOn(const GemLightOnEvent& gemLightOnEvent) {
 	assert (gameEndSoundSource != World::NullEntity);
 
 	AudioSourceComponent* audioSourceComponent = world.getComponent<AudioSourceComponent>(gameEndSoundSource);
-	soundManager.setSourceVolume(audioSourceComponent->sourceHandle, 0.25f + 0.75f / gems.size() * lightsOn);
+	soundManager.setSourceVolume(audioSourceComponent->sourceHandle, 0.25f + 0.75f / (float)gemCount * lightsOn);
 }
 
 void GameEndingSystem::onCollision(const CollisionEvent& collisionEvent)
@@ -184,14 +183,12 @@ void GameEndingSystem::onCollision(const CollisionEvent& collisionEvent)
 	AudioSourceComponent* audioSourceComponent = world.getComponent<AudioSourceComponent>(player);
 	soundManager.playClipAtSource(playerComponent->data.portalEnterClip, audioSourceComponent->sourceHandle);
 
-	std::vector<eid_t> spiders = world.getEntitiesWithComponent<SpiderComponent>();
-	for (unsigned i = 0; i < spiders.size(); i++) {
-		world.removeEntity(spiders[i]);
+	for (eid_t spider : world.each<SpiderComponent>()) {
+		world.removeEntity(spider);
 	}
 
-	std::vector<eid_t> spawners = world.getEntitiesWithComponent<SpawnerComponent>();
-	for (unsigned i = 0; i < spawners.size(); i++) {
-		world.removeEntity(spawners[i]);
+	for (eid_t spawner : world.each<SpawnerComponent>()) {
+		world.removeEntity(spawner);
 	}
 
 	eventManager.sendEvent(VictorySequenceStartedEvent());
@@ -19,6 +19,9 @@ public:
 private:
 	EventManager& eventManager;
 	SoundManager& soundManager;
+	EventSubscription gemCountChangedSubscription;
+	EventSubscription gemLightOnSubscription;
+	EventSubscription collisionSubscription;
 
 	void onGemCountChanged(const GemCountChangedEvent& gemCountChangedEvent);
 	void onGemLightOn(const GemLightOnEvent& gemLightOnEvent);
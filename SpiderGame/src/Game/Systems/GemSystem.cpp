@@ -28,7 +28,7 @@ GemSystem::GemSystem(World& world, Renderer& renderer, EventManager& eventManage
 	require<CollisionComponent>();
 	require<VelocityComponent>();
 
-	eventManager.registerForEvent<AllGemsCollectedEvent>(std::bind(&GemSystem::onAllGemsCollected, this, std::placeholders::_1));
+	allGemsCollectedSubscription = eventManager.registerForEvent<AllGemsCollectedEvent>([this](const AllGemsCollectedEvent& event) { onAllGemsCollected(event); });
 }
 
 void GemSystem::updateEntity(float dt, eid_t entity)
@@ -48,9 +48,9 @@ void GemSystem::updateEntity(float dt, eid_t entity)
 		gemComponent->data.lightState = GemLightState_Small;
 	}
 
-	std::vector<eid_t> players = world.getEntitiesWithComponent<PlayerComponent>();
-	assert(players.size());
-	PlayerComponent* playerComponent = world.getComponent<PlayerComponent>(players[0]);
+	eid_t player = world.first<PlayerComponent>();
+	assert(player != World::NullEntity);
+	PlayerComponent* playerComponent = world.getComponent<PlayerComponent>(player);
 
 	if (allGemsPlaced) {
 		TransformComponent* gemTransformComponent = world.getComponent<TransformComponent>(entity);
@@ -88,6 +88,7 @@ void GemSystem::updateEntity(float dt, eid_t entity)
 
 		glm::vec3 newPosition(sin(theta) * rad, currentGemPosition.y + heightChange, cos(theta) * rad);
 		gemTransformComponent->data->setPosition(newPosition);
+		markChanged<TransformComponent>(entity);
 
 		gemComponent->endGameTimer += dt;
 	}
@@ -116,8 +117,7 @@ void GemSystem::onAllGemsCollected(const AllGemsCollectedEvent& allGemsCollected
 {
 	this->allGemsPlaced = true;
 
-	std::vector<eid_t> gems = world.getEntitiesWithComponent<GemComponent>();
-	for (unsigned i = 0; i < gems.size(); ++i) {
-		world.removeComponent<CollisionComponent>(gems[i]);
+	for (eid_t gem : world.each<GemComponent>()) {
+		world.removeComponent<CollisionComponent>(gem);
 	}
 }
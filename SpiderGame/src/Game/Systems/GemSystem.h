@@ -14,6 +14,7 @@ public:
 private:
 	Renderer& renderer;
 	EventManager& eventManager;
+	EventSubscription allGemsCollectedSubscription;
 	bool allGemsPlaced;
 
 	void onAllGemsCollected(const AllGemsCollectedEvent& allGemsCollectedEvent);
@@ -0,0 +1,27 @@
+
+#include "KinematicBodySystem.h"
+
+#include "Util.h"
+
+KinematicBodySystem::KinematicBodySystem(World& world)
+	: TypedSystem(world)
+{
+	writes<CollisionComponent>();
+	reads<TransformComponent>();
+}
+
+void KinematicBodySystem::updateEntity(float dt, eid_t entity, CollisionComponent& collisionComponent, TransformComponent& transformComponent)
+{
+	if (collisionComponent.controlsMovement) {
+		return;
+	}
+
+	// Objects which haven't moved are left alone, so that the systems drawing them can skip them too
+	btTransform newTransform(Util::glmToBt(transformComponent.worldRotation), Util::glmToBt(transformComponent.worldPosition));
+	if (newTransform == collisionComponent.collisionObject->getWorldTransform()) {
+		skipEntity();
+		return;
+	}
+
+	collisionComponent.collisionObject->setWorldTransform(newTransform);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Framework/System.h"
+
+#include "Game/Components/CollisionComponent.h"
+#include "Game/Components/TransformComponent.h"
+
+/*! Moves kinematic bodies, whose entity controls their movement, to the entity's world
+	transform. Runs after TransformSystem, so bodies follow this frame's transforms into
+	the next physics step. Bodies which control their entity's movement are synced the
+	other way, by CollisionUpdateSystem. */
+class KinematicBodySystem : public TypedSystem<CollisionComponent, TransformComponent>
+{
+public:
+	KinematicBodySystem(World& world);
+	void updateEntity(float dt, eid_t entity, CollisionComponent& collisionComponent, TransformComponent& transformComponent);
+};
\ No newline at end of file
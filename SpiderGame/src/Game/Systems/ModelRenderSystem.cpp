@@ -1,21 +1,22 @@
 
 #include "ModelRenderSystem.h"
-#include "Game/Components/ModelRenderComponent.h"
-#include "Game/Components/TransformComponent.h"
 #include "Renderer/Renderer.h"
 
 ModelRenderSystem::ModelRenderSystem(World& world, Renderer& renderer)
-	: System(world),
+	: TypedSystem(world),
 	renderer(renderer)
 {
-	require<ModelRenderComponent>();
-	require<TransformComponent>();
+	reads<ModelRenderComponent>();
+	reads<TransformComponent>();
+	writesResource(&renderer);
 }
 
-void ModelRenderSystem::updateEntity(float dt, eid_t entity)
+void ModelRenderSystem::updateEntity(float dt, eid_t entity, ModelRenderComponent& modelComponent, TransformComponent& transformComponent)
 {
-	ModelRenderComponent* modelComponent = world.getComponent<ModelRenderComponent>(entity);
-	TransformComponent* transformComponent = world.getComponent<TransformComponent>(entity);
+	if (!changedSinceLastUpdate<ModelRenderComponent>(entity) && !changedSinceLastUpdate<TransformComponent>(entity)) {
+		skipEntity();
+		return;
+	}
 
-	renderer.setRenderableTransform(modelComponent->rendererHandle, transformComponent->data->matrix());
+	renderer.setRenderableTransform(modelComponent.rendererHandle, transformComponent.worldMatrix);
 }
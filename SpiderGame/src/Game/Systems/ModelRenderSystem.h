@@ -2,13 +2,16 @@
 
 #include "Framework/System.h"
 
+#include "Game/Components/ModelRenderComponent.h"
+#include "Game/Components/TransformComponent.h"
+
 class Renderer;
 
-class ModelRenderSystem : public System
+class ModelRenderSystem : public TypedSystem<ModelRenderComponent, TransformComponent>
 {
 public:
 	ModelRenderSystem(World& world, Renderer& renderer);
-	void updateEntity(float dt, eid_t entity);
+	void updateEntity(float dt, eid_t entity, ModelRenderComponent& modelComponent, TransformComponent& transformComponent);
 private:
 	Renderer& renderer;
 };
\ No newline at end of file
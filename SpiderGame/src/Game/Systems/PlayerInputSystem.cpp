@@ -46,6 +46,7 @@ void PlayerInputSystem::updateEntity(float dt, eid_t entity)
 	verticalRad = glm::clamp(verticalRad, -glm::half_pi<float>() + 0.01f, glm::half_pi<float>() - 0.01f);
 
 	cameraTransformComponent->data->setRotation(glm::angleAxis(verticalRad, Util::right));
+	markChanged<TransformComponent>(playerComponent->data.camera);
 
 	if (input.getButtonDown("Use", device)) {
 		this->tryActivate(entity, playerComponent);
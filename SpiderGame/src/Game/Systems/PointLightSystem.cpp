@@ -10,14 +10,23 @@ PointLightSystem::PointLightSystem(World& world, Renderer& renderer)
 {
 	require<PointLightComponent>();
 	require<TransformComponent>();
+
+	reads<PointLightComponent>();
+	reads<TransformComponent>();
+	writesResource(&renderer);
 }
 
 void PointLightSystem::updateEntity(float dt, eid_t entity)
 {
+	if (!changedSinceLastUpdate<PointLightComponent>(entity) && !changedSinceLastUpdate<TransformComponent>(entity)) {
+		skipEntity();
+		return;
+	}
+
 	PointLightComponent* pointLightComponent = world.getComponent<PointLightComponent>(entity);
 	TransformComponent* transformComponent = world.getComponent<TransformComponent>(entity);
 
 	PointLight light = renderer.getPointLight(pointLightComponent->handle);
-	light.position = transformComponent->data->getWorldPosition();
+	light.position = transformComponent->worldPosition;
 	renderer.setPointLight(pointLightComponent->handle, light);
 }
@@ -12,6 +12,10 @@ ShakeSystem::ShakeSystem(World& world, std::default_random_engine& generator)
 {
 	require<TransformComponent>();
 	require<ShakeComponent>();
+
+	reads<TransformComponent>();
+	writes<ShakeComponent>();
+	writesResource(&generator);
 }
 
 void ShakeSystem::updateEntity(float dt, eid_t entity)
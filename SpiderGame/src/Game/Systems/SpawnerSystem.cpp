@@ -36,15 +36,15 @@ void SpawnerSystem::updateEntity(float dt, eid_t entity)
 	if (component->spawnTimer >= currentSpawnTime) {
 		bool spawned = false;
 
-		if (world.getEntitiesWithComponent<SpiderComponent>().size() >= maxSpiders) {
+		if (world.count<SpiderComponent>() >= maxSpiders) {
 			return;
 		}
 
-		std::vector<eid_t> players = world.getEntitiesWithComponent<PlayerComponent>();
-		assert(players.size() >= 0);
+		eid_t player = world.first<PlayerComponent>();
+		assert(player != World::NullEntity);
 
-		PlayerComponent* playerComponent = world.getComponent<PlayerComponent>(players[0]);
-		TransformComponent* playerTransformComponent = world.getComponent<TransformComponent>(players[0]);
+		PlayerComponent* playerComponent = world.getComponent<PlayerComponent>(player);
+		TransformComponent* playerTransformComponent = world.getComponent<TransformComponent>(player);
 		CameraComponent* cameraComponent = world.getComponent<CameraComponent>(playerComponent->data.camera);
 
 		std::uniform_int_distribution<int> positionRand(0, component->data.candidatePositions.size()-1);
@@ -44,7 +44,7 @@ SpiderSystem::SpiderSystem(World& world, EventManager& eventManager, btDynamicsW
 	require<AudioSourceComponent>();
 	require<SpiderComponent>();
 
-	eventManager.registerForEvent<CollisionEvent>(std::bind(&SpiderSystem::onSpiderCollided, this, std::placeholders::_1));
+	collisionSubscription = eventManager.registerForEvent<CollisionEvent>([this](const CollisionEvent& event) { onSpiderCollided(event); });
 }
 
 void SpiderSystem::updateEntity(float dt, eid_t entity)
@@ -64,11 +64,10 @@ void SpiderSystem::updateEntity(float dt, eid_t entity)
 	btVector3 velocity = spiderBody->getLinearVelocity();
 	SpiderState newState = spiderComponent->animState;
 
-	std::vector<eid_t> players = world.getEntitiesWithComponent<PlayerComponent>();
+	eid_t target = world.first<PlayerComponent>();
 	std::shared_ptr<Transform> targetTransform;
 	glm::vec3 targetVelocity;
-	if (players.size() > 0) {
-		eid_t target = players[0];
+	if (target != World::NullEntity) {
 		targetTransform = world.getComponent<TransformComponent>(target)->data;
 
 		CollisionComponent* targetCollisionComponent = world.getComponent<CollisionComponent>(target);
@@ -125,7 +124,7 @@ void SpiderSystem::updateEntity(float dt, eid_t entity)
 			glm::vec3 hurtboxOffset(glm::vec3(0.0f, (aabbMax.y() - aabbMin.y()) / 2.0f, aabbMax.z() + hurtboxHalfExtents.z) * (1.0f / transformComponent->data->getScale()));
 			Transform hurtboxTransform(hurtboxOffset);
 
-			spiderComponent->hurtbox = this->createHurtbox(hurtboxTransform, hurtboxHalfExtents, transformComponent->data);
+			spiderComponent->hurtbox = this->createHurtbox(hurtboxTransform, hurtboxHalfExtents, entity);
 			spiderComponent->soundTimer = spiderComponent->soundTime;
 			spiderComponent->timer = 0.0f;
 		}
@@ -151,7 +150,7 @@ void SpiderSystem::updateEntity(float dt, eid_t entity)
 	if (healthComponent->data.health <= 0) {
 		newState = SPIDER_DEAD;
 		
-		if (spiderComponent->hurtbox != World::NullEntity) {
+		if (world.isAlive(spiderComponent->hurtbox)) {
 			world.removeEntity(spiderComponent->hurtbox);
 		}
 	}
@@ -213,7 +212,7 @@ void SpiderSystem::updateEntity(float dt, eid_t entity)
 	}
 }
 
-eid_t SpiderSystem::createHurtbox(const Transform& transform, const glm::vec3& halfExtents, const std::shared_ptr<Transform>& spiderTransform)
+eid_t SpiderSystem::createHurtbox(const Transform& transform, const glm::vec3& halfExtents, eid_t spider)
 {
 	eid_t hurtboxEntity = world.getNewEntity("Hurtbox");
 	TransformComponent* transformComponent = world.addComponent<TransformComponent>(hurtboxEntity);
@@ -235,7 +234,9 @@ eid_t SpiderSystem::createHurtbox(const Transform& transform, const glm::vec3& h
 	transformComponent->data->setPosition(transform.getPosition());
 	transformComponent->data->setRotation(transform.getRotation());
 	transformComponent->data->setScale(transform.getScale());
-	transformComponent->data->setParent(spiderTransform);
+	transformComponent->data->setParent(world.getComponent<TransformComponent>(spider)->data);
+	transformComponent->parent = spider;
+	transformComponent->resetWorldTransform();
 
 	if (debugShader.isValid()) {
 		ModelRenderComponent* modelComponent = world.addComponent<ModelRenderComponent>(hurtboxEntity);
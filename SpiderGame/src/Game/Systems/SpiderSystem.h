@@ -2,6 +2,7 @@
 
 #include "Framework/System.h"
 #include "Framework/CollisionEvent.h"
+#include "Framework/EventManager.h"
 #include "Renderer/ShaderLoader.h"
 
 #include <glm/glm.hpp>
@@ -21,11 +22,12 @@ public:
 
 	Shader debugShader;
 private:
-	eid_t createHurtbox(const Transform& transform, const glm::vec3& halfExtents, const std::shared_ptr<Transform>& spiderTransform);
+	eid_t createHurtbox(const Transform& transform, const glm::vec3& halfExtents, eid_t spider);
 	void onSpiderCollided(const CollisionEvent& collisionEvent);
 
 	Renderer& renderer;
 	EventManager& eventManager;
+	EventSubscription collisionSubscription;
 	SoundManager& soundManager;
 	btDynamicsWorld* dynamicsWorld;
 	std::default_random_engine& generator;
@@ -0,0 +1,174 @@
+#include "TransformSystem.h"
+
+#include "Math/ComposeTRS.h"
+
+#include <algorithm>
+
+TransformSystem::TransformSystem(World& world)
+	: System(world)
+{
+	require<TransformComponent>();
+	writes<TransformComponent>();
+}
+
+void TransformSystem::update(float dt)
+{
+	beginUpdate();
+
+	Span<const eid_t> owners = world.each<TransformComponent>();
+	if (owners.size() != sortedOwners.size() || !std::equal(owners.begin(), owners.end(), sortedOwners.begin())) {
+		rebuild(owners);
+	}
+
+	size_t skipped = 0;
+	while (!propagate(skipped)) {
+		rebuild(owners);
+		skipped = 0;
+	}
+	skipEntities(skipped);
+}
+
+bool TransformSystem::propagate(size_t& skipped)
+{
+	// Find everything which needs recomputing first, so that all of their local
+	// matrices can be composed in one batch
+	dirtyNodes.clear();
+	localPositions.clear();
+	localRotations.clear();
+	localScales.clear();
+	for (size_t i = 0; i < nodes.size(); i++) {
+		Node& node = nodes[i];
+		TransformComponent& component = *node.component;
+
+		bool moved = changedSinceLastUpdate<TransformComponent>(node.entity);
+		if (moved && component.parent != node.parent) {
+			return false;
+		}
+
+		changed[i] = (moved || (node.parentIndex >= 0 && changed[node.parentIndex]));
+		if (!changed[i]) {
+			skipped++;
+			continue;
+		}
+
+		const Transform& local = *component.data;
+		dirtyNodes.push_back((uint32_t)i);
+		localPositions.push_back(local.getPosition());
+		localRotations.push_back(local.getRotation());
+		localScales.push_back(local.getScale());
+	}
+
+	localMatrices.resize(dirtyNodes.size());
+	composeTRS(localPositions.data(), localRotations.data(), localScales.data(), localMatrices.data(), dirtyNodes.size());
+
+	// dirtyNodes is in node order, so parents are still finished before their children.
+	// The same composition as Transform's getWorld functions and matrix()
+	for (size_t j = 0; j < dirtyNodes.size(); j++) {
+		Node& node = nodes[dirtyNodes[j]];
+		TransformComponent& component = *node.component;
+		if (node.parentIndex < 0) {
+			component.worldMatrix = localMatrices[j];
+			component.worldPosition = localPositions[j];
+			component.worldRotation = localRotations[j];
+			component.worldScale = localScales[j];
+		} else {
+			const TransformComponent& parent = *nodes[node.parentIndex].component;
+			component.worldMatrix = parent.worldMatrix * localMatrices[j];
+			component.worldPosition = parent.worldPosition + parent.worldRotation * (parent.worldScale * localPositions[j]);
+			component.worldRotation = parent.worldRotation * localRotations[j];
+			component.worldScale = parent.worldScale * localScales[j];
+		}
+		markChanged<TransformComponent>(node.entity);
+	}
+	return true;
+}
+
+void TransformSystem::rebuild(Span<const eid_t> owners)
+{
+	size_t count = owners.size();
+	sortedOwners.assign(owners.begin(), owners.end());
+
+	uint32_t slotCount = 0;
+	for (eid_t owner : owners) {
+		slotCount = std::max(slotCount, entityIndex(owner) + 1);
+	}
+	slotOwners.assign(slotCount, -1);
+	for (size_t i = 0; i < count; i++) {
+		slotOwners[entityIndex(owners[i])] = (int32_t)i;
+	}
+
+	// Find each transform's parent within the pool. Transforms whose parent has gone
+	// become roots, the same as a Transform whose parent pointer has expired
+	ownerComponents.resize(count);
+	parentOwners.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		TransformComponent* component = world.getComponent<TransformComponent>(owners[i]);
+		ownerComponents[i] = component;
+		parentOwners[i] = -1;
+
+		eid_t parent = component->parent;
+		if (parent == World::NullEntity) {
+			continue;
+		}
+
+		uint32_t slot = entityIndex(parent);
+		if (slot < slotCount && slotOwners[slot] >= 0 && owners[slotOwners[slot]] == parent) {
+			parentOwners[i] = slotOwners[slot];
+		} else {
+			component->parent = World::NullEntity;
+			world.markChanged<TransformComponent>(owners[i]);
+		}
+	}
+
+	// Depth in the hierarchy, filling in whole chains of ancestors at a time
+	depths.assign(count, -1);
+	int32_t maxDepth = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (depths[i] >= 0) {
+			continue;
+		}
+
+		int32_t unknownAncestors = 0;
+		int32_t ancestor = parentOwners[i];
+		while (ancestor >= 0 && depths[ancestor] < 0 && unknownAncestors <= (int32_t)count) {
+			unknownAncestors++;
+			ancestor = parentOwners[ancestor];
+		}
+		if (unknownAncestors > (int32_t)count) {
+			// A cycle, which can only come from reparenting gone wrong. Break it here
+			parentOwners[i] = -1;
+			ancestor = -1;
+			unknownAncestors = 0;
+		}
+
+		int32_t depth = (ancestor >= 0 ? depths[ancestor] + 1 : 0) + unknownAncestors;
+		maxDepth = std::max(maxDepth, depth);
+		for (int32_t j = (int32_t)i; j >= 0 && depths[j] < 0; j = parentOwners[j]) {
+			depths[j] = depth--;
+		}
+	}
+
+	// Counting sort by depth, keeping pool order within each depth so the pass stays
+	// close to the order components sit in memory
+	depthOffsets.assign(maxDepth + 2, 0);
+	for (size_t i = 0; i < count; i++) {
+		depthOffsets[depths[i] + 1]++;
+	}
+	for (int32_t depth = 0; depth <= maxDepth; depth++) {
+		depthOffsets[depth + 1] += depthOffsets[depth];
+	}
+	ownerNodes.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		ownerNodes[i] = (int32_t)depthOffsets[depths[i]]++;
+	}
+
+	nodes.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		Node& node = nodes[ownerNodes[i]];
+		node.component = ownerComponents[i];
+		node.entity = owners[i];
+		node.parent = ownerComponents[i]->parent;
+		node.parentIndex = (parentOwners[i] >= 0 ? ownerNodes[parentOwners[i]] : -1);
+	}
+	changed.assign(count, 0);
+}
\ No newline at end of file
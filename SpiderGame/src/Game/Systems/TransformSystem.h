@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Framework/System.h"
+
+#include "Game/Components/TransformComponent.h"
+
+#include <vector>
+
+/*! Computes the world transforms of every entity with a TransformComponent, storing them
+	in the component. The hierarchy is kept as a flat array sorted so that parents come
+	before their children, so one pass in order updates everything, and only transforms
+	which were marked as changed, or have a changed parent, are recomputed. Recomputed
+	transforms are marked as changed in turn, so later systems can skip the rest. */
+class TransformSystem : public System
+{
+public:
+	TransformSystem(World& world);
+
+	virtual void update(float dt);
+
+	/*! Transforms are all updated at once in update. */
+	virtual void updateEntity(float dt, eid_t entity) { }
+private:
+	struct Node {
+		TransformComponent* component;
+		eid_t entity;
+		/*! The parent at the time the hierarchy was sorted, to notice reparenting. */
+		eid_t parent;
+		/*! Index of the parent's node, or -1 if the entity has no parent with a transform. */
+		int32_t parentIndex;
+	};
+
+	/*!
+	 * \brief Recomputes world transforms in one pass over the sorted nodes.
+	 * \param skipped Incremented for each transform which didn't need recomputing.
+	 * \return False, before changing anything, if a transform was reparented.
+	 */
+	bool propagate(size_t& skipped);
+
+	/*! Re-sorts the nodes after transforms are added, removed or reparented. */
+	void rebuild(Span<const eid_t> owners);
+
+	/*! Parents always come before their children. */
+	std::vector<Node> nodes;
+
+	/*! Whether each node's world transform changed this update, indexed like nodes. */
+	std::vector<uint8_t> changed;
+
+	/*! Scratch space for propagate: the nodes being recomputed, in order, and their local transforms. */
+	std::vector<uint32_t> dirtyNodes;
+	std::vector<glm::vec3> localPositions;
+	std::vector<glm::quat> localRotations;
+	std::vector<glm::vec3> localScales;
+	std::vector<glm::mat4> localMatrices;
+
+	/*! The pool's entities at the last rebuild. The pool only reorders them when
+		components are added or removed, which is when the nodes need sorting again. */
+	std::vector<eid_t> sortedOwners;
+
+	/*! Scratch space for rebuild, indexed by position in the pool. */
+	std::vector<TransformComponent*> ownerComponents;
+	std::vector<int32_t> parentOwners;
+	std::vector<int32_t> depths;
+	std::vector<int32_t> ownerNodes;
+	std::vector<size_t> depthOffsets;
+	/*! Indexed by entityIndex. */
+	std::vector<int32_t> slotOwners;
+};
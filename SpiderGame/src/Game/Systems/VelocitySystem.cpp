@@ -22,5 +22,6 @@ void VelocitySystem::updateEntity(float dt, eid_t entity)
 	std::shared_ptr<Transform> transform = transformComponent->data;
 	transform->setPosition(transform->getPosition() + transform->getForward() * velocityComponent->data.speed * dt);
 	transform->setRotation(transform->getRotation() * glm::angleAxis(velocityComponent->data.angularSpeed * dt, velocityComponent->data.rotationAxis));
+	markChanged<TransformComponent>(entity);
 
 }
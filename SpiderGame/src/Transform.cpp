@@ -2,6 +2,8 @@
 #include "Transform.h"
 #include "Util.h"
 
+#include "Math/ComposeTRS.h"
+
 const Transform Transform::identity = Transform();
 const std::shared_ptr<Transform> Transform::identityPtr(new Transform());
 const glm::mat4 Transform::identityMat4 = glm::mat4();
@@ -112,32 +114,25 @@ glm::mat4 Transform::matrix() const
 }
 
 glm::mat4 Transform::matrix()
+{
+	return this->getParentMat4() * this->localMatrix();
+}
+
+glm::mat4 Transform::localMatrix()
 {
 	if (this->dirty) {
 		this->cacheMatrix = toMat4();
 		this->dirty = false;
 	}
-	
-	return this->getParentMat4() * this->cacheMatrix;
+
+	return this->cacheMatrix;
 }
 
 glm::mat4 Transform::toMat4() const
 {
-	glm::mat4 posMatrix = glm::mat4(
-		1.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 1.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 1.0f, 0.0f,
-		position.x, position.y, position.z, 1.0f
-		);
-	glm::mat4 rotMatrix(glm::toMat4(rotation));
-	glm::mat4 scaleMatrix = glm::mat4(
-		scale.x, 0.0f, 0.0f, 0.0f,
-		0.0f, scale.y, 0.0f, 0.0f,
-		0.0f, 0.0f, scale.z, 0.0f,
-		0.0f, 0.0f, 0.0f, 1.0f
-		);
-
-	return posMatrix * rotMatrix * scaleMatrix;
+	glm::mat4 result;
+	composeTRS(&position, &rotation, &scale, &result, 1);
+	return result;
 }
 
 bool Transform::hasParent() const
@@ -35,6 +35,11 @@ public:
 	glm::mat4 matrix() const;
 	glm::mat4 matrix();
 
+	/*!
+	 * \brief Returns the matrix of this transform alone, without its parents.
+	 */
+	glm::mat4 localMatrix();
+
 	void setParent(const std::shared_ptr<Transform>& parent);
 
 	void* userData;